@@ -93,6 +93,7 @@ typedef enum
   ,USBH_CDC_CONTINUE_SEND_DATA
   ,USBH_CDC_WAIT_SEND
   ,USBH_CDC_FINISH 
+  ,USBH_MDM_SWITCH
 }
 MSCState;
 
@@ -92,6 +92,62 @@ typedef struct _CDC_Process
 }
 CDC_Machine_TypeDef; 
 
+#define		USBH_CDC_MAX_DEV	2		//     OTG (FS, HS);    
+#define		USBH_CDC_IN_BUFF	512		//  HS;  - 
+#define		USBH_CDC_DROP_ALL	0xFFFFFFFF	// TxDrop:  
+#define		USBH_CDC_TX_NAK_MS	2000	//     (NAK)  -  
+
+/*   : Ctx -   (TUsartGSM) */
+typedef struct _USBH_CDC_Cb
+{
+  int			(*ListenData)(void* Ctx,void* Data,int Len)	;//   ()
+  char*			(*GetRxBuff) (void* Ctx,int* Len)			;//  ,  
+  int			(*CommitRx)  (void* Ctx,int Len)			;//     Len ,   
+  void			(*MdmInit)   (void* Ctx)					;//   
+  char*			(*GetTxBuff) (void* Ctx,int* Len)			;//   :  
+  void			(*CommitTx)  (void* Ctx,int Len)			;//    Len 
+  void			(*MdmLost)   (void* Ctx)					;//     (  )
+  int			(*GetTxLen)  (void* Ctx)					;//     ;  - DropTx  
+}
+USBH_CDC_Cb_TypeDef;
+
+/*    : , ,  ,  .
+      OTG (USBH_CDC_Bind),     pdev. */
+typedef struct _USBH_CDC_Dev
+{
+  USB_OTG_CORE_HANDLE*	pdev				;
+  uint8_t				Active				;//  CDC 
+  uint8_t				hc_num_in			;
+  uint8_t				hc_num_out			;
+  uint8_t				InEp				;
+  uint8_t				OutEp				;
+  uint16_t				InEpSize			;
+  uint16_t				OutEpSize			;
+  uint8_t				State				;// USBH_CDC_INIT/GET_DATA
+  volatile uint8_t		TxBusy				;//  pTx   OUT,  USBH_CDC_OnURB
+  uint8_t				TxZlp				;//   :    0 
+  uint32_t				TxDrop				;//      ,   OUT 
+  uint8_t*				pTx					;// :    OUT (  Cb->GetTxBuff)
+  uint32_t				TxCur				;
+  uint16_t				TxNakFr				;//   NAK   
+  uint8_t				TxNak				;//    NAK
+  uint32_t				CntTxDrop			;//  :  , NAK  USBH_CDC_TX_NAK_MS
+  uint8_t*				pRx					;//    IN, 0 -  
+  uint16_t				InLen[2]			;//   InBuff[ix]     , 0 - 
+  uint16_t				InOff				;//   InBuff[InHead]  
+  uint8_t				InHead				;//  InBuff  
+  uint8_t				InFill				;//  InBuff  ( pRx  )
+  volatile uint8_t		RxPark				;// InBuff    :  GetS   USBH_CDC_Handle
+  const void*			Mdm					;//   , TMdmRec ( ModeSwitch)
+  uint8_t				SwStep				;// : 1 - , 2 -  
+  uint16_t				SwFrame				;//  USB   
+  uint32_t				SwFr				;//    
+  char					InBuff[2][USBH_CDC_IN_BUFF]	;//  OTG   ,   
+  const USBH_CDC_Cb_TypeDef*	Cb			;
+  void*					Ctx					;
+}
+USBH_CDC_Dev;
+
 
 /**
   * @}
@@ -134,9 +190,11 @@ extern MSC_Machine_TypeDef    CDC_Machine;
 extern uint8_t CDCErrorCount;
 
 
-extern		USBH_Status		USBH_CDC_WriteBuff		(void* Data,int Len)		;
-extern		int				(*cbUSBH_CDC_ListenData)(void* Data,int Len)		;
-extern		void			(*cbUSBH_CDC_MDM_Init)	(void)						;
+extern		int				USBH_CDC_Bind			(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE* pdev,const USBH_CDC_Cb_TypeDef* cb,void* ctx)	;
+extern		USBH_Status		USBH_CDC_StartTx		(void* dev)	;//   Cb->GetTxBuff  ; dev - USBH_CDC_Dev*
+extern		USBH_Status		USBH_CDC_DropTx			(void* dev)	;//  ,    
+extern		int				USBH_CDC_Pending		(USB_OTG_CORE_HANDLE* pdev)	;//    
+extern		int				USBH_CDC_RxParked		(void* dev)	;//      ( ):  USBH_Process
 #ifdef __cplusplus
 }
 #endif
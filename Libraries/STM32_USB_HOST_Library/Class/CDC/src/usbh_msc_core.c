@@ -47,13 +47,16 @@
 #include "usbh_ioreq.h"
 #include "usbh_core.h"
 #include	"Log.h"
+#include	"Trace.h"
+#include	"MdmDb.h"
 //------------------------------------------------------------------------
 #define USBH_MSC_ERROR_RETRY_LIMIT 10
+#define		MDM_SWITCH_TIMEOUT	1000	//     
 //------------------------------------------------------------------------
 USB_Setup_TypeDef     	MSC_Setup				;
 uint8_t 				MSCErrorCount = 0		;
-USBH_BOTXfer_TypeDef	USBH_CDC_BOTXferParam	;
 MSC_Machine_TypeDef    	MSC_Machine				;
+static	USBH_CDC_Dev*	CdcDev[USBH_CDC_MAX_DEV]	;//  ,   OTG
 //------------------------------------------------------------------------
 static 	USBH_Status		USBH_MSC_InterfaceInit  (USB_OTG_CORE_HANDLE *pdev,void *phost);
 static 	void 			USBH_MSC_InterfaceDeInit(USB_OTG_CORE_HANDLE *pdev,void *phost);
@@ -63,11 +66,11 @@ static 	USBH_Status	 	USBH_MSC_BOTReset		(USB_OTG_CORE_HANDLE *pdev,USBH_HOST *p
 static 	USBH_Status	 	USBH_MSC_GETMaxLUN		(USB_OTG_CORE_HANDLE *pdev,USBH_HOST *phost);
 		void 			USBH_MSC_ErrorHandle	(uint8_t status);
 							   
-		USBH_Status		MY_ModeSwitch			(USB_OTG_CORE_HANDLE *pdev,void *phost);
-		USBH_Status		USBH_MY_InterfaceInit	(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t InterfaceClass,uint8_t InterfaceProtocol,short Intf);
-		USBH_Status		USBH_CDC_WriteBuff		(void* Data,int Len)		;
-		int				(*cbUSBH_CDC_ListenData)(void* Data,int Len) = 0	;
-		void			(*cbUSBH_CDC_MDM_Init)	(void)				 = 0	;
+static	int				MY_ModeSwitch			(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev,USBH_HOST *phost);
+static	USBH_Status		MY_ModeSwitchWait		(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev);
+static	void			MY_SwitchToMsc			(USBH_CDC_Dev* dev);
+static	void			USBH_CDC_OnURB			(void* ctx,uint8_t hc_num,URB_STATE state);
+		USBH_Status		USBH_MY_InterfaceInit	(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t InterfaceClass,uint8_t InterfaceProtocol,short Intf,USBH_CDC_Dev* dev);
 //------------------------------------------------------------------------
 USBH_Class_cb_TypeDef  USBH_MSC_cb = 
 {
@@ -83,26 +86,24 @@ USBH_Class_cb_TypeDef  USBH_MSC_cb =
 #define		CDC_PROTOCOL2	0x63
 #define		CDC_PROTOCOL3	0x62
 //------------------------------------------------------------------------
-//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-char		strMsg_HUAWEI_E171[] = "55534243123456780000000000000011062000000100000000000000000000";// MAGIC!!!!
-char		strMsg_ZTE_MF112[]   = "5553424392020000000000000000061B000000020000000000000000000000";
-//char		strMsg_ZTE_MF112[]   = "5553424312345678000000000000061e000000000000000000000000000000";
-uint8_t		buffMsg[100]			;
-
-typedef struct{
- uint16_t		Vid,Pid	;
- char*			strModeSwitch	;
- uint8_t		Class,Proto		; 
- short			Intf			;//  
-}TDeviceUsbMdm;
-
-TDeviceUsbMdm		TableUsbMdm[]={
-   {0x12D1,0x155B,strMsg_HUAWEI_E171,0xFF,0x62,-1}
-  ,{0x19D2,0x2000,strMsg_ZTE_MF112  ,0xFF,0xFF, 1}
-};
+// ,     OTG, 0 -  (  MSC)
+static	USBH_CDC_Dev*	CdcFind(USB_OTG_CORE_HANDLE *pdev)
+{int	ix	;
 
-static	TDeviceUsbMdm*		DeviceUsbMdm = 0	;
-#define	SIZE_TBL_USB_MDM	(sizeof(TableUsbMdm)/sizeof(*TableUsbMdm))
+ for(ix=0;ix<USBH_CDC_MAX_DEV;ix++) if(CdcDev[ix] && CdcDev[ix]->pdev == pdev) return CdcDev[ix]	;
+ return 0	;}
+//------------------------------------------------
+//   -  USBH_CDC_Dev    OTG.   USBH_Init.
+int		USBH_CDC_Bind(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE* pdev,const USBH_CDC_Cb_TypeDef* cb,void* ctx)
+{int	ix	;
+
+ if(!dev || CdcFind(pdev)) return 0	;
+ for(ix=0;ix<USBH_CDC_MAX_DEV;ix++) if(!CdcDev[ix]){
+   memset(dev,0,sizeof(*dev))	;
+   dev->pdev = pdev	; dev->Cb = cb	; dev->Ctx = ctx	;
+   CdcDev[ix] = dev	;
+   return 1	;}
+ return 0	;}
 //------------------------------------------------
 /**
   * @brief  USBH_MSC_InterfaceInit 
@@ -115,20 +116,28 @@ static USBH_Status USBH_MSC_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost)
 {	 
   USBH_HOST *pphost = phost;
   USBH_Status	Status = USBH_FAIL	;
+  USBH_CDC_Dev*	dev = CdcFind(pdev)	;
+  const TMdmRec*	mdm = 0			;
+  USBH_CDC_Dev*	sw  = 0			;// ,    :  
   
-  if(Status != USBH_OK && DeviceUsbMdm){
-    Status = USBH_MY_InterfaceInit(pdev,phost,DeviceUsbMdm->Class,DeviceUsbMdm->Proto,DeviceUsbMdm->Intf)	;
-	if(Status == USBH_OK) MSC_Machine.isCDC = 1							;}
+  if(dev){ mdm = MdmDbFind(pphost->device_prop.Dev_Desc.idVendor,pphost->device_prop.Dev_Desc.idProduct)	;
+    if(mdm && mdm->MsgLen) sw = dev	;
+    if(!mdm || mdm->MsgLen) mdm = (const TMdmRec*)dev->Mdm	;}//   -    
+  
+  if(Status != USBH_OK && mdm){
+    Status = USBH_MY_InterfaceInit(pdev,phost,mdm->Class,mdm->Proto,mdm->Intf,dev)	;
+	if(Status == USBH_OK){ dev->Active = 1	;
+	  HCD_SetURBCallback(pdev,dev->hc_num_in ,USBH_CDC_OnURB,dev)	;//    
+	  HCD_SetURBCallback(pdev,dev->hc_num_out,USBH_CDC_OnURB,dev)	;}}
 	
-  if(Status != USBH_OK){
-    Status = USBH_MY_InterfaceInit(pdev,phost,MSC_CLASS,MSC_PROTOCOL,-1)	;
-	if(Status == USBH_OK) MSC_Machine.isCDC = 0							;}
+  if(Status != USBH_OK) Status = USBH_MY_InterfaceInit(pdev,phost,MSC_CLASS,MSC_PROTOCOL,-1,sw)	;
   
-  if(Status != USBH_OK){ pphost->usr_cb->DeviceNotSupported()			;}
-  return USBH_OK ;
+  return Status ;//   -      DeviceNotSupported
 }
 //------------------------------------------------------------------------------------
-USBH_Status	USBH_MY_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t InterfaceClass,uint8_t InterfaceProtocol,short Intf)
+//  BULK :  dev (    ),
+//  dev -  MSC_Machine,  .
+USBH_Status	USBH_MY_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t InterfaceClass,uint8_t InterfaceProtocol,short Intf,USBH_CDC_Dev* dev)
 {
   USBH_Status	Status = USBH_FAIL			;
   USBH_HOST 	*pphost = phost				;
@@ -154,8 +163,16 @@ USBH_Status	USBH_MY_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t
 	if(ep_in && ep_out) break	;	  
   }
   
-  if(ep_in && ep_out){
-    MSC_Machine.isCDC = 1	;
+  if(ep_in && ep_out && dev){
+    dev->InEp      = ep_in ->bEndpointAddress	; dev->InEpSize  = ep_in ->wMaxPacketSize	;
+    dev->OutEp     = ep_out->bEndpointAddress	; dev->OutEpSize = ep_out->wMaxPacketSize	;
+    dev->hc_num_out = USBH_Alloc_Channel(pdev,dev->OutEp)	;
+    dev->hc_num_in  = USBH_Alloc_Channel(pdev,dev->InEp)	;
+    USBH_Open_Channel(pdev,dev->hc_num_out,pphost->device_prop.address,pphost->device_prop.speed,EP_TYPE_BULK,dev->OutEpSize)	;
+    USBH_Open_Channel(pdev,dev->hc_num_in ,pphost->device_prop.address,pphost->device_prop.speed,EP_TYPE_BULK,dev->InEpSize )	;
+    Status = USBH_OK	;
+  }
+  else if(ep_in && ep_out){
     MSC_Machine.MSBulkInEp      = ep_in ->bEndpointAddress		;
     MSC_Machine.MSBulkInEpSize  = ep_in ->wMaxPacketSize		;
     MSC_Machine.MSBulkOutEp     = ep_out->bEndpointAddress		;
@@ -179,9 +196,8 @@ USBH_Status	USBH_MY_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t
                         EP_TYPE_BULK,
                         MSC_Machine.MSBulkInEpSize)		;
     Status = USBH_OK	;
-	
-	Log.d("InterfaceInit\n   EpIn=0x%02X, EpOut=0x%02X\n",ep_in->bEndpointAddress,ep_out->bEndpointAddress);
-  }  
+  }
+  if(Status == USBH_OK) TRACE2("InterfaceInit EpIn=0x%02X, EpOut=0x%02X\n",ep_in->bEndpointAddress,ep_out->bEndpointAddress);
   return Status ; 
 }
 //------------------------------------------------------------------------------------
@@ -197,6 +213,18 @@ USBH_Status	USBH_MY_InterfaceInit(USB_OTG_CORE_HANDLE *pdev,void *phost,uint8_t
 void USBH_MSC_InterfaceDeInit ( USB_OTG_CORE_HANDLE *pdev,
                                 void *phost)
 {	
+  USBH_CDC_Dev*	dev = CdcFind(pdev)	;
+
+  if(dev){														 //    
+    HCD_SetURBCallback(pdev,dev->hc_num_in ,0,0)	; HCD_SetURBCallback(pdev,dev->hc_num_out,0,0)	;
+    if(dev->hc_num_out){ USB_OTG_HC_Halt(pdev,dev->hc_num_out)	; USBH_Free_Channel(pdev,dev->hc_num_out)	;}
+    if(dev->hc_num_in ){ USB_OTG_HC_Halt(pdev,dev->hc_num_in )	; USBH_Free_Channel(pdev,dev->hc_num_in )	;}
+    dev->hc_num_out = dev->hc_num_in = 0	; dev->SwStep = 0	;}
+  if(dev && dev->Active){
+    dev->Active = 0	; dev->pRx = 0	; dev->pTx = 0	; dev->TxBusy = 0	;
+    dev->InLen[0] = dev->InLen[1] = 0	; dev->InOff = 0	; dev->InHead = 0	;
+    if(dev->Cb->MdmLost) dev->Cb->MdmLost(dev->Ctx)	;}
+
   if ( MSC_Machine.hc_num_out)
   {
     USB_OTG_HC_Halt(pdev, MSC_Machine.hc_num_out);
@@ -223,81 +251,163 @@ void USBH_MSC_InterfaceDeInit ( USB_OTG_CORE_HANDLE *pdev,
 static USBH_Status USBH_MSC_ClassRequest(USB_OTG_CORE_HANDLE *pdev ,void *phost)
 {   
   USBH_Status status = USBH_OK ;
+  USBH_CDC_Dev*	dev = CdcFind(pdev)	;
   USBH_MSC_BOTXferParam.MSCState = USBH_MSC_BOT_INIT_STATE	;
-  USBH_CDC_BOTXferParam.MSCState = USBH_CDC_INIT			;
+  if(dev) dev->State = USBH_CDC_INIT						;
   
   return status; 
 }
 
 //-------------------------------------------------------------------------------
-static	char	InBuff[200]	;
-//static	char	OutBuff[] = "ATi\r\n"	;
+//    :    ,   
+//        InBuff    (!),
+//     InBuff. 0 -      ,
+//    (  NAK).
+static	uint8_t*	USBH_CDC_RxBuff(USBH_CDC_Dev* dev)
+{int		Len = 0	;
+ uint8_t	ix  = dev->InHead ^ (dev->InLen[dev->InHead] ? 1 : 0)	;
+ uint8_t*	Buf	;
+
+ if(dev->InLen[ix]) return 0	;
+ if(!dev->InLen[dev->InHead] && dev->Cb->GetRxBuff){
+   Buf = (uint8_t*)dev->Cb->GetRxBuff(dev->Ctx,&Len)	;
+   if(Buf && Len >= dev->InEpSize) return Buf	;}
+ dev->InFill = ix	;
+ return (uint8_t*)dev->InBuff[ix]	;}
+//-------------------------------------------------------------------------------
+//    InBuff   ,    .
+//    ,   (  ): 
+//   InBuff  GetS,    .  - RxPark:
+// ,  ,  USBH_Process (USBH_CDC_RxParked).
+//   OTG    : InBuff  .
+static	void	USBH_CDC_RxFlush(USBH_CDC_Dev* dev)
+{const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+ uint8_t	ix	;
+ int		Len, n	;
+ char*		Buf	;
+
+ while(dev->InLen[ix = dev->InHead]){
+   if(cb->GetRxBuff){
+     Buf = cb->GetRxBuff(dev->Ctx,&Len)					;
+     if(!Buf || Len <= 0){ dev->RxPark = 1	; return	;}//   -  GetS
+     if(Len > dev->InLen[ix] - dev->InOff) Len = dev->InLen[ix] - dev->InOff	;
+     memcpy(Buf,dev->InBuff[ix] + dev->InOff,Len)		;
+     n = cb->CommitRx ? cb->CommitRx(dev->Ctx,Len) : Len	;
+     dev->InOff += n										;
+     if(n < Len){ dev->RxPark = 1	; return	;}//     -  GetS
+     if(dev->InOff < dev->InLen[ix]) continue				;//    -  
+   }
+   else if(cb->ListenData) cb->ListenData(dev->Ctx,dev->InBuff[ix],dev->InLen[ix])	;
+   dev->InLen[ix] = 0	; dev->InOff = 0	; dev->InHead ^= 1	;
+ }
+}
+//-------------------------------------------------------------------------------
+//     :  OutEpSize    ,
+//  (CommitTx)  URB_DONE. ,   ,
+//     -    .
+//   (TxDrop)   ,      
+// DropTx;   ( AT)  .
+//   OTG    .
+static	void	USBH_CDC_TxNext(USBH_CDC_Dev* dev)
+{const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+ int		Len = 0	;
+ char*		Buf		;
+
+ if(dev->TxDrop){
+   while(dev->TxDrop && cb->GetTxBuff && (Buf = cb->GetTxBuff(dev->Ctx,&Len)) != 0 && Len > 0){
+     if((uint32_t)Len > dev->TxDrop) Len = dev->TxDrop	;
+     cb->CommitTx(dev->Ctx,Len)	; dev->TxDrop -= Len	;}
+   dev->TxDrop = dev->TxZlp = 0	; dev->pTx = 0	;}
+
+ Buf = cb->GetTxBuff ? cb->GetTxBuff(dev->Ctx,&Len) : 0	;
+ if(Buf && Len > 0){
+   dev->pTx   = (uint8_t*)Buf						;
+   dev->TxCur = MIN(Len,dev->OutEpSize)				;
+   dev->TxZlp = dev->TxCur == dev->OutEpSize			;}
+ else if(dev->TxZlp){ dev->TxCur = 0	; dev->TxZlp = 0	;}// ZLP
+ else{ dev->pTx = 0	; return	;}
+
+ dev->TxBusy = 1								;
+ USBH_BulkSendData(dev->pdev,dev->pTx,dev->TxCur,dev->hc_num_out)	;}
+//-------------------------------------------------------------------------------
+//  URB   ,  USB_OTG_USBH_handle_hc_n_In/Out_ISR.
+// IN:   ,    ;   InBuff 
+//   ,  OTG    . ,  
+//  ,    , -    InBuff[InHead].   - 
+// ,   USBH_CDC_Handle  GetS.
+// OUT:   -  ,  ; NOTREADY (NAK) -  
+//    (   ),    USBH_CDC_TX_NAK_MS: ,
+//    ,     .
+static	void	USBH_CDC_OnURB(void* ctx,uint8_t hc_num,URB_STATE state)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)ctx	;
+ const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+ uint32_t		datalen, ms					;
+ uint16_t		fr							;
+ int			n							;
+
+ if(!dev->Active) return	;
+ if(hc_num == dev->hc_num_in){
+   if(state == URB_DONE && dev->pRx){
+     datalen = HCD_GetXferCnt(dev->pdev,hc_num)	;
+     if(datalen > 0){
+       if(dev->pRx == (uint8_t*)dev->InBuff[dev->InFill]) dev->InLen[dev->InFill] = datalen	;
+       else if(cb->CommitRx && (n = cb->CommitRx(dev->Ctx,datalen)) < (int)datalen){//    
+         memcpy(dev->InBuff[dev->InHead],dev->pRx + n,datalen - n)	;//     GetS
+         dev->InLen[dev->InHead] = datalen - n	; dev->InOff = 0	;}
+     }
+     USBH_CDC_RxFlush(dev)				;
+     dev->pRx = USBH_CDC_RxBuff(dev)	;
+     if(dev->pRx) USBH_BulkReceiveData(dev->pdev,dev->pRx,dev->InEpSize,hc_num)	;
+   }
+   else if(state != URB_NOTREADY) dev->pRx = 0	;// /STALL -  Handle
+ }
+ else if(hc_num == dev->hc_num_out && dev->TxBusy){
+   dev->TxBusy = 0	;
+   if(state == URB_NOTREADY){
+     fr = HCD_GetCurrentFrame(dev->pdev)	;
+     if(!dev->TxNak){ dev->TxNak = 1	; dev->TxNakFr = fr	;}
+     ms = (uint16_t)(fr - dev->TxNakFr) & 0x3FFF	;// HFNUM 14-: 16   FS, 2   HS
+     if(dev->pdev->cfg.speed == USB_OTG_SPEED_HIGH) ms >>= 3	;
+     if(ms >= USBH_CDC_TX_NAK_MS){ dev->TxDrop = USBH_CDC_DROP_ALL	; dev->TxNak = 0	; dev->CntTxDrop++	; TRACE1("CDC tx drop, nak %u ms\n",ms)	;}
+   }
+   else{ dev->TxNak = 0	;
+     if(state == URB_DONE){ if(dev->TxCur) cb->CommitTx(dev->Ctx,dev->TxCur)	;//  
+       if(dev->TxDrop){ dev->TxDrop -= MIN(dev->TxCur,dev->TxDrop)	; dev->TxZlp = 0	;}}//    
+     else{ dev->TxDrop = USBH_CDC_DROP_ALL	; dev->CntTxDrop++	; TRACE1("CDC tx drop, urb %d\n",state)	;}
+   }
+   USBH_CDC_TxNext(dev)	;
+ }
+}
 //-------------------------------------------------------------------------------
-static USBH_Status 	USBH_CDC_Handle(USB_OTG_CORE_HANDLE *pdev ,void   *phost)
+//     USBH_CDC_OnURB;  -  , 
+// InBuff      IN,   
+//   .
+static USBH_Status 	USBH_CDC_Handle(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev)
 {
-//  USBH_HOST *pphost = phost;
-    
   USBH_Status 		status      = USBH_BUSY;
-//  uint8_t 			cdcStatus   = USBH_CDC_BUSY;
-//  uint8_t 			appliStatus = 0;
-//  uint8_t 			xferDirection, index;
-  static uint32_t 	datalen,remainingDataLength;
-  static uint8_t 	*datapointer;// , *datapointer_prev;
-  URB_STATE 		URB_State	;
+  const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+  uint32_t			pm			;
     
   if(HCD_IsDeviceConnected(pdev))
   {   
-    switch(USBH_CDC_BOTXferParam.MSCState){
+    switch(dev->State){
 	
 	case	USBH_CDC_INIT:
-		USBH_CDC_BOTXferParam.MSCStateBkp = USBH_CDC_BOTXferParam.MSCState	;
-		USBH_CDC_BOTXferParam.MSCState    = USBH_CDC_GET_DATA				;//  IN endpoint
-		datapointer = 0	; remainingDataLength = 0							;
-		if(cbUSBH_CDC_MDM_Init) cbUSBH_CDC_MDM_Init()						;
+		dev->State    = USBH_CDC_GET_DATA								;//  IN endpoint
+		dev->pTx = dev->pRx = 0	; dev->TxBusy = dev->TxZlp = dev->TxNak = 0	;
+		dev->InLen[0] = dev->InLen[1] = 0	; dev->InOff = 0	; dev->InHead = 0	; dev->RxPark = 0	;
+		if(cb->MdmInit) cb->MdmInit(dev->Ctx)							;
 	break	;
 
-	case	USBH_CDC_SEND_DATA:
-        status = USBH_OK;
-		URB_State = HCD_GetURB_State(pdev , MSC_Machine.hc_num_out)		;
-		
-		if(URB_State == URB_DONE){
-		  if(USBH_CDC_BOTXferParam.MSCStateBkp != USBH_CDC_BOTXferParam.MSCState){
-		    USBH_CDC_BOTXferParam.MSCStateBkp = USBH_CDC_BOTXferParam.MSCState	;
-            datapointer = (uint8_t*)USBH_CDC_BOTXferParam.pRxTxBuff				;
-		    remainingDataLength =   USBH_CDC_BOTXferParam.DataLength			;}
-			
-		  datalen = MIN(remainingDataLength,MSC_Machine.MSBulkInEpSize)			;
-		  status = USBH_BulkSendData(pdev,datapointer,datalen, MSC_Machine.hc_num_out);
-		  if(status == USBH_OK){
-		    remainingDataLength -= datalen	;
-			if(remainingDataLength > 0) datapointer += datalen			;//      
-			else{			  		    datapointer = 0					;// 
-		      USBH_CDC_BOTXferParam.MSCState = USBH_CDC_GET_DATA		;//  IN endpoint
-			}
-		  }
-		}
-	break	;
-	
 	case	USBH_CDC_GET_DATA:
-        datapointer = (uint8_t*)InBuff	;
-		URB_State = HCD_GetURB_State(pdev , MSC_Machine.hc_num_in)		;
-		
-		if(URB_State == URB_DONE){
-		  datalen = HCD_GetXferCnt(pdev,MSC_Machine.hc_num_in)			;
-		  if(datalen > 0){
-		    InBuff[datalen] = 0	;
-		    if(cbUSBH_CDC_ListenData) cbUSBH_CDC_ListenData(InBuff,datalen)	;
-//		    Log.d("RECEIVE %d bytes: %s \n",datalen,InBuff)				;
-		  }
-		}
-		
-		if(URB_State == URB_DONE || USBH_CDC_BOTXferParam.MSCStateBkp != USBH_CDC_BOTXferParam.MSCState){
-		  USBH_CDC_BOTXferParam.MSCStateBkp = USBH_CDC_BOTXferParam.MSCState	;
-		  status = USBH_BulkReceiveData (pdev,datapointer,MSC_Machine.MSBulkInEpSize, MSC_Machine.hc_num_in);
-		}
-		else if(URB_State == URB_IDLE){
-		  USBH_CDC_BOTXferParam.MSCState = USBH_CDC_GET_DATA			;
+		pm = __get_PRIMASK()	; __disable_irq()						;// InBuff/pRx   USBH_CDC_OnURB
+		USBH_CDC_RxFlush(dev)											;
+		if(!dev->pRx){
+		  dev->pRx = USBH_CDC_RxBuff(dev)								;//  :   pRx
+		  if(dev->pRx)
+		    status = USBH_BulkReceiveData (pdev,dev->pRx,dev->InEpSize,dev->hc_num_in);
 		}
+		if(!pm) __enable_irq()											;
 	break	;
 	default : break	;
 	}
@@ -322,23 +432,27 @@ static USBH_Status USBH_MSC_Handle(USB_OTG_CORE_HANDLE *pdev ,void   *phost)
   uint8_t 			appliStatus = 0;
   
   static uint8_t maxLunExceed = FALSE;
+  USBH_CDC_Dev*	dev = CdcFind(pdev)	;
 
 //  uint8_t 			xferDirection, index;
 //  static uint32_t 	datalen;//remainingDataLength,;
 //  static uint8_t 	*datapointer;// , *datapointer_prev;
 //  URB_STATE 		URB_State	;
     
-  if(MSC_Machine.isCDC == 1)  status = USBH_CDC_Handle(pdev,phost)	;
+  if(dev && dev->Active)  status = USBH_CDC_Handle(dev,pdev)	;
   
   else if(HCD_IsDeviceConnected(pdev)){   
     switch(USBH_MSC_BOTXferParam.MSCState){
     case USBH_MSC_BOT_INIT_STATE:
       USBH_MSC_Init(pdev);
 	  
-	  MY_ModeSwitch(pdev,phost)		;//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+      if(MY_ModeSwitch(dev,pdev,pphost)) USBH_MSC_BOTXferParam.MSCState = USBH_MDM_SWITCH	;
+	  else{ MY_SwitchToMsc(dev)	;      USBH_MSC_BOTXferParam.MSCState = USBH_MSC_BOT_RESET	;}
+      break;
 	  
-      if(MSC_Machine.isCDC == 0)  USBH_MSC_BOTXferParam.MSCState = USBH_MSC_BOT_RESET	;  
-	  else                        USBH_MSC_BOTXferParam.MSCState = USBH_CDC_INIT		;
+    case USBH_MDM_SWITCH:											 //     ,
+      status = MY_ModeSwitchWait(dev,pdev)	;						 //   -    
+      if(status != USBH_BUSY){ MY_SwitchToMsc(dev)	; USBH_MSC_BOTXferParam.MSCState = USBH_MSC_BOT_RESET	; status = USBH_BUSY	;}
       break;
 	  
     case USBH_MSC_BOT_RESET:   
@@ -585,64 +699,98 @@ void USBH_MSC_ErrorHandle(uint8_t status)
   */ 
 
 //------------------------------------------------
-uint8_t		hex2nbl(char chHex)
-{uint8_t	rslt = 	chHex <  '0' ? 0 : chHex <= '9'	? chHex-'0'		: 
-					chHex <  'A' ? 0 : chHex <= 'F'	? chHex-'A'+10	: 
-					chHex <  'a' ? 0 : chHex <= 'a'	? chHex-'a'+10	: 0	;
- return		rslt	;}
-//------------------------------------------------
-int	hexstr2bin(uint8_t* buf,char* strMsg)
-{int	ix = 0	;
+//     : HFNUM 14- ( HS - ),
+//       - TmrProc   .
+static	uint32_t	MY_SwitchMs(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev)
+{uint16_t	fr = HCD_GetCurrentFrame(pdev)	;
 
- for(ix=0;buf && strMsg;ix+=2){
-   if(!strMsg[ix] || !strMsg[ix+1]) break	;
-   buf[ix>>1] = (hex2nbl(strMsg[ix])<<4) | hex2nbl(strMsg[ix+1])			;
- }
+ dev->SwFr   += (uint16_t)(fr - dev->SwFrame) & 0x3FFF	; dev->SwFrame = fr	;
+ return pdev->cfg.speed == USB_OTG_SPEED_HIGH ? dev->SwFr >> 3 : dev->SwFr	;}
+//------------------------------------------------
+//    :   ,  .
+// 0 -   (   ),    .
+static	int		MY_ModeSwitch(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev,USBH_HOST *phost)
+{const TMdmRec*	mdm	;
  
- if(ix) ix = (ix>>1)	;
- return	ix				;}
+ if(!dev || !dev->hc_num_out) return 0	;//      ,   MSC_Machine
+ mdm = MdmDbFind(phost->device_prop.Dev_Desc.idVendor,phost->device_prop.Dev_Desc.idProduct)	;
+ if(!mdm || !mdm->MsgLen) return 0	;
+ dev->Mdm = mdm		;//  
+
+ memcpy(dev->InBuff[0],mdm->Msg,mdm->MsgLen)	;//   ; flash  DMA  
+ USBH_BulkSendData(pdev,(uint8_t*)dev->InBuff[0],mdm->MsgLen,dev->hc_num_out)	;
+ dev->SwStep = 1	; dev->SwFr = 0	; dev->SwFrame = HCD_GetCurrentFrame(pdev)	;
+ LOG_D(LOG_CDC,"==>")	;
+ return 1	;}
 //------------------------------------------------
-
-
-//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-USBH_Status	MY_ModeSwitch(USB_OTG_CORE_HANDLE *pdev,void *phost)
+//  1 -  URB_DONE   MDM_SWITCH_TIMEOUT,  2 - Delay  
+//   . USBH_BUSY - , USBH_OK - ,   .
+static	USBH_Status		MY_ModeSwitchWait(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE *pdev)
+{const TMdmRec*	mdm = dev ? (const TMdmRec*)dev->Mdm : 0	;
+ URB_STATE		urb	;
+ uint32_t		ms	;
+
+ if(!mdm || !dev->SwStep) return USBH_FAIL	;
+ ms = MY_SwitchMs(dev,pdev)	;
+ if(dev->SwStep == 1){
+   urb = HCD_GetURB_State(pdev,dev->hc_num_out)	;
+   if(urb == URB_DONE){ TRACE1("ModeSwitch sent, %d ms\n",ms)	; dev->SwStep = 2	; dev->SwFr = 0	; return USBH_BUSY	;}
+   if(urb == URB_STALL || urb == URB_ERROR || ms >= MDM_SWITCH_TIMEOUT){
+     LOG_W(LOG_CDC,"ModeSwitch failed, urb %d, %u ms\n",urb,ms)	; dev->SwStep = 0	; return USBH_FAIL	;}
+   return USBH_BUSY	;}
+ if(ms < mdm->Delay) return USBH_BUSY	;
+ LOG_W(LOG_CDC,"ModeSwitch: %04X:%04X still here\n",mdm->Vid,mdm->Pid)	; dev->SwStep = 0	;
+ return USBH_OK	;}
+//------------------------------------------------
+//   -  :   dev  BOT (MSC_Machine)
+static	void	MY_SwitchToMsc(USBH_CDC_Dev* dev)
 {
- int 			Len = 0,Cnt=0,ix		;
- USBH_Status 	Status = USBH_OK		;
- URB_STATE		UrbState				;
- USBH_HOST 		*pphost = phost			;
- 
- USBH_DevDesc_TypeDef *hs = &pphost->device_prop.Dev_Desc;
- DeviceUsbMdm = 0	;
- 
- for(ix=0;ix<SIZE_TBL_USB_MDM;ix++){
-   if(hs->idVendor == TableUsbMdm[ix].Vid &&
-      hs->idProduct== TableUsbMdm[ix].Pid) 
-	  DeviceUsbMdm = TableUsbMdm + ix	;
- }
+ if(!dev || dev->Active || !dev->hc_num_out) return	;
+ MSC_Machine.hc_num_in  = dev->hc_num_in	; MSC_Machine.MSBulkInEp  = dev->InEp	; MSC_Machine.MSBulkInEpSize  = dev->InEpSize	;
+ MSC_Machine.hc_num_out = dev->hc_num_out	; MSC_Machine.MSBulkOutEp = dev->OutEp	; MSC_Machine.MSBulkOutEpSize = dev->OutEpSize	;
+ dev->hc_num_in = dev->hc_num_out = 0	;}
+//------------------------------------------------
+//   - USBH_Process    ,   
+int		USBH_CDC_Pending(USB_OTG_CORE_HANDLE *pdev)
+{USBH_CDC_Dev*	dev = CdcFind(pdev)	;
 
- if(DeviceUsbMdm){
-   Len = hexstr2bin(buffMsg,DeviceUsbMdm->strModeSwitch)	;// MAGIC
+ return dev && dev->SwStep	;}
+//------------------------------------------------
+//      (RxFlush   InBuff):  1  .
+//    GetS - USBH_Process ,   .
+int		USBH_CDC_RxParked(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+
+ if(!dev || !dev->RxPark) return 0	;
+ dev->RxPark = 0	;
+ return 1	;}
+//------------------------------------------------
+//    :  OUT  -   ,
+//      USBH_CDC_OnURB.
+USBH_Status		USBH_CDC_StartTx(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+ uint32_t		pm = __get_PRIMASK()		;
 
-   Status = USBH_BulkSendData(pdev,buffMsg,Len,MSC_Machine.hc_num_out);
- 
-   if(Status == USBH_OK){
-     Log.d("==>")	;
-     for(Cnt=0;UrbState != URB_DONE;Cnt++){
-       UrbState = HCD_GetURB_State(pdev ,MSC_Machine.hc_num_out);}
-	 
-     Log.d("ModeSwitch USBH_BulkSendData done %d\n",Cnt);
-   } 
-   else Log.d("ModeSwitch USBH_BulkSendData failed %d\n",Cnt);
- }
- return Status						;}
-//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+ if(!dev || !dev->Active) return USBH_FAIL	;
+ __disable_irq()					;// TxBusy   USBH_CDC_OnURB
+ if(!dev->TxBusy && dev->State == USBH_CDC_GET_DATA) USBH_CDC_TxNext(dev)	;
+ if(!pm) __enable_irq()				;
+
+ return	USBH_OK	;}
 //------------------------------------------------
-USBH_Status		USBH_CDC_WriteBuff(void* Data,int Len)
-{
- USBH_CDC_BOTXferParam.MSCState = USBH_CDC_SEND_DATA	;
- USBH_CDC_BOTXferParam.DataLength = Len					;
- USBH_CDC_BOTXferParam.pRxTxBuff  = Data				;
+//       (   ).   -
+//     ,    ;  - .
+USBH_Status		USBH_CDC_DropTx(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+ uint32_t		pm = __get_PRIMASK()		;
+ uint32_t		len	;
+
+ if(!dev) return USBH_FAIL			;
+ __disable_irq()					;//   TxBusy -   
+ len = dev->Cb && dev->Cb->GetTxLen ? dev->Cb->GetTxLen(dev->Ctx) : USBH_CDC_DROP_ALL	;
+ if(len > dev->TxDrop) dev->TxDrop = len	;//    -   
+ if(!dev->TxBusy) USBH_CDC_TxNext(dev)	;// ,    
+ if(!pm) __enable_irq()				;
 
  return	USBH_OK	;}
 //------------------------------------------------
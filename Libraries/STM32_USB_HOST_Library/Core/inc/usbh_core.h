@@ -220,6 +220,19 @@ typedef struct _USBH_USR_PROP
 }
 USBH_Usr_cb_TypeDef;
 
+/*   -  :  desc_cb  USBH_Init.
+   Load -     (raw -  ): 1 -
+   Cfg/Itf/Ep   ,     .
+   Drop -      (SET_CONFIGURATION  Init  
+   ):    ,   .
+     -  ,  USBH_Process ( flash). */
+typedef struct _USBH_DescCache_cb
+{
+  uint8_t (*Load)(USBH_Device_TypeDef *prop, const uint8_t *raw, uint16_t len);
+  void    (*Drop)(const USBH_Device_TypeDef *prop);
+}
+USBH_DescCache_cb_TypeDef;
+
 typedef struct _Host_TypeDef
 {
   HOST_State            gState;       /*  Host State Machine Value */
@@ -233,6 +246,11 @@ typedef struct _Host_TypeDef
   USBH_Class_cb_TypeDef               *class_cb;  
   USBH_Usr_cb_TypeDef  	              *usr_cb;
 
+  USBH_DescCache_cb_TypeDef           *desc_cb;
+
+  uint32_t              EnumCyc;      /* CYCCNT   */
+  uint32_t              EnumUs;       /*   ,  */
+  uint8_t               DescCached;   /*    ,   */
   
 } USBH_HOST, *pUSBH_HOST;
 
@@ -97,6 +97,7 @@ USBH_HCD_INT_cb_TypeDef  *USBH_HCD_INT_fops = &USBH_HCD_INT_cb;
   * @{
   */
 static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost);
+static void USBH_DescCacheMiss(USBH_HOST *phost);
 USBH_Status USBH_HandleControl (USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost);
 
 /**
@@ -260,6 +261,7 @@ void USBH_Process(USB_OTG_CORE_HANDLE *pdev , USBH_HOST *phost)
       phost->device_prop.speed = HCD_GetCurrentSpeed(pdev);
       
       phost->gState = HOST_ENUMERATION;
+      phost->EnumCyc = HC_STAT_CYCCNT;
       phost->usr_cb->DeviceSpeedDetected(phost->device_prop.speed);
         
       /* Open Control pipes */
@@ -302,6 +304,18 @@ void USBH_Process(USB_OTG_CORE_HANDLE *pdev , USBH_HOST *phost)
       {
         phost->gState  = HOST_CLASS_REQUEST;     
       }     
+      else if (phost->DescCached)
+      {
+        /*       -    */
+        USBH_DescCacheMiss(phost);
+        phost->gState  = HOST_ENUMERATION;
+      }
+      else
+      {
+        /*       */
+        phost->usr_cb->DeviceNotSupported();
+        phost->gState  = HOST_CLASS_REQUEST;
+      }
     }   
     break;
     
@@ -397,6 +411,7 @@ void USBH_ErrorHandle(USBH_HOST *phost, USBH_Status errType)
 static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost)
 {
   USBH_Status Status = USBH_BUSY;  
+  USBH_Status ReqStatus;
   uint8_t Local_Buffer[64];
   
   switch (phost->EnumState)
@@ -436,6 +451,15 @@ static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost)
       /* user callback for device descriptor available */
       phost->usr_cb->DeviceDescAvailable(&phost->device_prop.Dev_Desc);      
       phost->EnumState = ENUM_SET_ADDR;
+      
+      /*  : Cfg/Itf/Ep -   */
+      phost->DescCached = 0;
+      if (phost->desc_cb)
+      {
+        phost->DescCached = phost->desc_cb->Load(&phost->device_prop,
+                                                 pdev->host.Rx_Buffer,
+                                                 USB_DEVICE_DESC_SIZE);
+      }
     }
     break;
    
@@ -450,6 +474,15 @@ static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost)
       phost->usr_cb->DeviceAddressAssigned();
       phost->EnumState = ENUM_GET_CFG_DESC;
       
+      /*  :      (USBH_CfgDesc  ) */
+      if (phost->DescCached)
+      {
+        phost->usr_cb->ConfigurationDescAvailable(&phost->device_prop.Cfg_Desc,
+                                                        phost->device_prop.Itf_Desc,
+                                                        phost->device_prop.Ep_Desc[0]);
+        phost->EnumState = ENUM_SET_CONFIGURATION;
+      }
+      
       /* modify control channels to update device address */
       USBH_Modify_Channel (pdev,
                            phost->Control.hc_num_in,
@@ -558,11 +591,18 @@ static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost)
       
   case ENUM_SET_CONFIGURATION:
     /* set configuration  (default config) */
-    if (USBH_SetCfg(pdev, 
-                    phost,
-                    phost->device_prop.Cfg_Desc.bConfigurationValue) == USBH_OK)
+    ReqStatus = USBH_SetCfg(pdev, 
+                            phost,
+                            phost->device_prop.Cfg_Desc.bConfigurationValue);
+    if (ReqStatus == USBH_OK)
     {
       phost->EnumState = ENUM_DEV_CONFIGURED;
+      phost->EnumUs = (HC_STAT_CYCCNT - phost->EnumCyc) / (SystemCoreClock / 1000000);
+    }
+    else if ((ReqStatus != USBH_BUSY) && phost->DescCached)
+    {
+      /*       */
+      USBH_DescCacheMiss(phost);
     }
     break;
 
@@ -579,6 +619,22 @@ static USBH_Status USBH_HandleEnum(USB_OTG_CORE_HANDLE *pdev, USBH_HOST *phost)
 }
 
 
+/**
+  * @brief  USBH_DescCacheMiss
+  *         Cached configuration rejected: drop the cache entry and
+  *         read the configuration and string descriptors from the device
+  * @param  phost: Host handle
+  * @retval None
+  */
+static void USBH_DescCacheMiss(USBH_HOST *phost)
+{
+  phost->desc_cb->Drop(&phost->device_prop);
+  phost->DescCached = 0;
+  phost->Control.errorcount = 0;
+  phost->EnumState = ENUM_GET_CFG_DESC;
+}
+
+
 /**
   * @brief  USBH_HandleControl
   *         Handles the USB control transfer state machine
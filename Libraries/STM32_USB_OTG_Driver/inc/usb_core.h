@@ -101,6 +101,29 @@ typedef enum {
   URB_STALL
 }URB_STATE;
 
+/*    -    OTG (. HCD_SetURBCallback) */
+typedef void (*HCD_URB_Cb)(void *ctx, uint8_t hc_num, URB_STATE state);
+
+/*   .  ,    : 
+   OTG  HCD_SubmitRequest    -   , 
+    -  32- .    ,  - HCD_GetStat. */
+#define HC_STAT_LAT_CNT     16          /*  n:  -> URB_DONE  [2^n, 2^(n+1))  */
+#ifndef HC_STAT_CYCCNT
+#define HC_STAT_CYCCNT      (*(volatile uint32_t*)0xE0001004)   /* DWT->CYCCNT ( Clock);      */
+#endif
+
+typedef struct _HC_STAT
+{
+  uint32_t  Submit;                     /*   */
+  uint32_t  Retry;                      /*     URB_NOTREADY  XACTERR */
+  uint32_t  Bytes;                      /*   URB_DONE */
+  uint32_t  Urb[URB_STALL + 1];         /*    URB_STATE */
+  uint32_t  Ev[HC_DATATGLERR + 1];      /*    HC_STATUS: NAK, XACTERR... */
+  uint32_t  Lat[HC_STAT_LAT_CNT];
+  uint32_t  TimeSubmit;                 /* CYCCNT  */
+}
+HC_STAT;
+
 typedef enum {
   CTRL_START = 0,
   CTRL_XFRC,
@@ -278,6 +301,9 @@ typedef struct _HCD
   __IO uint32_t            XferCnt[USB_OTG_MAX_TX_FIFOS];
   __IO HC_STATUS           HC_Status[USB_OTG_MAX_TX_FIFOS];  
   __IO URB_STATE           URB_State[USB_OTG_MAX_TX_FIFOS];
+  HCD_URB_Cb               URB_Cb[USB_OTG_MAX_TX_FIFOS];
+  void                     *URB_Ctx[USB_OTG_MAX_TX_FIFOS];
+  HC_STAT                  Stat[USB_OTG_MAX_TX_FIFOS];
   USB_OTG_HC               hc [USB_OTG_MAX_TX_FIFOS];
   uint16_t                 channel [USB_OTG_MAX_TX_FIFOS];
 //  USB_OTG_hPort_TypeDef    *port_cb;  
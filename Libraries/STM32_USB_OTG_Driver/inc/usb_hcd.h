@@ -90,6 +90,11 @@ uint32_t  HCD_GetCurrentFrame      (USB_OTG_CORE_HANDLE *pdev) ;
 URB_STATE HCD_GetURB_State         (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num); 
 uint32_t  HCD_GetXferCnt           (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num); 
 HC_STATUS HCD_GetHCState           (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num) ;
+void      HCD_SetURBCallback       (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num,
+                                    HCD_URB_Cb cb, void *ctx);
+const HC_STAT *HCD_GetStat         (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num);
+void      HCD_ClearStat            (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num);
+void      HCD_StatURB              (USB_OTG_CORE_HANDLE *pdev,  uint8_t ch_num);
 /**
   * @}
   */ 
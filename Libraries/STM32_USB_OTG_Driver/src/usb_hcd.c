@@ -30,6 +30,7 @@
 #include "usb_hcd.h"
 #include "usb_conf.h"
 #include "usb_bsp.h"
+#include <string.h>
 
 
 /** @addtogroup USB_OTG_DRIVER
@@ -105,6 +106,7 @@ uint32_t HCD_Init(USB_OTG_CORE_HANDLE *pdev ,
   pdev->host.ErrCnt[i]  = 0;
   pdev->host.XferCnt[i]   = 0;
   pdev->host.HC_Status[i]   = HC_IDLE;
+  HCD_ClearStat(pdev, i);
   }
   pdev->host.hc[0].max_packet  = 8; 
 
@@ -205,6 +207,78 @@ uint32_t HCD_GetXferCnt (USB_OTG_CORE_HANDLE *pdev, uint8_t ch_num)
   return pdev->host.XferCnt[ch_num] ;
 }
 
+/**
+  * @brief  HCD_SetURBCallback 
+  *         cb    OTG,     
+  *         (URB_DONE, URB_NOTREADY, URB_STALL, URB_ERROR);   
+  *            . cb = 0 - .
+  * @param  pdev: Selected device
+  * @retval None
+  */
+void HCD_SetURBCallback (USB_OTG_CORE_HANDLE *pdev, uint8_t ch_num, HCD_URB_Cb cb, void *ctx) 
+{
+  pdev->host.URB_Cb[ch_num]  = 0;        /*     */
+  pdev->host.URB_Ctx[ch_num] = ctx;
+  pdev->host.URB_Cb[ch_num]  = cb;
+}
+
+/**
+  * @brief  HCD_GetStat 
+  *           (. HC_STAT);     ,
+  *               .
+  * @param  pdev: Selected device
+  * @retval HC_STAT
+  */
+const HC_STAT *HCD_GetStat (USB_OTG_CORE_HANDLE *pdev, uint8_t ch_num) 
+{
+  return &pdev->host.Stat[ch_num];
+}
+
+/**
+  * @brief  HCD_ClearStat 
+  *           .    .
+  * @param  pdev: Selected device
+  * @retval None
+  */
+void HCD_ClearStat (USB_OTG_CORE_HANDLE *pdev, uint8_t ch_num) 
+{
+  memset(&pdev->host.Stat[ch_num], 0, sizeof(HC_STAT));
+}
+
+/**
+  * @brief  HCD_StatURB 
+  *           :   OTG,   .
+  *          -  HCD_SubmitRequest  URB_DONE,   log2 .
+  * @param  pdev: Selected device
+  * @retval None
+  */
+void HCD_StatURB (USB_OTG_CORE_HANDLE *pdev, uint8_t ch_num) 
+{
+  HC_STAT   *st = &pdev->host.Stat[ch_num];
+  URB_STATE urb = pdev->host.URB_State[ch_num];
+  uint32_t  lat, bin = 0;
+  
+  if (urb == URB_IDLE)                  /* XACTERR   */
+  {
+    return;
+  }
+  st->Urb[urb]++;
+  if (urb != URB_DONE)
+  {
+    return;
+  }
+  /* OUT: xfer_count    nptxfempty,  -  xfer_len */
+  st->Bytes += pdev->host.hc[ch_num].ep_is_in ? pdev->host.XferCnt[ch_num] :
+                                                pdev->host.hc[ch_num].xfer_count +
+                                                pdev->host.hc[ch_num].xfer_len;
+  lat = (HC_STAT_CYCCNT - st->TimeSubmit) / (SystemCoreClock / 1000000);
+  while (bin < HC_STAT_LAT_CNT - 1 && (lat >> (bin + 1)))
+  {
+    bin++;
+  }
+  st->Lat[bin]++;
+}
+
 
 
 /**
@@ -240,9 +314,20 @@ uint32_t HCD_HC_Init (USB_OTG_CORE_HANDLE *pdev , uint8_t hc_num)
   */
 uint32_t HCD_SubmitRequest (USB_OTG_CORE_HANDLE *pdev , uint8_t hc_num) 
 {
+  HC_STAT *st = &pdev->host.Stat[hc_num];
   
+  st->Submit++;
+  /* XACTERR  3 : URB_IDLE,     NAK */
+  if ((pdev->host.URB_State[hc_num] == URB_NOTREADY) ||
+      (pdev->host.URB_State[hc_num] == URB_IDLE &&
+       pdev->host.HC_Status[hc_num] == HC_XACTERR))
+  {
+    st->Retry++;
+  }
+  st->TimeSubmit = HC_STAT_CYCCNT;
   pdev->host.URB_State[hc_num] =   URB_IDLE;  
   pdev->host.hc[hc_num].xfer_count = 0 ;
+  pdev->host.XferCnt[hc_num] = 0;       /* IN     XferCnt  rx_qlvl */
   return USB_OTG_HC_StartXfer(pdev, hc_num);
 }
 
@@ -52,6 +52,9 @@
 /** @defgroup USB_HCD_INT_Private_Defines
 * @{
 */ 
+/*       HC_STAT:     */
+#define HC_SET_STATUS(pdev, num, st)  { (pdev)->host.HC_Status[num] = (st); \
+                                        (pdev)->host.Stat[num].Ev[st]++; }
 /**
 * @}
 */ 
@@ -98,6 +101,7 @@ static uint32_t USB_OTG_USBH_handle_nptxfempty_ISR (USB_OTG_CORE_HANDLE *pdev);
 static uint32_t USB_OTG_USBH_handle_ptxfempty_ISR (USB_OTG_CORE_HANDLE *pdev);
 static uint32_t USB_OTG_USBH_handle_Disconnect_ISR (USB_OTG_CORE_HANDLE *pdev);
 static uint32_t USB_OTG_USBH_handle_IncompletePeriodicXfer_ISR (USB_OTG_CORE_HANDLE *pdev);
+static void     USB_OTG_USBH_NotifyURB (USB_OTG_CORE_HANDLE *pdev , uint32_t num);
 
 /**
 * @}
@@ -497,7 +501,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , xfercompl);
-    pdev->host.HC_Status[num] = HC_XFRC;            
+    HC_SET_STATUS(pdev, num, HC_XFRC);            
   }
   
   else if (hcint.b.stall)
@@ -505,7 +509,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     CLEAR_HC_INT(hcreg , stall);
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
-    pdev->host.HC_Status[num] = HC_STALL;      
+    HC_SET_STATUS(pdev, num, HC_STALL);      
   }
   
   else if (hcint.b.nak)
@@ -514,7 +518,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , nak);
-    pdev->host.HC_Status[num] = HC_NAK;      
+    HC_SET_STATUS(pdev, num, HC_NAK);      
   }
   
   else if (hcint.b.xacterr)
@@ -522,7 +526,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     pdev->host.ErrCnt[num] ++;
-    pdev->host.HC_Status[num] = HC_XACTERR;
+    HC_SET_STATUS(pdev, num, HC_XACTERR);
     CLEAR_HC_INT(hcreg , xacterr);
   }
   else if (hcint.b.nyet)
@@ -531,7 +535,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , nyet);
-    pdev->host.HC_Status[num] = HC_NYET;    
+    HC_SET_STATUS(pdev, num, HC_NYET);    
   }
   else if (hcint.b.datatglerr)
   {
@@ -539,7 +543,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , nak);   
-    pdev->host.HC_Status[num] = HC_DATATGLERR;
+    HC_SET_STATUS(pdev, num, HC_DATATGLERR);
     
     CLEAR_HC_INT(hcreg , datatglerr);
   }  
@@ -581,11 +585,36 @@ uint32_t USB_OTG_USBH_handle_hc_n_Out_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t
       }
     }
     CLEAR_HC_INT(hcreg , chhltd);    
+    HCD_StatURB(pdev, num);
+    USB_OTG_USBH_NotifyURB(pdev, num);   /*   chhltd: cb    */
   }
   
   
   return 1;
 }
+/**
+* @brief  USB_OTG_USBH_NotifyURB 
+*           -  ,   USBH_Process.
+*         XACTERR   3  (URB_IDLE) -  NAK:  , .
+* @param  pdev: Selected device
+* @param  num: Channel number
+* @retval None
+*/
+static void USB_OTG_USBH_NotifyURB (USB_OTG_CORE_HANDLE *pdev , uint32_t num)
+{
+  HCD_URB_Cb  cb = pdev->host.URB_Cb[num];
+  URB_STATE   state = pdev->host.URB_State[num];
+  
+  if (state == URB_IDLE && pdev->host.HC_Status[num] == HC_XACTERR)
+  {
+    state = URB_NOTREADY;
+  }
+  if (cb && state != URB_IDLE)
+  {
+    cb(pdev->host.URB_Ctx[num], (uint8_t)num, state);
+  }
+}
+
 #if defined ( __ICCARM__ ) /*!< IAR Compiler */
 #pragma optimize = none
 #endif /* __CC_ARM */
@@ -626,7 +655,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
   else if (hcint.b.stall)  
   {
     UNMASK_HOST_INT_CHH (num);
-    pdev->host.HC_Status[num] = HC_STALL; 
+    HC_SET_STATUS(pdev, num, HC_STALL); 
     CLEAR_HC_INT(hcreg , nak);   /* Clear the NAK Condition */
     CLEAR_HC_INT(hcreg , stall); /* Clear the STALL Condition */
     hcint.b.nak = 0;           /* NOTE: When there is a 'stall', reset also nak, 
@@ -640,7 +669,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
     UNMASK_HOST_INT_CHH (num);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , nak);   
-    pdev->host.HC_Status[num] = HC_DATATGLERR; 
+    HC_SET_STATUS(pdev, num, HC_DATATGLERR); 
     CLEAR_HC_INT(hcreg , datatglerr);
   }    
   
@@ -660,7 +689,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
       pdev->host.XferCnt[num] =  pdev->host.hc[num].xfer_len - hctsiz.b.xfersize;
     }
     
-    pdev->host.HC_Status[num] = HC_XFRC;     
+    HC_SET_STATUS(pdev, num, HC_XFRC);     
     pdev->host.ErrCnt [num]= 0;
     CLEAR_HC_INT(hcreg , xfercompl);
     
@@ -708,13 +737,15 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
     }
     
     CLEAR_HC_INT(hcreg , chhltd);    
+    HCD_StatURB(pdev, num);
+    USB_OTG_USBH_NotifyURB(pdev, num);   /*   chhltd: cb    */
     
   }    
   else if (hcint.b.xacterr)
   {
     UNMASK_HOST_INT_CHH (num);
     pdev->host.ErrCnt[num] ++;
-    pdev->host.HC_Status[num] = HC_XACTERR;
+    HC_SET_STATUS(pdev, num, HC_XACTERR);
     USB_OTG_HC_Halt(pdev, num);
     CLEAR_HC_INT(hcreg , xacterr);    
     
@@ -734,7 +765,7 @@ uint32_t USB_OTG_USBH_handle_hc_n_In_ISR (USB_OTG_CORE_HANDLE *pdev , uint32_t n
       hcchar.b.chdis = 0;
       USB_OTG_WRITE_REG32(&pdev->regs.HC_REGS[num]->HCCHAR, hcchar.d32); 
     }
-    pdev->host.HC_Status[num] = HC_NAK;
+    HC_SET_STATUS(pdev, num, HC_NAK);
     CLEAR_HC_INT(hcreg , nak);   
   }
   
@@ -0,0 +1,61 @@
+#ifndef	DESC_CACHE_H
+#define	DESC_CACHE_H
+
+#include	<stdint.h>
+#include	"usbh_core.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#define		DESCC_SIGN			0x31434444	// "DDC1"
+#define		DESCC_RAM_CNT		4		//  -  VID:PID (  )  
+
+//   : , ,  
+// (device_prop)  VID:PID:bcdDevice.   CRC32 
+//   - ,   :  - 
+//  ()   () ,  SET_CONFIGURATION.
+//    -  USBH_HOST::desc_cb (DescCacheCb).  ,
+// DescCacheSave    main,     .
+// ,    ,  (DescCacheDrop):  RAM
+// ,  flash DescCacheSave  Crc ,   
+//  .
+//  RAM -  DESCC_RAM_CNT ,  flash - :  
+//    ,  ,   .
+typedef	struct	Struct_DescRec{
+	uint32_t					Sign				;//  :  
+	uint16_t					Vid,Pid,Bcd			;
+	uint16_t					Rsv					;
+	uint32_t					Hash				;// CRC32    
+	USBH_CfgDesc_TypeDef		Cfg					;
+	USBH_InterfaceDesc_TypeDef	Itf[USBH_MAX_NUM_INTERFACES]	;
+	USBH_EpDesc_TypeDef			Ep[USBH_MAX_NUM_INTERFACES][USBH_MAX_NUM_ENDPOINTS]	;
+	uint32_t					Crc					;//  :  
+} TDescRec;
+
+typedef	struct	Struct_DescCacheStat{
+	uint32_t	CntHit,CntMiss		;
+	uint32_t	CntFlash			;//   
+	uint32_t	CntErase			;
+	uint32_t	CntDrop				;// ,   
+} TDescCacheStat;
+
+//  -   10, IROM    
+#ifndef		DESCC_FLASH_ADDR
+#define		DESCC_FLASH_ADDR	0x080C0000
+#endif
+#define		DESCC_FLASH_SIZE	0x20000
+
+uint8_t			DescCacheLoad(USBH_Device_TypeDef* prop,const uint8_t* raw,uint16_t len)	;// 1 - : Cfg/Itf/Ep  
+void			DescCacheSave(const USBH_Device_TypeDef* prop)	;//   ;  flash,   ~1 
+void			DescCacheDrop(const USBH_Device_TypeDef* prop)	;//     
+void			DescCacheInit(void)				;//   
+
+extern	TDescCacheStat				DescCacheStat	;
+extern	USBH_DescCache_cb_TypeDef	DescCacheCb		;
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
@@ -1,10 +1,82 @@
 #ifndef	LOG_H
 #define	LOG_H
 
+#include	<stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#define		LOG_SIZE			2048	// ,  !
+#define		LOG_LINE			160		//   Log.d/Log.e,  - 
+#define		LOG_DROP_NEWEST		0		//   -  
+#define		LOG_DROP_OLDEST		1		//   -    
+#ifndef		LOG_DROP
+#define		LOG_DROP			LOG_DROP_NEWEST
+#endif
+#ifndef		LOG_RECS
+#define		LOG_RECS			64		// LOG_DROP_OLDEST:     ( ),  -   
+#endif
+#ifndef		LOG_SWO
+#define		LOG_SWO				0		// 1 -   ITM  0,    
+#endif
+
+//   .   LOG_E/W/I/D(,,...):  
+//  LOG_LEVEL     LOG_MODULES,  -  0 
+//         .
+//         : LogLevel[].
+#define		LOG_LVL_NONE		0
+#define		LOG_LVL_ERR			1
+#define		LOG_LVL_WRN			2
+#define		LOG_LVL_INF			3
+#define		LOG_LVL_DBG			4
+#ifndef		LOG_LEVEL
+#define		LOG_LEVEL			LOG_LVL_DBG	//      
+#endif
+
+#define		LOG_GSM				0
+#define		LOG_USBH			1
+#define		LOG_CDC				2
+#define		LOG_MSC				3
+#define		LOG_FATFS			4
+#define		LOG_MOD_CNT			5
+#ifndef		LOG_MODULES
+#define		LOG_MODULES			0x1F		//  (1 << LOG_xxx) -  
+#endif
+
+#define		LOG_CT(m,l)			((l) <= LOG_LEVEL && (LOG_MODULES & (1 << (m))))
+#define		LOG_ON(m,l)			(LOG_CT(m,l) && LogLevel[m] >= (l))
+
+#define		LOG_E(m,...)		do{ if(LOG_ON(m,LOG_LVL_ERR)) Log.e(__VA_ARGS__)	;}while(0)
+#define		LOG_W(m,...)		do{ if(LOG_ON(m,LOG_LVL_WRN)) Log.d(__VA_ARGS__)	;}while(0)
+#define		LOG_I(m,...)		do{ if(LOG_ON(m,LOG_LVL_INF)) Log.d(__VA_ARGS__)	;}while(0)
+#define		LOG_D(m,...)		do{ if(LOG_ON(m,LOG_LVL_DBG)) Log.d(__VA_ARGS__)	;}while(0)
+
 typedef	struct	Struct_Log{
 	int (*d)(const char * __restrict /*format*/, ...)	;
 	int (*e)(const char * __restrict /*format*/, ...)	;
 } TLog;
 
-extern		TLog	Log	;
+typedef	struct	Struct_LogStat{
+	uint32_t	CntDrop		;//  
+	uint32_t	CntLost		;// ,    
+	uint32_t	MaxUsed		;//   , 
+} TLogStat;
+
+extern		TLog		Log		;
+extern		TLogStat	LogStat	;
+extern		uint8_t		LogLevel[LOG_MOD_CNT]	;//  ,   LOG_LEVEL
+
+void		LogInit(void)							;//  InitUSART
+int			LogWrite(const char* buf,int len)		;// ,  
+int			LogPrintf(const char* fmt,...)			;
+int			LogEmpty(void)							;//  
+#ifdef		LOG_HOST
+extern		void		(*LogHostOut)(const char* buf,uint32_t len)	;//    DMA, 0 - stdout
+#endif
+
+#ifdef __cplusplus
+ }
+#endif
+
 #endif
@@ -0,0 +1,58 @@
+#ifndef	MDM_DB_H
+#define	MDM_DB_H
+
+#include	<stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#define		MDMDB_SIGN			0x3142444D	// "MDB1"
+#define		MDMDB_MSG_MAX		32		//   (CBW - 31 )
+#define		MDMDB_CNT_MAX		1024	// ,  -  
+#define		MDMDB_DELAY_MAX		15000	//  , 
+
+//  : VID/PID    ->    
+//       .   tools/mdmdb.py 
+//    usb_modeswitch:   (MdmDbRom.c)   MODEMS.BIN
+//  .    (Vid,Pid) -  .
+// : , ; little endian, CRC32 ( zlib)  .
+typedef	struct	Struct_MdmRec{
+	uint16_t	Vid,Pid				;
+	uint8_t		Class,Proto			;//    
+	int8_t		Intf				;//  , -1 -  
+	uint8_t		MsgLen				;// 0 -   
+	uint16_t	Delay				;//     
+	uint16_t	Rsv					;
+	uint8_t		Msg[MDMDB_MSG_MAX]	;
+} TMdmRec;							 // 44 
+
+typedef	struct	Struct_MdmDbHdr{
+	uint32_t	Sign				;
+	uint16_t	Ver					;
+	uint16_t	Cnt					;
+	uint32_t	Crc					;
+} TMdmDbHdr;
+
+int				MdmDbCheck(const void* img,uint32_t size)	;//  , -1 -  
+int				MdmDbSet(const void* img,uint32_t size)		;// 0 - ,  
+const TMdmRec*	MdmDbFind(uint16_t vid,uint16_t pid)		;
+uint32_t		MdmDbCrc(uint32_t crc,const void* data,uint32_t len)	;
+
+//   MODEMS.BIN     flash ( IROM ) 
+//  ;    -    .
+#define		MDMDB_FLASH_ADDR	0x080E0000	//  11
+#define		MDMDB_FLASH_SIZE	0x20000
+#define		MDMDB_FILE			"0:MODEMS.BIN"
+
+void			MdmDbInit(void)					;// flash  
+int				MdmDbUpdate(void)				;//   (FatFS ): 1 - 
+
+extern	const uint32_t	MdmDbRom[]				;// tools/mdmdb.py -> src/MdmDbRom.c
+extern	const uint32_t	MdmDbRomSize			;
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef	TRACE_H
+#define	TRACE_H
+
+#include	<stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#ifndef		TRACE_ON
+#define		TRACE_ON			1		// 0 - TRACEn()   
+#endif
+#define		TRACE_SYNC			0x00	//  :   Log.d   
+#define		TRACE_ARG_MAX		4
+
+//  :  printf   (    DMA,  
+// Log.d)   -   ,   (DWT CYCCNT) 
+//   .     tools/trace_dec.py   
+// .axf.  fmt -  , %s -    flash ().
+// : TRACE_SYNC, n, fmt[4], time[4], arg[4]*n; little endian.
+void		TraceRec(const char* fmt,int n,uint32_t a0,uint32_t a1,uint32_t a2,uint32_t a3)	;
+
+#if	TRACE_ON
+#define		TRACE0(f)				TraceRec(f,0,0,0,0,0)
+#define		TRACE1(f,a)				TraceRec(f,1,(uint32_t)(uintptr_t)(a),0,0,0)
+#define		TRACE2(f,a,b)			TraceRec(f,2,(uint32_t)(uintptr_t)(a),(uint32_t)(uintptr_t)(b),0,0)
+#define		TRACE3(f,a,b,c)			TraceRec(f,3,(uint32_t)(uintptr_t)(a),(uint32_t)(uintptr_t)(b),(uint32_t)(uintptr_t)(c),0)
+#define		TRACE4(f,a,b,c,d)		TraceRec(f,4,(uint32_t)(uintptr_t)(a),(uint32_t)(uintptr_t)(b),(uint32_t)(uintptr_t)(c),(uint32_t)(uintptr_t)(d))
+#else
+#define		TRACE0(f)
+#define		TRACE1(f,a)
+#define		TRACE2(f,a,b)
+#define		TRACE3(f,a,b,c)
+#define		TRACE4(f,a,b,c,d)
+#endif
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
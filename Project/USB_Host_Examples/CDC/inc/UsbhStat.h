@@ -0,0 +1,19 @@
+#ifndef	USBH_STAT_H
+#define	USBH_STAT_H
+
+#include	"usb_core.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+//   OTG (HC_STAT, usb_hcd.c) -  ,   cmdUsbStat.
+//    ;  -  log2,  :
+// " <8:5" - 5   8  (   4).
+void		UsbhStatLog(USB_OTG_CORE_HANDLE* pdev)	;
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
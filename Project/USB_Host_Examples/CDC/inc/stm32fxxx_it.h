@@ -71,6 +71,8 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 
+extern void (*cbOTG_IRQ)(void);   /* called at the end of the OTG ISR, 0 - none */
+
 #ifdef __cplusplus
 }
 #endif
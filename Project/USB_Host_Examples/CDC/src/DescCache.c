@@ -0,0 +1,140 @@
+#include	"DescCache.h"
+#include	<string.h>
+#include	<stddef.h>
+#include	<stm32f4xx.h>
+#include	"MdmDb.h"
+#include	"Log.h"
+//===============================================
+#define		DESCC_SECTOR		FLASH_Sector_10
+#define		DESCC_SLOTS			(DESCC_FLASH_SIZE/sizeof(TDescRec))
+#define		DESCC_CRC_LEN		(offsetof(TDescRec,Crc) - offsetof(TDescRec,Vid))
+#define		DESCC_FREE			0xFFFFFFFF
+#define		DESCC_DEAD			0			// Crc  
+//===============================================
+static TDescRec		Ram[DESCC_RAM_CNT]		;
+static int			RamNext		= 0			;//   ( )
+static uint32_t		FlashUsed	= 0			;//   
+static uint32_t		PendHash				;//    -   
+static uint8_t		Pend		= 0			;
+static USBH_DevDesc_TypeDef	KillDev			;//  :   flash  main
+static uint32_t		KillHash				;
+static uint8_t		Kill		= 0			;
+TDescCacheStat		DescCacheStat			;
+USBH_DescCache_cb_TypeDef	DescCacheCb	= {DescCacheLoad,DescCacheDrop}	;
+//===============================================
+static const TDescRec*	Slot(uint32_t ix){ return (const TDescRec*)DESCC_FLASH_ADDR + ix	;}
+//===============================================
+static int	RecIs(const TDescRec* rec,const USBH_DevDesc_TypeDef* dev,uint32_t hash)
+{
+ return rec->Sign == DESCC_SIGN && rec->Hash == hash && rec->Crc != DESCC_DEAD &&
+		rec->Vid == dev->idVendor && rec->Pid == dev->idProduct && rec->Bcd == dev->bcdDevice &&
+		MdmDbCrc(0,&rec->Vid,DESCC_CRC_LEN) == rec->Crc	;}
+//===============================================
+// RAM,   (  -  );   flash
+//   RAM.  USBH_Process:  .
+uint8_t		DescCacheLoad(USBH_Device_TypeDef* prop,const uint8_t* raw,uint16_t len)
+{const TDescRec*	rec = 0	;
+ uint32_t			ix, hash = MdmDbCrc(0,raw,len)	;
+
+ for(ix=0;ix<DESCC_RAM_CNT && !rec;ix++) if(RecIs(Ram + ix,&prop->Dev_Desc,hash)) rec = Ram + ix	;
+ if(!rec){
+   for(ix=0;ix<FlashUsed;ix++) if(RecIs(Slot(ix),&prop->Dev_Desc,hash) && !(Kill && RecIs(Slot(ix),&KillDev,KillHash))) rec = Slot(ix)	;
+   if(rec){ Ram[RamNext] = *rec	; rec = Ram + RamNext	; RamNext = (RamNext + 1) % DESCC_RAM_CNT	;}
+ }
+ Pend = !rec	; PendHash = hash	;
+ if(!rec){ DescCacheStat.CntMiss++	; return 0	;}
+
+ prop->Cfg_Desc = rec->Cfg								;
+ memcpy(prop->Itf_Desc,rec->Itf,sizeof(rec->Itf))		;
+ memcpy(prop->Ep_Desc ,rec->Ep ,sizeof(rec->Ep ))		;
+ DescCacheStat.CntHit++	;
+ return 1	;}
+//===============================================
+// Sign - :       (  CRC),
+//      .
+static int	FlashWrite(const TDescRec* rec)
+{const uint32_t*	src  = (const uint32_t*)rec	;
+ uint32_t			addr = (uint32_t)Slot(FlashUsed), ix	;
+ int				ok	;
+
+ ok = FLASH_ProgramWord(addr,src[0]) == FLASH_COMPLETE	; FlashUsed++	;
+ for(ix=1;ok && ix < sizeof(*rec)/4;ix++) ok = FLASH_ProgramWord(addr + ix*4,src[ix]) == FLASH_COMPLETE	;
+ return ok	;}
+//===============================================
+//   -   (~1 ,  )   ,   RAM.
+static void	FlashPut(const TDescRec* rec)
+{uint32_t	ix		;
+ int		ok = 1	;
+
+ FLASH_Unlock()	;
+ FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)	;
+ if(FlashUsed >= DESCC_SLOTS){
+   ok = FLASH_EraseSector(DESCC_SECTOR,VoltageRange_3) == FLASH_COMPLETE	;
+   FlashUsed = 0	; DescCacheStat.CntErase++	;
+   for(ix=0;ok && ix<DESCC_RAM_CNT;ix++) if(Ram + ix != rec && Ram[ix].Sign == DESCC_SIGN) ok = FlashWrite(Ram + ix)	;}
+ if(ok) ok = FlashWrite(rec)	;
+ FLASH_Lock()	;
+
+ DescCacheStat.CntFlash = FlashUsed	;
+ if(!ok) LOG_W(LOG_USBH,"DescCache: flash err, %u\n",FlashUsed)	;}
+//===============================================
+//   flash ,  DescCacheDrop: Crc := 0 ( 1->0,
+//  ),   .
+static void	FlashKill(void)
+{uint32_t	ix		;
+ int		ok = 1	;
+
+ Kill = 0	;
+ FLASH_Unlock()	;
+ FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)	;
+ for(ix=0;ix<FlashUsed;ix++)
+   if(RecIs(Slot(ix),&KillDev,KillHash))
+	 ok &= FLASH_ProgramWord((uint32_t)&Slot(ix)->Crc,DESCC_DEAD) == FLASH_COMPLETE	;
+ FLASH_Lock()	;
+ if(!ok) LOG_W(LOG_USBH,"DescCache: %04X:%04X flash err on drop\n",KillDev.idVendor,KillDev.idProduct)	;}
+//===============================================
+//  - ,   ,  , - .
+//  main: FlashPut   .
+void		DescCacheSave(const USBH_Device_TypeDef* prop)
+{TDescRec*	rec = Ram + RamNext	;
+
+ if(Kill) FlashKill()	;
+ if(!Pend) return	;
+ Pend = 0		;
+ RamNext = (RamNext + 1) % DESCC_RAM_CNT		;
+ memset(rec,0,sizeof(*rec))					;//  -   CRC
+ rec->Vid  = prop->Dev_Desc.idVendor			; rec->Pid = prop->Dev_Desc.idProduct	;
+ rec->Bcd  = prop->Dev_Desc.bcdDevice			; rec->Hash = PendHash	;
+ rec->Cfg  = prop->Cfg_Desc						;
+ memcpy(rec->Itf,prop->Itf_Desc,sizeof(rec->Itf))	;
+ memcpy(rec->Ep ,prop->Ep_Desc ,sizeof(rec->Ep ))	;
+ rec->Crc  = MdmDbCrc(0,&rec->Vid,DESCC_CRC_LEN)	;
+ rec->Sign = DESCC_SIGN							;
+ FlashPut(rec)	;}
+//===============================================
+//      :   RAM  ,
+//  flash -  DescCacheSave (  DescCacheLoad  ). 
+//   ,     . 
+// USBH_Process: flash  .  :  Drop  Save
+//   -     .
+void		DescCacheDrop(const USBH_Device_TypeDef* prop)
+{uint32_t	ix	;
+
+ for(ix=0;ix<DESCC_RAM_CNT;ix++) if(RecIs(Ram + ix,&prop->Dev_Desc,PendHash)) Ram[ix].Sign = 0	;
+ KillDev = prop->Dev_Desc	; KillHash = PendHash	; Kill = 1	;
+ Pend = 1	; DescCacheStat.CntDrop++	;
+ LOG_W(LOG_USBH,"DescCache: %04X:%04X rejected\n",prop->Dev_Desc.idVendor,prop->Dev_Desc.idProduct)	;}
+//===============================================
+//   -   .   (  10 
+//   ,  IROM ) -  "",   .
+void		DescCacheInit(void)
+{uint32_t	sign	;
+
+ for(FlashUsed=0;FlashUsed < DESCC_SLOTS;FlashUsed++){
+   sign = Slot(FlashUsed)->Sign	;
+   if(sign == DESCC_FREE) break	;
+   if(sign != DESCC_SIGN){ FlashUsed = DESCC_SLOTS	; break	;}
+ }
+ DescCacheStat.CntFlash = FlashUsed	;
+ LOG_I(LOG_USBH,"DescCache: %u in flash\n",FlashUsed)	;}
+//===============================================
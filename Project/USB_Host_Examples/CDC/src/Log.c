@@ -1,6 +1,221 @@
 #include	"Log.h"
 #include	<stdio.h>
+#include	<stdarg.h>
 #include	<string.h>
+#ifndef		LOG_HOST
+#include	<stm32f4xx.h>
+#else
+#include	<pthread.h>
+#include	<unistd.h>
+#endif
 //===============================================
-TLog	Log = {printf,printf}	;
+//    UART:    ,    EVAL_COM2
+// (USART3 TX)  DMA1 Stream3 Channel4    . 
+//  ( DMA)    .
+//    main   :      
+//      (  LOG_LINE ;
+// LOG_DROP_OLDEST   - , . LogDropOld),
+// DMA    -  ,   .
+//   (LOG_HOST)  DMA -  ,   stdout.
+//===============================================
+#define		LOG_MASK			(LOG_SIZE-1)
+
+#ifndef		LOG_HOST
+#define		LOG_USART			USART3			// EVAL_COM2
+#define		LOG_DMA				DMA1_Stream3
+#define		LOG_DMA_CH			DMA_Channel_4
+#define		LOG_DMA_CLK			RCC_AHB1Periph_DMA1
+#define		LOG_DMA_IRQn		DMA1_Stream3_IRQn
+#define		LOG_DMA_IRQHandler	DMA1_Stream3_IRQHandler
+#define		LOG_DMA_IT_TC		DMA_IT_TCIF3
+#define		LOG_DMA_FLAGS		(DMA_FLAG_TCIF3 | DMA_FLAG_HTIF3 | DMA_FLAG_TEIF3 | DMA_FLAG_DMEIF3 | DMA_FLAG_FEIF3)
+
+#define		LOG_LOCK()			uint32_t pm = __get_PRIMASK()	; __disable_irq()
+#define		LOG_UNLOCK()		if(!pm) __enable_irq()
+#else
+static		pthread_mutex_t		LogMtx = PTHREAD_MUTEX_INITIALIZER	;
+#define		LOG_LOCK()			pthread_mutex_lock(&LogMtx)
+#define		LOG_UNLOCK()		pthread_mutex_unlock(&LogMtx)
+#endif
+//===============================================
+static char				LogBuf[LOG_SIZE]	;
+static uint32_t			LogHead				;// 
+static volatile uint32_t	LogRd			;//  ,  
+static volatile uint32_t	LogLen			;//  , 0 - DMA 
+static char				LogReady			;// LogInit 
+#if	LOG_DROP == LOG_DROP_OLDEST
+static uint32_t			LogRec[LOG_RECS]	;//  ,     ( LogHead)
+static uint32_t			LogRecRd, LogRecWr	;
+#endif
+
+TLog		Log = {LogPrintf,LogPrintf}	;
+TLogStat	LogStat						;
+uint8_t		LogLevel[LOG_MOD_CNT] = {LOG_LEVEL,LOG_LEVEL,LOG_LEVEL,LOG_LEVEL,LOG_LEVEL}	;
+//===============================================
+static void		LogStart(const char* buf,uint32_t len)	;
+//-----------------------------------------------
+//   LOG_LOCK    DMA
+static void		LogKick(void)
+{uint32_t	len = LogHead - LogRd, pos = LogRd & LOG_MASK	;
+
+ if(!LogReady || LogLen || !len) return	;
+ if(len > LOG_SIZE - pos) len = LOG_SIZE - pos	;//   ,  -  
+ LogLen = len						;
+ LogStart(LogBuf + pos,len)			;}
+//-----------------------------------------------
+static void		LogDone(void)
+{
+ LogRd += LogLen	; LogLen = 0	;
+ LogKick()			;}
+//-----------------------------------------------
+#if	LOG_DROP == LOG_DROP_OLDEST
+//    ,       
+//   (LogKick  ) -    . 
+//      ,     
+//     LogRec;      -  
+//   LOG_SIZE ,    .
+static uint32_t	LogDropOld(uint32_t used,uint32_t len)
+{uint32_t	keep = LogRd + LogLen, from, to, ix, n, cnt	;
+
+ while(LogRecRd != LogRecWr && (int32_t)(LogRec[LogRecRd & (LOG_RECS-1)] - keep) < 0) LogRecRd++	;// 
+ if(LogRecRd == LogRecWr) return used	;
+ from = to = LogRec[LogRecRd & (LOG_RECS-1)]	;//  ,   DMA
+ for(ix=LogRecRd+1;ix != LogRecWr && (used - (to - from) + len > LOG_SIZE || LogRecWr - ix + 1 >= LOG_RECS);ix++)
+   to = LogRec[ix & (LOG_RECS-1)]	;
+ n = to - from	; cnt = ix - LogRecRd - 1	;
+ if(!cnt) return used	;
+ for(;to != LogHead;to++,from++) LogBuf[from & LOG_MASK] = LogBuf[to & LOG_MASK]	;
+ for(;ix != LogRecWr;ix++) LogRec[(ix - cnt) & (LOG_RECS-1)] = LogRec[ix & (LOG_RECS-1)] - n	;
+ LogRecWr -= cnt	; LogHead -= n	;
+ LogStat.CntDrop += n	; LogStat.CntLost += cnt	;
+ return used - n	;}
+#endif
+//-----------------------------------------------
+//    ,  
+int		LogWrite(const char* buf,int len)
+{uint32_t	used, pos, n	;
+ LOG_LOCK()	;
+
+ if(len <= 0){ LOG_UNLOCK()	; return 0	;}
+ used = LogHead - LogRd	;
+#if	LOG_DROP == LOG_DROP_OLDEST
+ if(used + len > LOG_SIZE || LogRecWr - LogRecRd >= LOG_RECS) used = LogDropOld(used,len)	;
+ if(used + len > LOG_SIZE || LogRecWr - LogRecRd >= LOG_RECS){ LogStat.CntDrop += len	; LogStat.CntLost++	; LOG_UNLOCK()	; return 0	;}
+#else
+ if(used + len > LOG_SIZE){ LogStat.CntDrop += len	; LogStat.CntLost++	; LOG_UNLOCK()	; return 0	;}
+#endif
+
+ pos = LogHead & LOG_MASK	; n = LOG_SIZE - pos	;
+ if((uint32_t)len <= n) memcpy(LogBuf + pos,buf,len)	;
+ else{ memcpy(LogBuf + pos,buf,n)	; memcpy(LogBuf,buf + n,len - n)	;}
+ LogHead += len	; used += len	;
+#if	LOG_DROP == LOG_DROP_OLDEST
+ LogRec[LogRecWr++ & (LOG_RECS-1)] = LogHead	;
+#endif
+ if(used > LogStat.MaxUsed) LogStat.MaxUsed = used	;
+ LogKick()		;
+
+ LOG_UNLOCK()	;
+#if	LOG_SWO && !defined(LOG_HOST)
+ if((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) && (ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & 1))
+   for(n=0;n<(uint32_t)len;n++) ITM_SendChar(buf[n])	;
+#endif
+ return len	;}
+//-----------------------------------------------
+int		LogPrintf(const char* fmt,...)
+{char		line[LOG_LINE]	;
+ va_list	args			;
+ int		len				;
+
+ va_start(args,fmt)	;
+ len = vsnprintf(line,sizeof(line),fmt,args)	;
+ va_end(args)		;
+ if(len >= (int)sizeof(line)){ len = sizeof(line)-1	; LogStat.CntLost++	;}
+ return LogWrite(line,len)	;}
+//-----------------------------------------------
+int		LogEmpty(void)
+{
+ return LogHead == LogRd	;}
+//===============================================
+#ifndef		LOG_HOST
+//-----------------------------------------------
+void	LogInit(void)
+{DMA_InitTypeDef	DMA_InitStructure	;
+ NVIC_InitTypeDef	NVIC_InitStructure	;
+
+ RCC_AHB1PeriphClockCmd(LOG_DMA_CLK,ENABLE)	;
+ DMA_DeInit(LOG_DMA)						;
+ DMA_InitStructure.DMA_Channel            = LOG_DMA_CH				;
+ DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&LOG_USART->DR	;
+ DMA_InitStructure.DMA_Memory0BaseAddr    = (uint32_t)LogBuf		;
+ DMA_InitStructure.DMA_DIR                = DMA_DIR_MemoryToPeripheral	;
+ DMA_InitStructure.DMA_BufferSize         = 1						;
+ DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable	;
+ DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable	;
+ DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte	;
+ DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte	;
+ DMA_InitStructure.DMA_Mode               = DMA_Mode_Normal			;
+ DMA_InitStructure.DMA_Priority           = DMA_Priority_Low		;
+ DMA_InitStructure.DMA_FIFOMode           = DMA_FIFOMode_Disable	;
+ DMA_InitStructure.DMA_FIFOThreshold      = DMA_FIFOThreshold_Full	;
+ DMA_InitStructure.DMA_MemoryBurst        = DMA_MemoryBurst_Single	;
+ DMA_InitStructure.DMA_PeripheralBurst    = DMA_PeripheralBurst_Single	;
+ DMA_Init(LOG_DMA,&DMA_InitStructure)		;
+ DMA_ITConfig(LOG_DMA,DMA_IT_TC,ENABLE)		;
+
+ NVIC_InitStructure.NVIC_IRQChannel = LOG_DMA_IRQn	;
+ NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2	;//  TIM4  USB
+ NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0	;
+ NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE		;
+ NVIC_Init(&NVIC_InitStructure)						;
+
+ USART_DMACmd(LOG_USART,USART_DMAReq_Tx,ENABLE)		;
+ {LOG_LOCK()	; LogReady = 1	; LogKick()	; LOG_UNLOCK()	;}// ,    LogInit
+}
+//-----------------------------------------------
+static void		LogStart(const char* buf,uint32_t len)
+{
+ DMA_ClearFlag(LOG_DMA,LOG_DMA_FLAGS)		;
+ LOG_DMA->M0AR = (uint32_t)buf				;
+ LOG_DMA->NDTR = len						;
+ DMA_Cmd(LOG_DMA,ENABLE)					;}
+//-----------------------------------------------
+void	LOG_DMA_IRQHandler(void)
+{
+ if(DMA_GetITStatus(LOG_DMA,LOG_DMA_IT_TC) != RESET){
+   DMA_ClearITPendingBit(LOG_DMA,LOG_DMA_IT_TC)	;
+   LogDone()	;}
+}
+//-----------------------------------------------
+#else
+//-----------------------------------------------
+void			(*LogHostOut)(const char* buf,uint32_t len)	;
+static const char*	LogHostBuf	;
+static uint32_t		LogHostLen	;
+//-----------------------------------------------
+static void*	LogHostDma(void* arg)
+{const char*	buf	;
+ uint32_t		len	;
+
+ for(;;){
+   pthread_mutex_lock(&LogMtx)	; buf = LogHostBuf	; len = LogHostLen	; LogHostLen = 0	; pthread_mutex_unlock(&LogMtx)	;
+   if(!len){ usleep(100)	; continue	;}
+   if(LogHostOut) LogHostOut(buf,len)	;//   ,  LogLen != 0
+   else{ fwrite(buf,1,len,stdout)	; fflush(stdout)	;}
+   pthread_mutex_lock(&LogMtx)	; LogDone()	; pthread_mutex_unlock(&LogMtx)	;
+ }
+ return arg	;}
+//-----------------------------------------------
+void	LogInit(void)
+{pthread_t	th	;
+
+ pthread_create(&th,0,LogHostDma,0)	;
+ pthread_detach(th)					;
+ LOG_LOCK()	; LogReady = 1	; LogKick()	; LOG_UNLOCK()	;}
+//-----------------------------------------------
+static void		LogStart(const char* buf,uint32_t len)
+{
+ LogHostBuf = buf	; LogHostLen = len	;}
+//-----------------------------------------------
+#endif
 //===============================================
@@ -0,0 +1,104 @@
+//-------------------------------------------------
+#include	"Clock.h"
+#include	"EventQueue.h"
+//-------------------------------------------------
+#define		DWT_CTRL			(*(volatile uint32_t*)0xE0001000)	//   CMSIS  DWT
+#define		DWT_CYCCNT			(*(volatile uint32_t*)0xE0001004)
+#define		DWT_CYCCNTENA		0x00000001
+//-------------------------------------------------
+void	TClock::Init(void)
+{TIM_TimeBaseInitTypeDef	TIM_TimeBaseStructure	;
+ NVIC_InitTypeDef			NVIC_InitStructure		;
+ uint32_t					psc = (SystemCoreClock/1000000)*(1000 >> CLK_SHIFT)	;//   / 8
+
+ RCC_APB1PeriphClockCmd(CLK_RCC_TIM,ENABLE)			;
+
+ NVIC_InitStructure.NVIC_IRQChannel = CLK_TIM_IRQn	;
+ NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1	;
+ NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1	;
+ NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE		;
+ NVIC_Init(&NVIC_InitStructure)						;
+
+ TIM_DeInit(CLK_TIM)								;
+ TIM_TimeBaseStructure.TIM_Prescaler         = psc - 1	;
+ TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up	;
+ TIM_TimeBaseStructure.TIM_Period            = 0xFFFF	;//  , CC1 - 
+ TIM_TimeBaseStructure.TIM_ClockDivision     = 0x0		;
+ TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0		;
+ TIM_TimeBaseInit(CLK_TIM,&TIM_TimeBaseStructure)	;
+
+ CycTick = (psc*2) << CLK_SHIFT						;//  APB1   SystemCoreClock/2
+ CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk		;
+ DWT_CTRL |= DWT_CYCCNTENA							;
+ WinTick = 0	; WinCyc = DWT_CYCCNT	; SleepCyc = 0	;
+
+ TIM_ClearITPendingBit(CLK_TIM,TIM_IT_Update | TIM_IT_CC1)	;
+ TIM_ITConfig(CLK_TIM,TIM_IT_Update,ENABLE)			;
+ TIM_Cmd(CLK_TIM,ENABLE)							;}
+//-------------------------------------------------
+//   ,      (,
+//        ) -     .
+uint32_t	TClock::Now(void)
+{uint32_t	hi, cnt, sr	;
+
+ do{ hi = Hi	; cnt = CLK_TIM->CNT	; sr = CLK_TIM->SR	;
+ }while(hi != Hi)	;
+ if((sr & TIM_IT_Update) && cnt < 0x8000) hi++	;
+ return (hi << (16-CLK_SHIFT)) | (cnt >> CLK_SHIFT)	;}
+//-------------------------------------------------
+//     : evTick   .
+//  16-  - CC1  , OnIRQ()   .
+void	TClock::Wake(uint32_t due)
+{uint32_t	pm = __get_PRIMASK(), now	;
+
+ __disable_irq()	;
+ if(!Armed || (int32_t)(due - Due) < 0){
+   Armed = 1	; Due = due	;
+   TIM_ClearITPendingBit(CLK_TIM,TIM_IT_CC1)		;
+   TIM_ITConfig(CLK_TIM,TIM_IT_CC1,ENABLE)			;
+   do{ now = Now()	;
+     if((int32_t)(Due - now) <= 0) Due = now + 1	;
+     TIM_SetCompare1(CLK_TIM,(uint16_t)(Due << CLK_SHIFT))	;
+   }while((int32_t)(Due - Now()) <= 0)				;//  ,  
+ }
+ if(!pm) __enable_irq()	;}
+//-------------------------------------------------
+//    WFI:     
+//    , WFI    .
+void	TClock::Idle(void)
+{uint32_t	cyc, now, win	;
+
+ __disable_irq()	;
+ if(EvQueue.Empty()){ cyc = DWT_CYCCNT	; __DSB()	; __WFI()	; SleepCyc += DWT_CYCCNT - cyc	;}
+ __enable_irq()		;
+
+ now = Now()	; win = now - WinTick	;
+ if(win < CLK_BUSY_WIN) return	;
+ cyc = DWT_CYCCNT - WinCyc - SleepCyc	;// CYCCNT     
+ if(win < 0x10000){ win *= CycTick/100	; Busy = (uint8_t)(cyc/win < 100 ? cyc/win : 100)	;}
+ WinTick = now	; WinCyc = DWT_CYCCNT	; SleepCyc = 0	;}
+//-------------------------------------------------
+//       !!!!!
+void	TClock::OnIRQ(void)
+{uint32_t	now	;
+
+ if(TIM_GetITStatus(CLK_TIM,TIM_IT_Update) != RESET){
+   TIM_ClearITPendingBit(CLK_TIM,TIM_IT_Update)	; Hi++	;}
+
+ if(TIM_GetITStatus(CLK_TIM,TIM_IT_CC1) != RESET){
+   TIM_ClearITPendingBit(CLK_TIM,TIM_IT_CC1)		;
+   now = Now()	;
+   if(Armed && (int32_t)(now - Due) >= 0){
+     if(EvQueue.PostOnce(evTick)){ Armed = 0	; TIM_ITConfig(CLK_TIM,TIM_IT_CC1,DISABLE)	;}
+     else{ Due = now + 1	; TIM_SetCompare1(CLK_TIM,(uint16_t)(Due << CLK_SHIFT))	;}//  evTick   
+   }
+ }
+}
+//-------------------------------------------------
+#ifdef __cplusplus
+ extern "C"
+#endif
+void	CLK_TIM_IRQHandler(void)
+{
+ Clock.OnIRQ()	;}
+//-------------------------------------------------
@@ -0,0 +1,45 @@
+#ifndef	CLOCK_H
+#define	CLOCK_H
+//-------------------------------------------------
+#include	<stm32f4xx.h>
+//-------------------------------------------------
+#define		CLK_TIM				TIM4
+#define		CLK_RCC_TIM			RCC_APB1Periph_TIM4
+#define		CLK_TIM_IRQn		TIM4_IRQn
+#define		CLK_TIM_IRQHandler	TIM4_IRQHandler
+#define		CLK_SHIFT			3		// 8    
+#define		CLK_BUSY_WIN		512		//   ,  (~1 )
+#ifndef		CLK_TICK_MS
+#define		CLK_TICK_MS			2		//  Now(): 8  TIM4  0.25 ;   - 1
+#endif
+#define		CLK_MS(ms)			((uint32_t)(ms)/CLK_TICK_MS)	//  ->  ()
+#define		CLK_TO_MS(t)		((uint32_t)(t)*CLK_TICK_MS)		//  -> 
+//-------------------------------------------------
+//     (tickless). TIM4  ,
+//    , Now() -   CLK_TICK_MS  (
+//  TIM_MS);    -  CLK_MS().    CC1
+//  Wake()      evTick;   
+//   WFI (Idle()).
+// : DWT->CYCCNT     WFI    .
+class	TClock{
+ volatile uint32_t	Hi							;//  TIM4
+ volatile uint32_t	Due							;// , 
+ volatile char		Armed						;
+ uint32_t			CycTick						;//    
+ uint32_t			WinTick,WinCyc,SleepCyc		;//   
+ uint8_t			Busy						;// %
+public:
+   TClock(void){ Hi = Due = 0	; Armed = 0	; Busy = 0	;}
+
+ void		Init(void)							;
+ uint32_t	Now(void)							;// 
+ void		Wake(uint32_t due)					;// evTick   due ()
+ void		Idle(void)							;// ,   
+ uint8_t	GetBusy(void){ return Busy			;}//  , %
+ void		OnIRQ(void)							;
+};
+//-------------------------------------------------
+extern	TClock			Clock					;
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
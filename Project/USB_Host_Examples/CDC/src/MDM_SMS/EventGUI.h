@@ -18,7 +18,10 @@ typedef	EVENT_TYPE	(*ON_EVENT)(EVENT_TYPE EvType)	;
 enum	{KeyDemoLED,
 		 evGetEvent,evClearPswGSM,evEventSMS,evUseFake,evDistantion,
 		 evDbgMsg1,evDbgMsg2,evStat1,evStat2,evStat3,evStat4,
-		 evStartP,evStopP,evGsmInitOK,
+		 evStartP,evStopP,evGsmInitOK,evUsbStat,
+		 evTick,evUsbIrq,							//   (EvQueue.PostOnce)
+		 evGsmRx,									//    
+		 evGsmTimeOut,evLed,						//   (Timers)
 		 KeyNA};
 //--------------------------------------------------------------
 struct	TEvent{
@@ -0,0 +1,88 @@
+//-------------------------------------------------
+#include	<stm32f4xx.h>
+#include	"EventQueue.h"
+//-------------------------------------------------
+// *ptr: old -> val,      ( .. )
+static int		Cas(volatile uint32_t* ptr,uint32_t old,uint32_t val)
+{
+ do{ if(__LDREXW(ptr) != old){ __CLREX()	; return 0	;}
+ }while(__STREXW(val,ptr))	;
+ return 1	;}
+//-------------------------------------------------
+static void		AtomicInc(volatile uint32_t* ptr)
+{uint32_t	val	;
+
+ do val = *ptr	; while(!Cas(ptr,val,val+1))	;}
+//-------------------------------------------------
+static void		AtomicClr(volatile uint32_t* ptr,uint32_t mask)
+{uint32_t	val	;
+
+ do val = *ptr	; while((val & mask) && !Cas(ptr,val,val & ~mask))	;}
+//-------------------------------------------------
+void	TEventQueue::Reset(void)
+{int	ix	;
+
+ for(ix=0;ix<EVQ_LEN;ix++) Cell[ix].Seq = ix	;
+ Head = Tail = Pend = 0	; CntDrop = CntMax = 0	;}
+//-------------------------------------------------
+int		TEventQueue::Post(EVENT_TYPE type,const char* str,short value)
+{TCell*		cell	;
+ uint32_t	pos		;
+ int32_t	dif		;
+
+ for(;;){
+   pos  = Head	; cell = Cell + (pos & (EVQ_LEN-1))	;
+   dif  = (int32_t)(cell->Seq - pos)				;
+   if(dif < 0){ AtomicInc(&CntDrop)	; return 0	;}// 
+   if(dif == 0 && Cas(&Head,pos,pos+1)) break		;//  
+ }
+
+ cell->Ev.Type  = type	; cell->Ev.Value = value	;
+ cell->Ev.strData[0] = (char*)str	; cell->Ev.strData[1] = 0	;
+ __DMB()				;//   ,  
+ cell->Seq = pos + 1	;
+ return 1	;}
+//-------------------------------------------------
+int		TEventQueue::PostOnce(EVENT_TYPE type)
+{uint32_t	bit = 1u << (type & 31), val	;
+
+ do{ val = __LDREXW(&Pend)	;
+   if(val & bit){ __CLREX()	; return 0	;}			 //   
+ }while(__STREXW(val | bit,&Pend))	;
+
+ if(Post(type)) return 1	;
+ AtomicClr(&Pend,bit)		;
+ return 0	;}
+//-------------------------------------------------
+int		TEventQueue::Get(TEvent* ev)
+{TCell*		cell = Cell + (Tail & (EVQ_LEN-1))	;
+
+ if((int32_t)(cell->Seq - (Tail+1)) < 0) return 0	;//    
+ __DMB()					;
+ *ev = cell->Ev				;
+ __DMB()					;//  ,    
+ cell->Seq = Tail + EVQ_LEN	; Tail++	;
+ return 1	;}
+//-------------------------------------------------
+int		TEventQueue::Subscribe(EVENT_TYPE type,TEvHandler fn)
+{
+ if(!fn || CntSub >= EVQ_SUB_CNT) return 0	;
+ Sub[CntSub].Type = type	; Sub[CntSub].Fn = fn	; CntSub++	;
+ return 1	;}
+//-------------------------------------------------
+//     .  PostOnce  
+// : ,     (  
+// FIFO,    ),   ,   .
+int		TEventQueue::Dispatch(void)
+{TEvent		ev		;
+ uint32_t	depth = Head - Tail	;
+ int		ix, cnt = 0	;
+
+ if(depth > CntMax) CntMax = depth	;
+ while(Get(&ev)){
+   if(ev.Type < 32) AtomicClr(&Pend,1u << ev.Type)	;
+   for(ix=0;ix<CntSub;ix++) if(Sub[ix].Type == ev.Type) Sub[ix].Fn(&ev)	;
+   cnt++	;
+ }
+ return cnt	;}
+//-------------------------------------------------
@@ -0,0 +1,55 @@
+#ifndef	EVENT_QUEUE_H
+#define	EVENT_QUEUE_H
+//-------------------------------------------------
+#include	<stdint.h>
+#include	"EventGUI.h"
+//-------------------------------------------------
+#define		EVQ_LEN				32		//   ,  !
+#define		EVQ_SUB_CNT			16		// 
+//-------------------------------------------------
+typedef	void	(*TEvHandler)(TEvent* Event)	;
+//-------------------------------------------------
+struct	TEvSub{
+ EVENT_TYPE			Type						;
+ TEvHandler			Fn							;
+};
+//-------------------------------------------------
+//     /   (MPSC),   .
+//  (Post, PostOnce)       main,  
+// Dispatch()  main.    Seq ( ):  
+//   Head  LDREX/STREX,     
+//  Seq -     ,  .
+// PostOnce() -    (,  USB):   
+//     (Dispatch    ),   .  
+// PostOnce -  32.
+class	TEventQueue{
+ struct	TCell{
+   volatile uint32_t	Seq						;
+   TEvent				Ev						;
+ };
+ TCell				Cell[EVQ_LEN]				;
+ volatile uint32_t	Head						;// 
+ uint32_t			Tail						;// 
+ volatile uint32_t	Pend						;//  ,  PostOnce
+ TEvSub				Sub[EVQ_SUB_CNT]			;
+ int				CntSub						;
+
+ int		Get(TEvent* ev)						;
+public:
+ volatile uint32_t	CntDrop						;//  
+ uint32_t			CntMax						;//  
+
+   TEventQueue(void){ CntSub = 0	; Reset()	;}
+
+ void		Reset(void)							;
+ int		Post(EVENT_TYPE type,const char* str=0,short value=0)	;// 0 -  
+ int		PostOnce(EVENT_TYPE type)			;// 0 -     
+ int		Subscribe(EVENT_TYPE type,TEvHandler fn)	;
+ int		Dispatch(void)						;//    
+ int		Empty(void){ return (int32_t)(Cell[Tail & (EVQ_LEN-1)].Seq - (Tail+1)) < 0	;}
+};
+//-------------------------------------------------
+extern	TEventQueue		EvQueue					;
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
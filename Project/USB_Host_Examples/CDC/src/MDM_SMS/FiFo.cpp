@@ -1,41 +1,154 @@
 //-------------------------------------------------
+#include	<string.h>
+#include	<stm32f4xx.h>
 #include	"FiFo.h"
 //-------------------------------------------------
-void	TFiFo::In(char val)
-{if(Buf && Size && Cnt<Size){ Cnt++	;
-   Buf[Head] = val	; Head++	; if(Head>=Size) Head = 0	;}
- else{ Cnt=CntStr=Tail=Head=valPrevIn=0;}//   ,    (  )
- 
- if(Buf && Size && CntStr <= Cnt && 
-		(val=='\n' || (val == '>'&& !valPrevIn))) CntStr++	;//    CR()
- valPrevIn = (val == '\n' || val == '\r') ? 0:val			;
-}
+void	TFiFo::Set(char* buf,int size,callbackIfCR fnIfCR,const char* endS)
+{uint32_t	sz = 1		;
+
+ while(size > 0 && sz*2 <= (uint32_t)size) sz <<= 1	;//     
+ FnIfCR = fnIfCR		; strEndS = endS				;
+ Buf    = (buf && size > 1) ? buf:0					;
+ Mask   = Buf ? sz-1 : 0							;
+ flLine = endS ? 1:0								;
+ CntDrop = CntLineDrop = 0	; Reset()				;}
+//-------------------------------------------------
+//         [head,head+len) ().
+// ,   :  ,     ,
+//       ( )   GetS().
+int		TFiFo::MarkLines(uint32_t head,int len)
+{char	val		;
+ int	ix		;
+
+ for(ix=0;ix<len;ix++,head++){
+   val = Buf[head & Mask]								;
+   if((val == '\n' && flInLine) || (val == '>' && !valPrevIn)){//    
+     if(CntStrIn - CntStrOut >= FIFO_CNT_LINE){
+	   if(!flLineFull){ flLineFull = 1	; CntLineDrop++	;}//    - 
+	   break											;}
+	 LineEnd[CntStrIn & (FIFO_CNT_LINE-1)] = head + 1	;
+	 CntStrIn++	; flLineFull = 0	; flInLine = 0	;
+   }
+   else if(val != '\n' && val != '\r') flInLine = 1	;
+   if(val == '\r' || val == '\n') Buf[head & Mask] = 0	;//      
+   valPrevIn = (val == '\n' || val == '\r') ? 0:val		;
+ }
+ return ix	;}
+//-------------------------------------------------
+//    ( USB).    - 
+//  len,    ( :    ).
+int		TFiFo::Write(const char* src,int len)
+{uint32_t	ix		;
+ int		cnt  = GetFree()		;
+ int		part					;
+
+ if(!Buf || !src || len <= 0) return 0					;
+ if(len > cnt){ CntDrop += len - cnt ; len = cnt		;}//   -  ,   
+
+ ix   = Head & Mask										;
+ part = (int)(Mask + 1 - ix)							;
+ if(part > len) part = len								;
+ memcpy(Buf + ix,src,part)	; memcpy(Buf,src + part,len - part)	;
+
+ return Commit(len)		;}
+//-------------------------------------------------
+//     Head      Tail ().
+//     (USB),  Commit().
+char*	TFiFo::GetWrBuf(int* len)
+{uint32_t	ix   = Head & Mask		;
+ int		cnt  = GetFree()		;
+ int		part = (int)(Mask + 1 - ix)	;
+
+ if(part > cnt) part = cnt			;
+ if(len) *len = part				;
+ return (Buf && part > 0) ? Buf + ix : 0	;}
+//-------------------------------------------------
+int		TFiFo::Commit(int len)
+{uint32_t	head = Head		;
+ int		cnt  = GetFree()	;
+
+ if(!Buf || len <= 0) return 0	;
+ if(len > cnt){ CntDrop += len - cnt ; len = cnt	;}
+
+ if(flLine) len = MarkLines(head,len)	;//   ,    
+ if(!len) return 0		;
+
+ __DMB()				;//    ,   Head
+ Head = head + len		;
+ return len				;}
+//-------------------------------------------------
+//    (main)
+int		TFiFo::Read(char* dst,int len)
+{uint32_t	tail = Tail, ix		;
+ int		cnt  = (int)(Head - tail)	;
+ int		part				;
+
+ if(!Buf || !dst || len <= 0) return 0	;
+ if(len > cnt) len = cnt				;
+ __DMB()								;// Head   
+
+ ix   = tail & Mask						;
+ part = (int)(Mask + 1 - ix)			;
+ if(part > len) part = len				;
+ memcpy(dst,Buf + ix,part)	; memcpy(dst + part,Buf,len - part)	;
+
+ __DMB()				;//   ,   
+ Tail = tail + len		;
+ return len				;}
+//-------------------------------------------------
+//     Tail      Head. 
+// (USB OUT)         Skip().
+char*	TFiFo::GetRdBuf(int* len)
+{uint32_t	ix   = Tail & Mask		;
+ int		cnt  = GetLen()			;
+ int		part = (int)(Mask + 1 - ix)	;
+
+ if(part > cnt) part = cnt			;
+ if(len) *len = part				;
+ __DMB()							;// Head   
+ return (Buf && part > 0) ? Buf + ix : 0	;}
+//-------------------------------------------------
+int		TFiFo::Skip(int len)
+{int	cnt = GetLen()	;
+
+ if(!Buf || len <= 0) return 0	;
+ if(len > cnt) len = cnt			;
+ __DMB()				;//   ,   
+ Tail = Tail + len		;
+ return len				;}
 //-------------------------------------------------
 char	TFiFo::Out(void)
-{char val=0	; 
- if(Buf && Size && Cnt>0){ Cnt--	; 
-   val = Buf[Tail]	; Tail++		; 
-   if(Tail>=Size) Tail = 0			;}
- if(!Cnt) Tail=Head=CntStr=0		;//   ,    ( )
+{char val=0	;
+ Read(&val,1)	;
  return val	;}
 //-------------------------------------------------
-char*	TFiFo::GetS(char* buf,int lenBuf){					//   ,  
- int		ix=0	;
- char		val=0	;
- 
- for(;ix<lenBuf && CntStr>0 && Cnt>0;){
-    valPrevOut = (val == '\n' || val == '\r') ? 0:val	;
-    val = Out()		;
-	if(ix<lenBuf-1 && val != '\n' && val != '\r') buf[ix++] = val		;
-   
-   if(val == '\n' || (val == '>' && !valPrevOut)){
-     buf[ix] = 0						;
-	 if(CntStr>0) CntStr--				;
-	 break	;
-   }
+//    ().    .
+//        -     ,
+//  (   ,  '>')   buf.
+char*	TFiFo::GetS(char* buf,int lenBuf,int* len){			//   ,  
+ uint32_t	start,end	;
+ char*		str = 0		;
+ int		cnt = 0		;
+
+ if(TailNext != Tail){ __DMB()	; Tail = TailNext	;}		//   
+
+ if(flLine && GetCntStr()>0){
+   __DMB()											;
+   start = Tail	; end = LineEnd[CntStrOut & (FIFO_CNT_LINE-1)]	;
+   TailNext = end	; CntStrOut++						;
+
+   while(start != end && !Buf[start & Mask]) start++	;//    
+   while(end != start && !Buf[(end-1) & Mask]) end--	;
+   cnt = (int)(end - start)							;
+
+   if(cnt > 0 && end != TailNext && (start & Mask) < (end & Mask)){
+     str = Buf + (start & Mask)						;}//  ,    0  CR/LF
+   else if(cnt > 0 && buf && lenBuf > 1){
+     for(cnt=0;start != end && cnt < lenBuf-1;start++) buf[cnt++] = Buf[start & Mask]	;
+	 buf[cnt] = 0	; str = buf						;}
+   else cnt = 0										;
  }
- 
- if(!ix) buf = 0	;
- 
- return	buf	;}
+
+ if(len) *len = str ? cnt : 0	;
+ return	str	;}
 //-------------------------------------------------
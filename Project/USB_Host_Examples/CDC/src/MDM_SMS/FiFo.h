@@ -1,39 +1,69 @@
 #ifndef	FIFO_H
 #define	FIFO_H
 //-------------------------------------------------
+#include	<stdint.h>
+//-------------------------------------------------
 typedef	void(*callbackIfCR)(class TFiFo* fifo,int cnt)	;
 //-------------------------------------------------
+#define		FIFO_CNT_LINE		32		//   ,  !  -    GetS()
+//-------------------------------------------------
+//     /   (SPSC),   .
+//  -   (Set()  ),  Head/Tail  
+//    . Head  CntStrIn   ,
+// Tail  CntStrOut -  .
+//   strEndS ( ),      
+//  LineEnd,  CR/LF     0 -   
+//    ,  .     GetS().
+//    - Write()/Commit()      ,
+//      (USB:   InBuff,  IN - NAK).
 class	TFiFo{
 private:
  char*				Buf							;
- short				Size,Tail,Head,Cnt,flCR		;
- char				valPrevIn,valPrevOut		;
+ uint32_t			Mask						;// -1
+ volatile uint32_t	Head,Tail					;// Head - , Tail - 
+ volatile uint32_t	CntStrIn,CntStrOut			;//  /  
+ volatile uint32_t	CntDrop						;//    
+ volatile uint32_t	CntLineDrop					;//   :    
+ uint32_t			LineEnd[FIFO_CNT_LINE]		;//    (Head   )
+ uint32_t			TailNext					;//  ,  
+ char				flLine						;//  
+ char				valPrevIn,flInLine			;// : . ,    
+ char				flLineFull					;// :    
  callbackIfCR		FnIfCR						;
- 
- 
+
+ int	MarkLines(uint32_t head,int len)			;
+
+
 public:
- const char*		strEndS						;//  ,   ' ' 
- int				CntStr						;//   
-   
+ const char*		strEndS						;//  ,   ' '
+
    TFiFo(char* buf=0,int size=0,callbackIfCR fnIfCR=0)
  { Set(buf,size,fnIfCR)	;}
-   
- void	Set(char* buf,int size,callbackIfCR fnIfCR,const char* endS=0)
- {FnIfCR=fnIfCR		; Buf = buf	; Size=size			; 
-  valPrevIn=valPrevOut=0		;
-  Tail=Head=Cnt=CntStr=flCR=0	; strEndS = endS	;}
-  
- void	Reset(void){ Tail=Head=Cnt=CntStr=flCR=0	;}
- void	In(char val);
- char	Out(void)	;
- int	Empty(void){ return Cnt >  0    ? 0:1		;}
- int	Full(void) { return Cnt <= Size ? 0:1		;}
- char*	GetS(char* buf,int lenBuf)					;//   ,  
+
+ void	Set(char* buf,int size,callbackIfCR fnIfCR,const char* endS=0)	;
+
+ void	Reset(void){ Tail=Head=TailNext=CntStrIn=CntStrOut=0	; valPrevIn=flInLine=flLineFull=0	;}//    !
+ void	In(char val){ Write(&val,1)					;}
+ char	Out(void)									;
+ int	Write(const char* src,int len)				;//  ,   
+ int	Read (char* dst,int len)					;//  ,   
+ char*	GetWrBuf(int* len)							;// :   
+ int	Commit(int len)								;// :   GetWrBuf  len ,   
+ char*	GetRdBuf(int* len)							;// :   
+ int	Skip(int len)								;// :  GetRdBuf 
+ int	Empty(void){ return Head != Tail ? 0:1		;}
+ int	Full(void) { return GetFree()    ? 0:1		;}
+ char*	GetS(char* buf,int lenBuf,int* len=0)		;//   ,  
  char*	GetBuf(void){ return Buf					;}//  
- int	GetLen(void){ return Cnt					;}//    ?
+ int	GetLen(void){ return (int)(Head - Tail)		;}//    ?
+ int	GetFree(void){ return Buf ? (int)(Mask + 1 - (Head - Tail)):0	;}
+ int	GetCntStr(void){ return (int)(CntStrIn - CntStrOut)			;}//   
+ uint32_t GetDrop(void){ return CntDrop				;}
+ uint32_t GetLineDrop(void){ return CntLineDrop		;}
 };
 //-------------------------------------------------
 //void	xputs_F(const char* str);
 //-------------------------------------------------
 //-------------------------------------------------
 #endif
+//-------------------------------------------------
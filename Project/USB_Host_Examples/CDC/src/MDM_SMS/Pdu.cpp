@@ -0,0 +1,336 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	"Pdu.h"
+//-------------------------------------------------
+#define		GSM7_ESC			0x1B
+#define		GSM7_EXT			0x100	// :    ESC
+//-------------------------------------------------
+//  GSM   -> CP1251.    CP1251 -     '?'
+static const uint8_t	Gsm7Cp[128]={
+ '@','?','$','?','e','e','u','i','o','C','\n','O','o','\r','A','a',
+ '?','_','?','?','?','?','?','?','?','?','?',GSM7_ESC,'?','?','?','E',
+ ' ','!','"','#',0xA4,'%','&','\'','(',')','*','+',',','-','.','/',
+ '0','1','2','3','4','5','6','7','8','9',':',';','<','=','>','?',
+ '!','A','B','C','D','E','F','G','H','I','J','K','L','M','N','O',
+ 'P','Q','R','S','T','U','V','W','X','Y','Z','A','O','N','U',0xA7,
+ '?','a','b','c','d','e','f','g','h','i','j','k','l','m','n','o',
+ 'p','q','r','s','t','u','v','w','x','y','z','a','o','n','u','a'
+};
+//-------------------------------------------------
+// CP1251 0x80..0xBF -> Unicode (0xC0..0xFF -   U+0410)
+static const uint16_t	CpUni[64]={
+ 0x0402,0x0403,0x201A,0x0453,0x201E,0x2026,0x2020,0x2021,
+ 0x20AC,0x2030,0x0409,0x2039,0x040A,0x040C,0x040B,0x040F,
+ 0x0452,0x2018,0x2019,0x201C,0x201D,0x2022,0x2013,0x2014,
+ 0x003F,0x2122,0x0459,0x203A,0x045A,0x045C,0x045B,0x045F,
+ 0x00A0,0x040E,0x045E,0x0408,0x00A4,0x0490,0x00A6,0x00A7,
+ 0x0401,0x00A9,0x0404,0x00AB,0x00AC,0x00AD,0x00AE,0x0407,
+ 0x00B0,0x00B1,0x0406,0x0456,0x0491,0x00B5,0x00B6,0x00B7,
+ 0x0451,0x2116,0x0454,0x00BB,0x0458,0x0405,0x0455,0x0457
+};
+//-------------------------------------------------
+static const char		HexSmb[] = "0123456789ABCDEF"	;
+//-------------------------------------------------
+static uint8_t	Gsm7Ext(uint8_t c)		//   ESC
+{
+ switch(c){
+   case 0x0A : return '\f'	;
+   case 0x14 : return '^'	;
+   case 0x28 : return '{'	;
+   case 0x29 : return '}'	;
+   case 0x2F : return '\\'	;
+   case 0x3C : return '['	;
+   case 0x3D : return '~'	;
+   case 0x3E : return ']'	;
+   case 0x40 : return '|'	;
+   case 0x65 : return 0x88	;// 
+ }
+ return	Gsm7Cp[c & 0x7F]	;}
+//-------------------------------------------------
+// CP1251 ->  GSM, GSM7_EXT| -  ESC, -1 -   
+static int		CpGsm7(uint8_t ch)
+{
+ if((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')) return ch	;
+ if(ch >= ' ' && ch <= '?' && ch != '$') return ch	;
+ switch(ch){
+   case '\n' : case '\r'	: return ch				;
+   case '@'  : return 0x00	;
+   case '$'  : return 0x02	;
+   case '_'  : return 0x11	;
+   case 0xA4 : return 0x24	;
+   case 0xA7 : return 0x5F	;
+   case '\f' : return GSM7_EXT|0x0A	;
+   case '^'  : return GSM7_EXT|0x14	;
+   case '{'  : return GSM7_EXT|0x28	;
+   case '}'  : return GSM7_EXT|0x29	;
+   case '\\' : return GSM7_EXT|0x2F	;
+   case '['  : return GSM7_EXT|0x3C	;
+   case '~'  : return GSM7_EXT|0x3D	;
+   case ']'  : return GSM7_EXT|0x3E	;
+   case '|'  : return GSM7_EXT|0x40	;
+   case 0x88 : return GSM7_EXT|0x65	;
+ }
+ return	-1	;}
+//-------------------------------------------------
+static uint8_t	UniCp(uint16_t u)
+{int	ix	;
+
+ if(u < 0x80) return (uint8_t)u						;
+ if(u >= 0x0410 && u <= 0x044F) return (uint8_t)(u - 0x0410 + 0xC0)	;// ..
+ for(ix=0;ix<64;ix++) if(CpUni[ix] == u) return (uint8_t)(0x80 + ix)	;
+ return	'?'	;}
+//-------------------------------------------------
+static uint16_t	CpUni16(uint8_t ch)
+{
+ if(ch < 0x80)  return ch						;
+ if(ch >= 0xC0) return (uint16_t)(0x0410 + ch - 0xC0)	;
+ return	CpUni[ch - 0x80]	;}
+//-------------------------------------------------
+static int		HexVal(char ch)
+{
+ if(ch >= '0' && ch <= '9') return ch - '0'	;
+ ch |= 0x20									;
+ if(ch >= 'a' && ch <= 'f') return ch - 'a' + 10	;
+ return	-1	;}
+//-------------------------------------------------
+// HEX ->    ( n     2n,2n+1),   
+static int		HexToBin(char* hex)
+{uint8_t*	bin = (uint8_t*)hex	;
+ int		cnt = 0, hi, lo		;
+
+ for(;;cnt++){
+   if((hi = HexVal(hex[2*cnt])) < 0 || (lo = HexVal(hex[2*cnt+1])) < 0) break	;
+   bin[cnt] = (uint8_t)((hi << 4) | lo)	;
+ }
+ return	cnt	;}
+//-------------------------------------------------
+//  cnt   ud[octets],  skip ( UDH) .
+//  32      ,    7 .
+static int		Unpack7(const uint8_t* ud,int octets,int skip,int cnt,char* dst,int size)
+{uint32_t	acc = 0		;
+ int		bits = 0, ix = 0, sp, n = 0, esc = 0	;
+ uint8_t	c			;
+
+ for(sp=0;sp<cnt;sp++){
+   if(bits < 7){
+     while(bits <= 24 && ix < octets){ acc |= (uint32_t)ud[ix++] << bits	; bits += 8	;}
+     if(bits < 7) break	;}
+   c = (uint8_t)(acc & 0x7F)	; acc >>= 7	; bits -= 7	;
+   if(sp < skip) continue				;
+   if(esc){ esc = 0	; c = Gsm7Ext(c)	;}
+   else if(c == GSM7_ESC){ esc = 1	; continue	;}
+   else c = Gsm7Cp[c]					;
+   if(n < size) dst[n++] = (char)c		;
+ }
+ return	n	;}
+//-------------------------------------------------
+//      fill    (  UDH).
+//   , -1 -    room     .
+static int		Pack7(uint8_t* dst,int room,int fill,const char* text,int len)
+{uint32_t	acc = 0		;
+ int		bits = fill, n = 0, ix, code, cnt	;
+
+ for(ix=0;ix<len;ix++){
+   if((code = CpGsm7((uint8_t)text[ix])) < 0) return -1	;
+   cnt = (code & GSM7_EXT) ? 2:1		;
+   if(cnt == 2){ acc |= (uint32_t)GSM7_ESC << bits	; bits += 7	;}
+   acc |= (uint32_t)(code & 0x7F) << bits	; bits += 7		;
+   while(bits >= 8){
+     if(n >= room) return -1			;
+     dst[n++] = (uint8_t)acc	; acc >>= 8	; bits -= 8	;}
+ }
+ if(bits > 0){ if(n >= room) return -1	; dst[n++] = (uint8_t)acc	;}
+ return	n	;}
+//-------------------------------------------------
+int		TPdu::Septets(const char* text,int len)
+{int	ix, code, cnt = 0	;
+
+ for(ix=0;ix<len;ix++){
+   if((code = CpGsm7((uint8_t)text[ix])) < 0) return -1	;
+   cnt += (code & GSM7_EXT) ? 2:1						;
+ }
+ return	cnt	;}
+//-------------------------------------------------
+//     text     (concat -  UDH ):
+// 7  -         GSM,
+//  UCS2,    . Encode()    .
+int		TPdu::Fit(const char* text,int len,int concat)
+{int	lim7 = concat ? 153:160, limU = concat ? 67:70	;
+ int	n7, sp = 0, code, cnt	;
+
+ for(n7=0;n7<len;n7++){
+   if((code = CpGsm7((uint8_t)text[n7])) < 0) break	;
+   cnt = (code & GSM7_EXT) ? 2:1						;
+   if(sp + cnt > lim7) return n7						;// 7  
+   sp += cnt											;
+ }
+ if(n7 == len) return n7								;
+ if(limU > len) limU = len								;
+ return	limU > n7 ? limU : n7	;}
+//-------------------------------------------------
+// : len -  (), type -  
+static void		DecodeNmbr(const uint8_t* src,int len,uint8_t type,char* dst)
+{int	ix, n = 0, d	;
+
+ if((type & 0x70) == 0x50){					//   - 7 
+   n = Unpack7(src,(len+1)/2,0,len*4/7,dst,PDU_LEN_NMBR-1)	;}
+ else{
+   if((type & 0x70) == 0x10) dst[n++] = '+'	;// 
+   for(ix=0;ix<len && n<PDU_LEN_NMBR-1;ix++){
+     d = (ix & 1) ? (src[ix/2] >> 4) : (src[ix/2] & 0x0F)	;
+     if(d == 0x0F) break						;
+     dst[n++] = d < 10 ? (char)('0' + d) : "*#abc"[(d - 10) % 5]	;
+   }
+ }
+ dst[n] = 0	;}
+//-------------------------------------------------
+//  UDH:   " " (8  16  )
+static void		ParseUDH(const uint8_t* udh,int len,TPduSMS* sms)
+{int	ix = 0, iei, iel	;
+
+ while(ix + 2 <= len){
+   iei = udh[ix]	; iel = udh[ix+1]	; ix += 2	;
+   if(ix + iel > len) break	;
+   if(iei == 0x00 && iel == 3){ sms->Ref = udh[ix]	; sms->Cnt = udh[ix+1]	; sms->Seq = udh[ix+2]	;}
+   if(iei == 0x08 && iel == 4){ sms->Ref = (uint16_t)((udh[ix] << 8) | udh[ix+1])	;
+								sms->Cnt = udh[ix+2]	; sms->Seq = udh[ix+3]	;}
+   ix += iel	;
+ }
+ if(sms->Cnt < 2 || !sms->Seq || sms->Seq > sms->Cnt) sms->Cnt = sms->Seq = 0	;}
+//-------------------------------------------------
+// SCA | FO | OA(len,type,BCD) | PID | DCS | SCTS(7) | UDL | UD
+int		TPdu::Decode(char* hex,TPduSMS* sms)
+{uint8_t*	pdu = (uint8_t*)hex	;
+ int		cnt = HexToBin(hex)	;
+ int		ix, fo, len, dcs, udl, octets, udhl = 0, n	;
+ uint8_t*	ud					;
+
+ memset(sms,0,sizeof(*sms) - sizeof(sms->Text))	; sms->Text[0] = 0	;
+ if(cnt < 1) return 0								;
+ ix = 1 + pdu[0]									;//  SMSC 
+ if(ix + 3 > cnt) return 0							;
+ fo = pdu[ix++]										;
+ if(fo & 0x03) return 0								;//  SMS-DELIVER
+ len = pdu[ix++]									;
+ if(ix + 1 + (len+1)/2 > cnt) return 0				;
+ DecodeNmbr(pdu + ix + 1,len,pdu[ix],sms->Nmbr)		; ix += 1 + (len+1)/2	;
+ if(ix + 10 > cnt) return 0							;// PID DCS SCTS UDL
+ dcs = pdu[ix+1]	; udl = pdu[ix+9]	; ix += 10	;
+ ud  = pdu + ix		; octets = cnt - ix				;
+
+ if(!(dcs & 0x80))			sms->Alph = (dcs >> 2) & 0x03	;//  
+ else if((dcs & 0xF0) == 0xF0) sms->Alph = (dcs & 0x04) ? pdu8BIT : pduGSM7	;
+ else if((dcs & 0xF0) == 0xE0) sms->Alph = pduUCS2				;
+ else						sms->Alph = pduGSM7					;
+ if(sms->Alph > pduUCS2) sms->Alph = pduGSM7					;
+
+ if(fo & 0x40){										 //  UDH
+   if(octets < 1 || (udhl = ud[0] + 1) > octets) return 0	;
+   ParseUDH(ud + 1,udhl - 1,sms)					;}
+
+ if(sms->Alph == pduGSM7){
+   sms->Len = (short)Unpack7(ud,octets,(udhl*8 + 6)/7,udl,sms->Text,PDU_LEN_TEXT)	;}
+ else{
+   if(udl > octets) udl = octets	;
+   ud += udhl	; udl -= udhl		;
+   if(sms->Alph == pduUCS2)
+     for(n=0;n+1<udl && sms->Len<PDU_LEN_TEXT;n+=2) sms->Text[sms->Len++] = (char)UniCp((uint16_t)((ud[n] << 8) | ud[n+1]))	;
+   else
+     for(n=0;n<udl && sms->Len<PDU_LEN_TEXT;n++) sms->Text[sms->Len++] = (char)ud[n]	;
+ }
+ sms->Text[sms->Len] = 0	;
+ return	1	;}
+//-------------------------------------------------
+// SCA=00 ( SIM) | FO | MR | DA | PID | DCS | UDL | UD,   .
+//  - 7 ,       GSM,  UCS2.
+// cnt > 1 -  seq   ref (UDH  8- ).
+int		TPdu::Encode(char* hex,int size,const char* nmbr,const char* text,int len,
+					 uint16_t ref,uint8_t cnt,uint8_t seq)
+{uint8_t	pdu[PDU_LEN_HEX/2]		;
+ int		ix = 0, n, dig = 0, udhl = 0, fill, ucs2	;
+ int		pos, intl = 0					;
+
+ if(!hex || !nmbr || !text || len < 0) return 0		;
+ ucs2 = Septets(text,len) < 0 ? 1:0					;
+
+ pdu[ix++] = 0x00									;// SMSC  SIM
+ pdu[ix++] = (uint8_t)(0x01 | (cnt > 1 ? 0x40:0))	;// SMS-SUBMIT [+UDHI]
+ pdu[ix++] = 0x00									;// MR -  
+ pos = ix	; ix += 2								;//     - 
+ for(;*nmbr;nmbr++){
+   if(*nmbr == '+' && !dig) intl = 1				;
+   if(*nmbr < '0' || *nmbr > '9') continue			;// , '+'
+   if(dig >= 20) return 0							;
+   if(dig & 1) pdu[ix++] |= (uint8_t)((*nmbr - '0') << 4)	;
+   else        pdu[ix]    = (uint8_t)(*nmbr - '0')			;
+   dig++	;
+ }
+ if(!dig) return 0			;
+ if(dig & 1) pdu[ix++] |= 0xF0	;//    - F  
+ pdu[pos]   = (uint8_t)dig	;
+ pdu[pos+1] = intl ? 0x91:0x81	;//  / 
+ pdu[ix++] = 0x00									;// PID
+ pdu[ix++] = ucs2 ? 0x08:0x00						;// DCS
+ pos = ix++											;// UDL - 
+
+ if(cnt > 1){ pdu[ix++] = 5	; pdu[ix++] = 0x00	; pdu[ix++] = 3	;
+			  pdu[ix++] = (uint8_t)ref	; pdu[ix++] = cnt	; pdu[ix++] = seq	; udhl = 6	;}
+
+ if(ucs2){
+   if(udhl + 2*len > 140) return 0					;
+   for(n=0;n<len;n++){ uint16_t u = CpUni16((uint8_t)text[n])	;
+     pdu[ix++] = (uint8_t)(u >> 8)	; pdu[ix++] = (uint8_t)u	;}
+   pdu[pos] = (uint8_t)(udhl + 2*len)				;
+ }
+ else{
+   fill = ((udhl*8 + 6)/7)*7 - udhl*8				;//    
+   if((n = Pack7(pdu + ix,140 - udhl,fill,text,len)) < 0) return 0	;
+   ix += n											;
+   pdu[pos] = (uint8_t)((udhl*8 + 6)/7 + Septets(text,len))	;
+   if(pdu[pos] > 160) return 0						;
+ }
+
+ if(size < 2*ix + 1) return 0						;
+ for(n=0;n<ix;n++){ hex[2*n] = HexSmb[pdu[n] >> 4]	; hex[2*n+1] = HexSmb[pdu[n] & 0x0F]	;}
+ hex[2*ix] = 0	;
+ return	ix - 1	;}
+//-------------------------------------------------
+void	TPduAssm::Reset(void)
+{
+ memset(Slot,0,sizeof(Slot))	; CntDrop = 0	;}
+//-------------------------------------------------
+char*	TPduAssm::Add(TPduSMS* sms,uint32_t time,int* len)
+{TPduSlot*	slot = 0	;
+ int		ix, pos, cnt, need, seq = sms->Seq - 1	;
+
+ if(len) *len = 0		;
+ if(sms->Cnt < 2){ if(len) *len = sms->Len	; return sms->Text	;}// 
+ if(seq >= PDU_PART_MAX){ CntDrop++	; return 0	;}
+
+ for(ix=0;ix<PDU_SLOT_CNT && !slot;ix++)				 //  ?
+   if(Slot[ix].Cnt == sms->Cnt && Slot[ix].Ref == sms->Ref && !strcmp(Slot[ix].Nmbr,sms->Nmbr)) slot = Slot + ix	;
+ if(!slot){												 //    
+   for(slot=Slot,ix=0;ix<PDU_SLOT_CNT;ix++){
+     if(!Slot[ix].Cnt){ slot = Slot + ix	; break	;}
+     if((int32_t)(Slot[ix].Time - slot->Time) < 0) slot = Slot + ix	;}
+   if(slot->Cnt) CntDrop++								;//  
+   strcpy(slot->Nmbr,sms->Nmbr)	; slot->Ref = sms->Ref	;
+   slot->Cnt = sms->Cnt	; slot->Got = 0				;
+ }
+
+ slot->Time = time	; slot->Len[seq] = (uint8_t)sms->Len	;
+ memcpy(slot->Text + seq*PDU_LEN_TEXT,sms->Text,sms->Len)	;
+ slot->Got |= (uint8_t)(1 << seq)						;
+
+ cnt  = slot->Cnt < PDU_PART_MAX ? slot->Cnt : PDU_PART_MAX	;
+ need = (1 << cnt) - 1									;
+ if((slot->Got & need) != need) return 0				;//  
+
+ for(ix=0,pos=0;ix<cnt;ix++){							 //   
+   memmove(slot->Text + pos,slot->Text + ix*PDU_LEN_TEXT,slot->Len[ix])	; pos += slot->Len[ix]	;}
+ slot->Text[pos] = 0	;
+ if(slot->Cnt > PDU_PART_MAX) CntDrop++					;// 
+ slot->Cnt = 0			;//  ,     Add()
+ if(len) *len = pos		;
+ return	slot->Text	;}
+//-------------------------------------------------
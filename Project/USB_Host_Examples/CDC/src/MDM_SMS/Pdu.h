@@ -0,0 +1,63 @@
+#ifndef	PDU_H
+#define	PDU_H
+//-------------------------------------------------
+#include	<stdint.h>
+//-------------------------------------------------
+#define		PDU_LEN_NMBR		24		// "+79231234567"  
+#define		PDU_LEN_TEXT		160		//     (7  -  )
+#define		PDU_LEN_HEX			(2*(12+164)+2)	// SCA + TPDU  HEX,  0  
+#define		PDU_PART_MAX		4		//    ,  
+#define		PDU_SLOT_CNT		3		//    
+//-------------------------------------------------
+enum{
+  pduGSM7		= 0,
+  pdu8BIT		= 1,
+  pduUCS2		= 2
+};
+//-------------------------------------------------
+//        PDU.  -  CP1251.
+struct	TPduSMS{
+ char				Nmbr[PDU_LEN_NMBR]			;//   "+7923..."
+ uint16_t			Ref							;// :  
+ uint8_t			Cnt,Seq						;// : ,   1..Cnt; Cnt=0 - 
+ uint8_t			Alph						;// pduGSM7, pdu8BIT, pduUCS2
+ short				Len							;
+ char				Text[PDU_LEN_TEXT+1]		;
+};
+//-------------------------------------------------
+// / PDU (3GPP TS 23.040): SMS-DELIVER  , SMS-SUBMIT  .
+// 7  -  GSM   (+    ESC),
+// UCS2 -   ,    CP1251.
+class	TPdu{
+public:
+ static int		Decode(char* hex,TPduSMS* sms)	;// hex     ! 0 - 
+ static int		Encode(char* hex,int size,const char* nmbr,const char* text,int len,
+					   uint16_t ref=0,uint8_t cnt=0,uint8_t seq=0)	;//  TPDU  AT+CMGS, 0 - 
+ static int		Septets(const char* text,int len)	;//   7 , -1 -  UCS2
+ static int		Fit(const char* text,int len,int concat)	;//  text    
+};
+//-------------------------------------------------
+//   :     ,    
+//  .  -  ,     .
+struct	TPduSlot{
+ char				Nmbr[PDU_LEN_NMBR]			;
+ uint16_t			Ref							;
+ uint8_t			Cnt,Got						;// Cnt=0 -  , Got -   
+ uint32_t			Time						;//   
+ uint8_t			Len[PDU_PART_MAX]			;
+ char				Text[PDU_PART_MAX*PDU_LEN_TEXT+1]	;
+};
+//-------------------------------------------------
+class	TPduAssm{
+ TPduSlot			Slot[PDU_SLOT_CNT]			;
+ uint32_t			CntDrop						;//  /  
+public:
+   TPduAssm(void){ Reset()	;}
+
+ void		Reset(void)							;
+ char*		Add(TPduSMS* sms,uint32_t time,int* len=0)	;//  ,  ,  0
+ uint32_t	GetDrop(void){ return CntDrop		;}
+};
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
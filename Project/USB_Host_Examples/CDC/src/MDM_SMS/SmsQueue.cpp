@@ -0,0 +1,134 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	"SmsQueue.h"
+#include	"Clock.h"
+//-------------------------------------------------
+#define		SMSQ_TB_TICKS		CLK_MS(SMSQ_TB_PERIOD)		// , 
+#define		SMSQ_TB_FULL		((uint32_t)SMSQ_TB_BURST*SMSQ_TB_TICKS)
+//-------------------------------------------------
+void	TSmsQueue::Reset(uint32_t now)
+{
+ memset(Rec,0,sizeof(Rec))	; memset(Lat,0,sizeof(Lat))	;
+ Credit = SMSQ_TB_FULL		; TimeTB = now	;//   
+ CntMax = CntDrop = CntFail = CntSent = 0	;}
+//-------------------------------------------------
+void	TSmsQueue::Refill(uint32_t now)
+{uint32_t	el = now - TimeTB	;
+
+ if(el > SMSQ_TB_FULL) el = SMSQ_TB_FULL	;
+ Credit += el	; TimeTB = now				;
+ if(Credit > SMSQ_TB_FULL) Credit = SMSQ_TB_FULL	;}
+//-------------------------------------------------
+int		TSmsQueue::GetCnt(void)
+{int	ix, cnt = 0		;
+
+ for(ix=0;ix<SMSQ_LEN;ix++) if(Rec[ix].Nmbr[0]) cnt++	;
+ return cnt	;}
+//-------------------------------------------------
+//   -    ( ,  ),
+//    ; ,  ,  .
+int		TSmsQueue::Put(const char* nmbr,int prio,uint32_t now)
+{TSmsOut*	rec		;
+ int		ix, cnt, ixFree = -1, ixWorst = -1	;
+
+ if(!nmbr || !*nmbr) return 0				;
+ for(ix=0;ix<SMSQ_LEN;ix++){
+   rec = Rec + ix							;
+   if(!rec->Nmbr[0]){ if(ixFree < 0) ixFree = ix	; continue	;}
+   if(rec->Busy) continue					;
+   if(rec->Prio == prio && !strncmp(rec->Nmbr,nmbr,SMSQ_LEN_NMBR-1)) return 1	;//   
+   if(ixWorst < 0 || rec->Prio > Rec[ixWorst].Prio ||
+	  (rec->Prio == Rec[ixWorst].Prio && (int32_t)(rec->TimeIn - Rec[ixWorst].TimeIn) > 0)) ixWorst = ix	;
+ }
+ if(ixFree < 0){
+   CntDrop++								;//   
+   if(ixWorst < 0 || Rec[ixWorst].Prio <= prio) return 0	;
+   ixFree = ixWorst							;}
+
+ rec = Rec + ixFree							;
+ strncpy(rec->Nmbr,nmbr,SMSQ_LEN_NMBR-1)	; rec->Nmbr[SMSQ_LEN_NMBR-1] = 0	;
+ rec->Prio   = (uint8_t)prio	; rec->Try = 0	; rec->Busy = 0	;
+ rec->TimeIn = rec->TimeNext = now			;
+ if((cnt = GetCnt()) > (int)CntMax) CntMax = cnt	;
+ return 1	;}
+//-------------------------------------------------
+//    ,    SMSQ_TB_RESERVE  .
+int		TSmsQueue::Peek(uint32_t now)
+{TSmsOut*	rec		;
+ int		ix, ixBest = -1	;
+ uint32_t	need	;
+
+ Refill(now)		;
+ for(ix=0;ix<SMSQ_LEN;ix++){
+   rec = Rec + ix	;
+   if(!rec->Nmbr[0] || rec->Busy || (int32_t)(now - rec->TimeNext) < 0) continue	;// ,    
+   if(ixBest < 0 || rec->Prio < Rec[ixBest].Prio ||
+	  (rec->Prio == Rec[ixBest].Prio && (int32_t)(rec->TimeIn - Rec[ixBest].TimeIn) < 0)) ixBest = ix	;
+ }
+ if(ixBest < 0) return -1	;
+
+ need = SMSQ_TB_TICKS * (Rec[ixBest].Prio == smsPrioAlarm ? 1 : 1+SMSQ_TB_RESERVE)	;
+ if(Credit < need) return -1	;
+ return ixBest	;}
+//-------------------------------------------------
+int		TSmsQueue::Get(uint32_t now)
+{int	ix = Peek(now)	;
+
+ if(ix < 0) return -1	;
+ Credit -= SMSQ_TB_TICKS	; Rec[ix].Busy = 1	;
+ return ix	;}
+//-------------------------------------------------
+//  ,  Get() - :     .
+//    -     Done().
+int32_t		TSmsQueue::GetWait(uint32_t now)
+{TSmsOut*	rec		;
+ int		ix		;
+ int32_t	wait, best = -1	;
+ uint32_t	need	;
+
+ Refill(now)		;
+ for(ix=0;ix<SMSQ_LEN;ix++){
+   rec = Rec + ix	;
+   if(!rec->Nmbr[0] || rec->Busy) continue	;
+   wait = (int32_t)(rec->TimeNext - now)	; if(wait < 0) wait = 0	;
+   need = SMSQ_TB_TICKS * (rec->Prio == smsPrioAlarm ? 1 : 1+SMSQ_TB_RESERVE)	;
+   if(Credit < need && (int32_t)(need - Credit) > wait) wait = (int32_t)(need - Credit)	;
+   if(best < 0 || wait < best) best = wait	;
+ }
+ return best	;}
+//-------------------------------------------------
+int		TSmsQueue::Done(int ix,int ok,uint32_t now)
+{TSmsOut*	rec = GetRec(ix)	;
+ int		lat = -1, bin = 0	;
+
+ if(!rec) return -1				;
+ rec->Busy = 0					;
+
+ if(ok){ lat = (int)CLK_TO_MS(now - rec->TimeIn)	; rec->Nmbr[0] = 0	; CntSent++	;
+   while(bin < SMSQ_LAT_CNT-1 && ((uint32_t)lat >> (bin+1))) bin++	;
+   Lat[bin]++	;}
+ else if(++rec->Try >= SMSQ_TRY_MAX){ rec->Nmbr[0] = 0	; CntFail++	;}
+ else rec->TimeNext = now + (CLK_MS(SMSQ_BACKOFF) << (rec->Try-1))	;// 10, 20, 40 
+
+ return lat	;}
+//-------------------------------------------------
+//    ,  USB:  Try,    ,   
+// (    -  ,  ).
+void	TSmsQueue::Undo(int ix)
+{TSmsOut*	rec = GetRec(ix)	;
+
+ if(rec) rec->Busy = 0	;}
+//-------------------------------------------------
+uint32_t	TSmsQueue::GetLat(int pct)
+{uint32_t	total = 0, need, acc = 0	;
+ int		ix		;
+
+ for(ix=0;ix<SMSQ_LAT_CNT;ix++) total += Lat[ix]	;
+ if(!total) return 0	;
+
+ need = (total*pct + 99)/100	;
+ for(ix=0;ix<SMSQ_LAT_CNT-1;ix++){
+   acc += Lat[ix]	;
+   if(acc >= need) break	;}
+ return (2u << ix) - 1	;}
+//-------------------------------------------------
@@ -0,0 +1,65 @@
+#ifndef	SMS_QUEUE_H
+#define	SMS_QUEUE_H
+//-------------------------------------------------
+#include	<stdint.h>
+//-------------------------------------------------
+#define		SMSQ_LEN			8		//    
+#define		SMSQ_LEN_NMBR		20		// "\"+79231234567\""  
+#define		SMSQ_TRY_MAX		4		//    ,  
+#define		SMSQ_BACKOFF		10000	//   1- , ,  x2
+#define		SMSQ_TB_PERIOD		20000	//       
+#define		SMSQ_TB_BURST		3		//    -  
+#define		SMSQ_TB_RESERVE		1		//   -  
+#define		SMSQ_LAT_CNT		20		//  : [2^i,2^(i+1)) 
+//-------------------------------------------------
+enum{
+  smsPrioAlarm	= 0,					//  (start/stop, )  MasterNmbr
+  smsPrioReply	= 1,					//   -
+  smsPrioInfo	= 2,					// .   
+  smsPrioCnt
+};
+//-------------------------------------------------
+struct	TSmsOut{
+ char				Nmbr[SMSQ_LEN_NMBR]			;// Nmbr[0]=0 -  
+ uint8_t			Prio,Try					;
+ uint8_t			Busy						;//  ,  Done()
+ uint32_t			TimeIn						;//   ( )
+ uint32_t			TimeNext					;//    ()
+};
+//-------------------------------------------------
+//   :  ,    
+// ,   -  .        
+//   .   -    . 
+// Get()   (Busy)  Done() -    .
+//   " " (token bucket):   SMSQ_TB_PERIOD ,
+//     SMSQ_TB_BURST;    .
+//  -  ,  (now) -  Clock,  CLK_MS;   -
+//  ,   0  .
+class	TSmsQueue{
+ TSmsOut			Rec[SMSQ_LEN]				;
+ uint32_t			Credit,TimeTB				;// :  ,  
+ uint32_t			Lat[SMSQ_LAT_CNT]			;//   ->
+
+ void		Refill(uint32_t now)				;
+public:
+ uint32_t			CntMax						;//  
+ uint32_t			CntDrop						;//   / 
+ uint32_t			CntFail						;//  
+ uint32_t			CntSent						;
+
+   TSmsQueue(void){ Reset(0)	;}
+
+ void		Reset(uint32_t now)					;
+ int		Put(const char* nmbr,int prio,uint32_t now)	;// 0 -  
+ int		Peek(uint32_t now)					;//  ,    ( ), -1 - 
+ int		Get(uint32_t now)					;//  ,        Done()
+ TSmsOut*	GetRec(int ix){ return (ix >= 0 && ix < SMSQ_LEN && Rec[ix].Nmbr[0]) ? Rec + ix : 0	;}
+ int		Done(int ix,int ok,uint32_t now)	;//  ,   ()  
+ void		Undo(int ix)						;//    ( ) -   
+ int		GetCnt(void)						;//  
+ int32_t	GetWait(uint32_t now)				;//       , -1 - 
+ uint32_t	GetLat(int pct)						;//  ,  (  )
+};
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,53 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	"SmsSched.h"
+//-------------------------------------------------
+int		TSmsSched::Add(void)
+{
+ if(Cnt >= SCHED_MDM_MAX) return -1	;
+ memset(Mdm + Cnt,0,sizeof(Mdm[0]))	; Mdm[Cnt].Ix = -1	;
+ return Cnt++	;}
+//-------------------------------------------------
+//     (  USB) -     
+//        .
+void	TSmsSched::SetUp(int id,int up)
+{TSchedMdm*	mdm	;
+
+ if(id < 0 || id >= Cnt) return	;
+ mdm = Mdm + id	; mdm->Up = (char)up	; mdm->Fail = 0	;
+ if(!up){ mdm->Idle = 0	;
+   if(mdm->Ix >= 0){ Queue.Undo(mdm->Ix)	; mdm->Ix = -1	;}}
+}
+//-------------------------------------------------
+void	TSmsSched::SetIdle(int id,int idle)
+{
+ if(id >= 0 && id < Cnt) Mdm[id].Idle = (char)idle	;}
+//-------------------------------------------------
+//  -     (Peek),     .
+//   TimeTake    .
+int		TSmsSched::Take(int id,uint32_t now)
+{int	ix, best = -1	;
+
+ if(id < 0 || id >= Cnt) return -1	;
+ Mdm[id].Idle = 1	;
+ if(!IsFree(id) || Queue.Peek(now) < 0) return -1	;
+
+ for(ix=0;ix<Cnt;ix++)
+   if(IsFree(ix) && (best < 0 || (int32_t)(Mdm[ix].TimeTake - Mdm[best].TimeTake) < 0)) best = ix	;
+ if(best != id) return SCHED_TURN	;
+
+ Mdm[id].Ix = Queue.Get(now)	; Mdm[id].TimeTake = now	;
+ return Mdm[id].Ix	;}
+//-------------------------------------------------
+int		TSmsSched::Done(int id,int ok,uint32_t now)
+{TSchedMdm*	mdm	;
+ int		lat	;
+
+ if(id < 0 || id >= Cnt || Mdm[id].Ix < 0) return -1	;
+ mdm = Mdm + id	;
+ lat = Queue.Done(mdm->Ix,ok,now)	; mdm->Ix = -1	;
+ if(ok){ mdm->CntSent++	; mdm->Fail = 0	;}
+ else{ mdm->CntFail++	;
+   if(++mdm->Fail >= SCHED_FAIL_MAX){ mdm->Up = 0	; mdm->Idle = 0	;}}
+ return lat	;}
+//-------------------------------------------------
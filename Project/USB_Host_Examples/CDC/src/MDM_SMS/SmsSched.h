@@ -0,0 +1,44 @@
+#ifndef	SMS_SCHED_H
+#define	SMS_SCHED_H
+//-------------------------------------------------
+#include	<stdint.h>
+#include	"SmsQueue.h"
+//-------------------------------------------------
+#define		SCHED_MDM_MAX		4		//    
+#define		SCHED_FAIL_MAX		3		//    -  
+#define		SCHED_TURN			-2		// Take():  ,    
+//-------------------------------------------------
+struct	TSchedMdm{
+ char				Up							;//  ,  
+ char				Idle						;//  ( Poll),  
+ char				Fail						;//  
+ int				Ix							;//  ,  , -1 - 
+ uint32_t			TimeTake					;//     
+ uint32_t			CntSent,CntFail				;
+};
+//-------------------------------------------------
+//      .      
+// ,      (round-robin);  Take() 
+// SCHED_TURN -    (evGsmRx),   . 
+// () - :   ,    .
+// SCHED_FAIL_MAX   -      (SetUp).
+class	TSmsSched{
+ TSchedMdm			Mdm[SCHED_MDM_MAX]			;
+ int				Cnt							;
+
+ int		IsFree(int id){ return Mdm[id].Up && Mdm[id].Idle && Mdm[id].Ix < 0	;}
+public:
+ TSmsQueue			Queue						;
+
+   TSmsSched(void){ Cnt = 0	;}
+
+ int		Add(void)							;//  , -1 -  
+ void		SetUp(int id,int up)				;//   /  
+ void		SetIdle(int id,int idle)			;
+ int		IsUp(int id){ return id >= 0 && id < Cnt && Mdm[id].Up	;}
+ int		Take(int id,uint32_t now)			;//     id, -1 - , SCHED_TURN
+ int		Done(int id,int ok,uint32_t now)	;// ;   ()  
+ const TSchedMdm*	GetMdm(int id){ return (id >= 0 && id < Cnt) ? Mdm + id : 0	;}
+};
+//-------------------------------------------------
+#endif
@@ -0,0 +1,88 @@
+//-------------------------------------------------
+#include	"TimerWheel.h"
+#include	"EventQueue.h"
+//-------------------------------------------------
+void	TTimerWheel::Reset(uint32_t now)
+{int	ix	;
+
+ for(ix=0;ix<TMW_SIZE;ix++) Slot[ix].Next = Slot[ix].Prev = Slot + ix	;
+ for(ix=0;ix<TMW_SIZE/32;ix++) Used[ix] = 0	;
+ Cur = now	; Cnt = 0	; CntFire = CntLate = 0	;}
+//-------------------------------------------------
+void	TTimerWheel::Link(TTimer* t)
+{int			ix = t->Due & TMW_MASK	;
+ TTmrLink*	head = Slot + ix		;
+
+ t->Next = head	; t->Prev = head->Prev	;
+ head->Prev->Next = t	; head->Prev = t	;
+ Used[ix >> 5] |= 1u << (ix & 31)	; Cnt++	;}
+//-------------------------------------------------
+void	TTimerWheel::Unlink(TTimer* t)
+{int			ix = t->Due & TMW_MASK	;
+
+ t->Prev->Next = t->Next	; t->Next->Prev = t->Prev	;
+ t->Next = t->Prev = 0		; Cnt--	;
+ if(Slot[ix].Next == Slot + ix) Used[ix >> 5] &= ~(1u << (ix & 31))	;}
+//-------------------------------------------------
+// ,   ,    Run().
+void	TTimerWheel::Start(TTimer* t,uint32_t due,uint32_t period)
+{
+ if(t->Active()) Unlink(t)	;
+ if((int32_t)(due - Cur) <= 0) due = Cur + 1	;
+ t->Due = due	; t->Period = period	;
+ Link(t)		;}
+//-------------------------------------------------
+void	TTimerWheel::Stop(TTimer* t)
+{
+ if(t->Active()) Unlink(t)	;}
+//-------------------------------------------------
+//    :  , 
+//    ,      .
+void	TTimerWheel::RunSlot(int ix,uint32_t now)
+{TTmrLink*	head = Slot + ix	;
+ TTmrLink*	lnk, *nxt			;
+ TTimer*	t					;
+
+ if(!(Used[ix >> 5] & (1u << (ix & 31)))) return	;
+ lnk = head->Next	; head->Prev->Next = 0	;
+ head->Next = head->Prev = head	; Used[ix >> 5] &= ~(1u << (ix & 31))	;
+
+ for(;lnk;lnk = nxt){
+   nxt = lnk->Next	; t = (TTimer*)lnk	; Cnt--	;
+   if((int32_t)(t->Due - now) > 0){ Link(t)	; continue	;}//  
+
+   if(!EvQueue.Post(t->Type,0,t->Value)){ CntLate++	; t->Due = now + 1	; Link(t)	; continue	;}
+   CntFire++	;
+   if(t->Period){
+     t->Due += t->Period	;
+     if((int32_t)(t->Due - now) <= 0) t->Due = now + t->Period	;//  -   
+     Link(t)	;}
+   else t->Next = t->Prev = 0	;
+ }
+}
+//-------------------------------------------------
+void	TTimerWheel::Run(uint32_t now)
+{int	ix	;
+
+ if((int32_t)(now - Cur) <= 0) return	;
+ if(now - Cur >= TMW_SIZE){ for(ix=0;ix<TMW_SIZE;ix++) RunSlot(ix,now)	;}
+ else while(Cur != now) RunSlot((int)(++Cur & TMW_MASK),now)	;
+ Cur = now	;}
+//-------------------------------------------------
+//         - 
+//  ,   ,  .
+int		TTimerWheel::NextDue(uint32_t* due)
+{uint32_t	bits	;
+ int		pos = (Cur + 1) & TMW_MASK, dist, w	;
+
+ if(!Cnt) return 0	;
+ for(dist=0;dist<TMW_SIZE;){
+   w = pos >> 5	; bits = Used[w] >> (pos & 31)	;
+   if(bits){
+     while(!(bits & 1)){ bits >>= 1	; dist++	;}
+     *due = Cur + 1 + dist	; return 1	;}
+   dist += 32 - (pos & 31)	; pos = (pos + 32 - (pos & 31)) & TMW_MASK	;
+ }
+ *due = Cur + TMW_SIZE	;
+ return 1	;}
+//-------------------------------------------------
@@ -0,0 +1,61 @@
+#ifndef	TIMER_WHEEL_H
+#define	TIMER_WHEEL_H
+//-------------------------------------------------
+#include	<stdint.h>
+#include	"EventGUI.h"
+//-------------------------------------------------
+#define		TMW_BITS			8
+#define		TMW_SIZE			(1 << TMW_BITS)	//  ,   
+#define		TMW_MASK			(TMW_SIZE-1)
+//-------------------------------------------------
+struct	TTmrLink{
+ TTmrLink*			Next						;
+ TTmrLink*			Prev						;// 0 -   
+};
+//-------------------------------------------------
+//     ( , static),    .
+//    EvQueue   Type   Value.
+struct	TTimer:public TTmrLink{
+ uint32_t			Due							;// ,  Clock
+ uint32_t			Period						;// 0 - 
+ EVENT_TYPE			Type						;
+ short				Value						;
+
+   TTimer(EVENT_TYPE type=0,short value=0){ Next = Prev = 0	; Due = Period = 0	; Type = type	; Value = value	;}
+ int		Active(void){ return Prev != 0		;}
+};
+//-------------------------------------------------
+//   :  =  & TMW_MASK,   - 
+//  ,  Start()/Stop() - O(1)    .
+// Run()        now,  
+//      ;     - 
+//    . NextDue() -     
+// ,   Clock:    evTick,  
+//  main.   -   main (  ).
+class	TTimerWheel{
+ TTmrLink			Slot[TMW_SIZE]				;
+ uint32_t			Used[TMW_SIZE/32]			;//  
+ uint32_t			Cur							;// ,  
+ int				Cnt							;// 
+
+ void		Link(TTimer* t)						;
+ void		Unlink(TTimer* t)					;
+ void		RunSlot(int ix,uint32_t now)		;
+public:
+ uint32_t			CntFire						;// 
+ uint32_t			CntLate						;//     EvQueue, 
+
+   TTimerWheel(void){ Reset(0)	;}
+
+ void		Reset(uint32_t now)					;
+ void		Start(TTimer* t,uint32_t due,uint32_t period=0)	;//  -   
+ void		Stop(TTimer* t)						;
+ void		Run(uint32_t now)					;//    now 
+ int		NextDue(uint32_t* due)				;// 0 -  
+ int		GetCnt(void){ return Cnt			;}
+};
+//-------------------------------------------------
+extern	TTimerWheel		Timers					;
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
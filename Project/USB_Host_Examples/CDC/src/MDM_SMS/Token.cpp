@@ -0,0 +1,63 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	<ctype.h>
+#include	"Token.h"
+//-------------------------------------------------
+int		TToken::Int(int def) const
+{int	ix = 0, val = 0, sgn = 1	;
+
+ while(ix < Len && Str[ix] == ' ') ix++					;
+ if(ix < Len && (Str[ix] == '-' || Str[ix] == '+')){ if(Str[ix] == '-') sgn = -1	; ix++	;}
+ if(ix >= Len || !isdigit((unsigned char)Str[ix])) return def	;
+ for(;ix < Len && isdigit((unsigned char)Str[ix]);ix++) val = val*10 + (Str[ix] - '0')	;
+ return	val*sgn	;}
+//-------------------------------------------------
+int		TToken::Copy(char* buf,int size) const
+{int	len = Len	;
+
+ if(!buf || size <= 0) return 0		;
+ if(len > size-1) len = size-1		;
+ memcpy(buf,Str,len)	; buf[len] = 0	;
+ return	len	;}
+//-------------------------------------------------
+int		TToken::Cmp(const char* str) const
+{int	ix	;
+
+ for(ix=0;str[ix];ix++){
+   if(ix >= Len || toupper((unsigned char)Str[ix]) != toupper((unsigned char)str[ix])) return 1	;}
+ return	0	;}
+//-------------------------------------------------
+const char*	TToken::Find(char ch) const
+{const char*	res = Len > 0 ? (const char*)memchr(Str,ch,Len) : 0	;
+ return	res	;}
+//-------------------------------------------------
+TToken&	TToken::Trim(void)
+{
+ while(Len > 0 && *Str == ' '){ Str++	; Len--	;}
+ while(Len > 0 && Str[Len-1] == ' ') Len--	;
+ return	*this	;}
+//-------------------------------------------------
+int		TTokenizer::Next(TToken* tk)
+{const char*	start = Cur	;
+ char			inQ = 0, ch	;
+ int			len			;
+
+ if(flEnd) return 0	;
+
+ for(;;Cur++){
+   ch = *Cur	;
+   if(!ch || ch == '\r' || ch == '\n'){ flEnd = 1	; break	;}	//  
+   if(ch == '"') inQ = !inQ								;
+   else if(!inQ && strchr(Dlm,ch)) break					;	// 
+ }
+ len = (int)(Cur - start)	;
+ if(!flEnd) Cur++			;//  
+
+ if(tk){ tk->Str = start	; tk->Len = len	;}
+ return	1	;}
+//-------------------------------------------------
+int		TTokenizer::Skip(int cnt)
+{int	ix	;
+ for(ix=0;ix<cnt && Next();ix++)	;
+ return	ix	;}
+//-------------------------------------------------
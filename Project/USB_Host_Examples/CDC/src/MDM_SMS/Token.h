@@ -0,0 +1,34 @@
+#ifndef	TOKEN_H
+#define	TOKEN_H
+//-------------------------------------------------
+//  -    ( + ),   .
+//      Int().
+struct	TToken{
+ const char*		Str							;
+ int				Len							;
+
+   TToken(void):Str(""),Len(0){}
+
+ int			Int(int def=0) const			;//  atoi,    Len;   - def
+ int			Copy(char* buf,int size) const	;//   0  ,  
+ int			Cmp(const char* str) const		;//  StrCmp: 0 -    str (  )
+ const char*	Find(char ch) const				;//   ch  
+ TToken&		Trim(void)						;//    
+};
+//-------------------------------------------------
+//   :      dlm,    -
+//  .  "..."      
+// ( "14/03/21,19:16:04+28").    0, CR  LF.
+class	TTokenizer{
+ const char*		Cur							;
+ const char*		Dlm							;
+ char				flEnd						;
+public:
+   TTokenizer(const char* str,const char* dlm):Cur(str),Dlm(dlm),flEnd(str ? 0:1){}
+
+ int			Next(TToken* tk=0)				;//  , 0 -   
+ int			Skip(int cnt)					;//  cnt ,   
+};
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
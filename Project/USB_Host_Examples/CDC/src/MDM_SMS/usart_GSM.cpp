@@ -4,11 +4,17 @@
 #include		<stdlib.h>
 #include		<ctype.h>
 #include		"usart_GSM.h"
+#include		"Token.h"
 #include		"Log.h"
+#include		"Trace.h"
+#include		"EventQueue.h"
+#include		"Clock.h"
 //***************************************************************
 //***************************************************************
 //#define		USART_GSM			USART2
-#define		LenBF				200
+#define		LenBF				GSM_LEN_BF
+#define		LenFIFO				GSM_LEN_FIFO
+#define		LenRcv				PDU_LEN_HEX	//    FifoRx 
 
 //// Enable Vin
 //#define		VEN_PORT			GPIOC
@@ -25,29 +31,32 @@
 
 #define		TIM_PULSE_PWR_ON	1200
 #define		TIM_WAIT_PWR_ON		800
-#define		TIM_WAIT_500		200
+#define		TIM_NEXT			1		//   - ,  . 
+#define		TIM_WAIT_ANS		3000	//     
+#define		TIM_WAIT_ATH		5000	// ATH  
+#define		TIM_WAIT_CMGS		60000	//    
+#define		TIM_WAIT_CMGL		20000	//     
 #define		TIM_REPEAT_REQ		50000
 #define		TIM_IDLE			600000
 #define		TIM_REPEAT_SMS		10000
-#define		TIM_GUARD_SMS		60000
-#define		TIM_TX_PAUSE		100
+#define		TIM_PROBE_FIRST		CLK_MS(100)		//   AT  MdmInit,   x2
+#define		TIM_PROBE_STEP_MAX	CLK_MS(1600)
+#define		TIM_WAIT_PROBE		CLK_MS(500)		//   
+#define		TIM_PROBE_LIMIT		CLK_MS(20000)	//     -    (INIT_ERR)
+#define		SMS_OUT_PART_MAX	8		//   ,  - 
 //***************************************************************
 #define		StrCmp(X,Y)	strncasecmp(X,Y,strlen(Y))
 //***************************************************************
-static	char	GsmBufRx[LenBF]	;
-static	char	GsmBufTx[LenBF]	;
-static	char	RcvBuf[LenBF]						;
-static	char	SmsInBuf[LenBF]						;
-static	char	SmsOutBuf[LenBF]					;
-static	char	StrDbg[LenBF], *strDbg = 0			;
-static	char	StrStt[LenBF], *strStt = 0			;
-static	char	StrMasterNmbr[40]					;
-const	char*	strMsg = 0							;
 //static	char	GsmMsg[80]						;
 //***************************************************************
 const	char	strOK[] 			= "OK"			;
+const	char	strPROBE[] 			= "AT"			;//  ?
 const	char	strAT[] 			= "AT;E1;^CURC=0"	;
 const	char	strERROR[] 			= "ERROR"		;
+const	char	strCME_ERROR[]		= "+CME ERROR"	;
+const	char	strCMS_ERROR[]		= "+CMS ERROR"	;
+const	char	strRING[]			= "RING"		;
+const	char	strESC[]			= "\033"		;
 const	char	strNO_CRR[]			= "NO CARRIER"	;
 const	char	strPROMPT[]			= ">"			;
 const	char	smbPROMPT			= '>'			;
@@ -62,6 +71,8 @@ const	char	strGSN[]			= "AT+GSN"		;// Request IMEI
 const	char	strFMT_PDUp[]		= "AT+CMGF=0"	;
 const	char	strFMT_PDUt[]	 	= "AT+CMGF=1"	;
 //const	char	strGET_LST_SMS[]	= "AT+CMGL=4,0"	;
+const	char	strLST_SMS[]		= "AT+CMGL=0"	;//      (PDU)
+const	char	strDEL_RD_SMS[]		= "AT+CMGD=1,3"	;//  ,  
 const	char	strSMS_STRG1[]  	= "AT+CPMS=?"	;
 const	char	strSET_MODE_CNMI[] 	= "AT+CNMI=1,1,2,2,1"	;
 const	char	strGET_MODE_CNMI[] 	= "AT+CNMI?"	;
@@ -71,10 +82,10 @@ const	char	strRD_SMS1[]  		= "AT+CMGR=1"	;// 
 const	char	strDEL_SMS[]		= "AT+CMGD=%d,0";//   
 const	char	strDEL_SMS1[]		= "AT+CMGD=1,0"	;//  _1
 const	char	strDEL_ALL_SMS[]	= "AT+CMGD=1,4"	;
-const	char	strSEND_SMS[]		= "AT+CMGS="	;
+const	char	strSEND_SMS[]		= "AT+CMGS=%d"	;//  TPDU
 const	char	strCLTS[]			= "AT+CLTS=1"	;// Get Local Timestamp
 //const	char	strINIT1[]			= "AT+CMGF=1;+COPS?;+GSV;+CSQ;+CLIP=1;+CLTS=1;+CCLK?"	;// for SIM900
-const	char	strINIT1[]			= "AT+CLIP=1;+CMGF=1;+COPS?;i;+CSQ"	;
+const	char	strINIT1[]			= "AT+CLIP=1;+CMGF=0;+COPS?;i;+CSQ"	;
 const	char	strINIT2[]			= "AT+CPMS=\"SM\",\"SM\",\"SM\""	;
 //const	char	strINIT2[]			= "AT+CPMS=\"me\",\"me\",\"me\""	;
 
@@ -83,6 +94,8 @@ const	char	strINIT2[]			= "AT+CPMS=\"SM\",\"SM\",\"SM\""	;
 
 const	char	strAnsCPMS[]		= "+CPMS: \"SM\""	;
 const	char	strAnsCMGR[]		= "+CMGR: "			;
+const	char	strAnsCMGL[]		= "+CMGL: "			;
+const	char	strAnsCMGS[]		= "+CMGS: "			;//  , <mr>
 const	char	strAnsCMT[]			= "+CMT: "			;//  !
 const	char	strAnsCMTI[]		= "+CMTI: "			;//  !
 const	char	strAnsCLIP[]		= "+CLIP: "			;
@@ -91,12 +104,15 @@ const	char	strMsg_INIT_OK[]   	= "->INIT_OK"		;
 const	char	strMsg_INIT_ERR[]  	= "->INIT_ERR"		;
 const	char	strMsg_CPMS_OK[] 	= "->CPMS_OK"		;
 const	char	strMsg_RD_SMS_OK[] 	= "->RD_SMS_OK"		;
+const	char	strMsg_RD_ALL_SMS_OK[]= "->RD_ALL_SMS_OK, %d"	;
+const	char	strMsg_DEL_RD_SMS_OK[]= "->DEL_RD_SMS_OK"	;
 const	char	strMsg_DEL_ALL_SMS_OK[]  = "->DEL_ALL_SMS_OK";
 const	char	strMsg_SET_MODE_CNMI_OK[]= "->SET_MODE_CNMI_OK";
 const	char	strMsg_DEL_SMS_OK[] = "->DEL_SMS_OK"	;
 const	char	strMsg_DEL_SMS_ERR[]= "->DEL_SMS_ERR"	;
 const	char	strMsg_SMS_SEND_OK[]= "->SMS SEND OK"	;
 const	char	strMsg_SMS_SEND_ERR[]="->SMS SEND ERR"	;
+const	char	strMsg_PDU_ERR[]	= "->PDU ERR"		;
 const	char	strNO_INFO[]		= "NO INFO"			;
 
 const	char	cmdNewPass[]		= "np"				;
@@ -104,6 +120,7 @@ const	char	cmdStart[]			= "start"			;
 const	char	cmdStop[]			= "stop"			;
 const	char	cmdTermTrg[]		= "t"				;
 const	char	cmdMaster[]			= "ms"				;
+const	char	cmdUsbStat[]		= "usb"				;//   USB -  
 const	char	strValidNmbr[]		= "\"+79"			;
 //***************************************************************
 enum{
@@ -125,6 +142,8 @@ enum{
   msgSendSMS,
   msgSetCNMI,
   msgGetCNMI,
+  msgRdAllSMS,
+  msgCMGS,
   msgGSM
 };
 //-----------------------------------------------------
@@ -143,10 +162,13 @@ typedef enum{
   sttIDLE		= 11,
   sttSetCNMI	= 12,
   sttGetCNMI	= 13,
-  sttATH		= 14
+  sttATH		= 14,
+  sttRD_ALL_SMS	= 15,
+  sttDEL_RD_SMS	= 16,
+  sttLast
 }TGSM_State		;
 
-const char*	strStat[sttATH-sttNone+1]={
+const char*	strStat[sttLast-sttNone]={
 "None"			,
 "OFF"			,
 "Ready"			,
@@ -159,54 +181,98 @@ const char*	strStat[sttATH-sttNone+1]={
 "DEL_SMS"		,
 "DEL_SMS1"		,
 "IDLE"			,
-"ATH"			,
 "SetCNMI"		,
-"GetCNMI"
+"GetCNMI"		,
+"ATH"			,
+"RD_ALL_SMS"	,
+"DEL_RD_SMS"
 };
 //***************************************************************
-int	ParseParams(char* str,char* dlm,char* Prm,int* Val,const int CntPrm,const int LenPrm);
+//   : - (   ),
+//  / .       ,
+//         -   .
+//   (+CREG, +CUSD ...) -      .
+// URC -    (,  ),   OnURC()
+//           .
+struct	TAnsGSM{
+ const char*		Str								;
+ uint8_t			Len								;
+ uint8_t			Msg								;
+ uint8_t			Urc								;// 1 -  
+ uint16_t			(TUsartGSM::*Parse)(char* str)	;
+};
+#define		ANS(S,M,P)		{S,sizeof(S)-1,M,0,P}
+#define		URC(S,P)		{S,sizeof(S)-1,msgEmpty,1,P}
+const	TAnsGSM	TUsartGSM::TblAns[]={
+  URC(strAnsCLIP					,&TUsartGSM::ParseCLIP)	// "+CLIP: "
+ ,ANS(strCME_ERROR	,msgERROR	,0)						// "+CME ERROR: x"
+ ,ANS(strAnsCMGL	,msgEmpty	,&TUsartGSM::ParseCMGL)	// "+CMGL: "
+ ,ANS(strAnsCMGR	,msgEmpty	,&TUsartGSM::ParseCMGR)	// "+CMGR: "
+ ,ANS(strAnsCMGS	,msgCMGS	,0)						// "+CMGS: "
+ ,ANS(strCMS_ERROR	,msgERROR	,0)						// "+CMS ERROR: x"
+ ,URC(strAnsCMT						,&TUsartGSM::ParseCMT )	// "+CMT: "	  !
+ ,URC(strAnsCMTI					,&TUsartGSM::ParseCMTI)	// "+CMTI: "  !
+ ,ANS(strAnsCPMS	,msgEmpty	,&TUsartGSM::ParseCPMS)	// "+CPMS: "SM""
+ ,ANS(strERROR		,msgERROR	,0)
+ ,ANS(strNO_CRR		,msgNO_CRR	,0)
+ ,ANS(strOK			,msgOK		,0)
+ ,URC(strRING						,0)						//    +CLIP
+};
+const	int		TUsartGSM::CntAns = SIZE_ARRAY(TblAns)	;
 //***************************************************************
-TUsartGSM*		TUsartGSM::Instance=0	;
+const	USBH_CDC_Cb_TypeDef	TUsartGSM::CdcCb={ FnListenData,FnGetRxBuff,FnCommitRx,FnMdmInit,FnGetTxBuff,FnCommitTx,FnMdmLost,FnGetTxLen }	;
 //***************************************************************
 #define		VEN_PIN_SET()		GPIO_SetBits(VEN_PORT,VEN_PIN)
 #define		VEN_PIN_RST()		GPIO_ResetBits(VEN_PORT,VEN_PIN)
 #define		PWR_ON_PIN_SET()	GPIO_SetBits(PWR_ON_PORT,PWR_ON_PIN)
 #define		PWR_ON_PIN_RST()	GPIO_ResetBits(PWR_ON_PORT,PWR_ON_PIN)
 //***************************************************************
-		TUsartGSM::TUsartGSM(void){}
+		TUsartGSM::TUsartGSM(void):TmrOut(evGsmTimeOut),TmrSms(evGsmRx){ Sched = 0	; SchedId = -1	; Dev = 0	; strMsg = 0	; *StrMasterNmbr = 0	;}
 //***************************************************************
-EVENT_TYPE	TUsartGSM::OnEvent(TEvent* Event)
+//  :  ,   , ,  , -  EvQueue.
+//      Poll:      .
+//    - Poll        
+//    ;   -  ,   .
+void	TUsartGSM::Poll(void)
 {uint16_t	msgMsg = msgEmpty	;
+ int32_t	wait				;
 
- strRcv = GetS(RcvBuf,LenBF)								;//   ?
- cntRcv = (strRcv && *strRcv)? strlen(strRcv) : 0			;//  ?
+ if(!flEventNeed) strRcv = GetS(RcvBuf,LenRcv,&cntRcv)		;//   ? (  FifoRx)
  if(strRcv && cntRcv){ msgMsg = Parse(strRcv,cntRcv)		;  strRcv = 0	;}
 
  if(!msgMsg) msgMsg = OnEventGSM()							;
- if(!timOut && !msgMsg){ msgMsg = msgTimeOut ; timOut = -1	;}
- if(msgMsg != msgEmpty){ timOut = Operate(msgMsg)			;}// !!!!!!!!!!!!!!!!!
- if(timOut <= 0) timOut = TIM_IDLE							;
+ if(!msgMsg && flTimeOut) msgMsg = msgTimeOut				;
+ if(msgMsg != msgEmpty && IsAwaited(msgMsg)){				 //  ,   - 
+   MsgAwt = msgEmpty	; wait = Operate(msgMsg)			; flTimeOut = 0	;
+   Timers.Start(&TmrOut,Ticks + (wait > 0 ? wait : TIM_IDLE))	;}
+ if(StateTrg == sttIDLE && (wait = Sched->Queue.GetWait(Ticks)) > 0) Timers.Start(&TmrSms,Ticks + wait)	;
+ Sched->SetIdle(SchedId,StateTrg == sttIDLE)					;//   -   
 
  if(prStateTrg != StateTrg || prSttPhase != SttPhase){
    prStateTrg = StateTrg	; prSttPhase = SttPhase			;
-   sprintf(StrStt,"%s, %d",strStat[StateTrg],SttPhase)		; strStt = StrStt	;}
- 
+   TRACE2("GSM %s, %d\n",strStat[StateTrg],SttPhase)		;}//   flash -  sprintf
+
+ if(strMsg)     { LOG_I(LOG_GSM,"%s\n",strMsg)				; strMsg = 0	;}// : StrDbg/SmsInBuf   Poll
+ if(flEventNeed){ EvQueue.Post(flEventNeed,0,flValueNeed)		; flEventNeed = 0	;}
+ if(flInitOK)   { EvQueue.Post(evGsmInitOK,0,SchedId)			; flInitOK = 0	; Sched->SetUp(SchedId,1)	;}
+ if(FifoRx.GetCntStr() > 0 || msgMsg != msgEmpty) EvQueue.Post(evGsmRx)	;//    ;   -  
+}
+//***************************************************************
+EVENT_TYPE	TUsartGSM::OnEvent(TEvent* Event)
+{
+ Ticks = Clock.Now()	;
  switch(Event->Type){
- case evGetEvent:
-   if(strDbg)     { Event->Type = evDbgMsg1	; Event->strData[0] = strDbg		; strDbg = 0	;}
-   else if(strMsg){ Event->Type = evDbgMsg2	; Event->strData[0] = (char*)strMsg	; strMsg = 0	;}
-   else if(flEventNeed){ Event->Type = flEventNeed	; Event->Value = flValueNeed; flEventNeed=0	;}
-   else if(strStt){ Event->Type = evStat1	; Event->strData[0] = strStt		; strStt = 0	;}
-   else if(flInitOK){Event->Type = evGsmInitOK	; flInitOK = 0	;}
- break	;
+ case evGsmTimeOut: if(Event->Value != SchedId) break	;//   
+					flTimeOut = 1	; Poll()	; break	;
+ case evGsmRx	 :	Poll()		; break	;
+ case evUsbStat	 :	LOG_I(LOG_GSM,"GSM #%d: cdc tx drop %u\n",SchedId,Cdc.CntTxDrop)	; break	;
  
 // case evClearPswGSM	: PswGSM = 0	; if(FnSetPswGSM ) FnSetPswGSM(PswGSM)			; break	;
  
 	//        , 
- case evEventSMS :  strncpy(PhoneNmbrSMS,GetMasterNmbr(),16)					;//  .   MasterNmbr
-					if(!StrCmp(PhoneNmbrSMS,strValidNmbr)){		 				 //   
-					  NeedSendSMS = 1 ; timGuardSMS = 0							;}
-					else{ *PhoneNmbrSMS = 0	; SetMasterNmbr(PhoneNmbrSMS)		;}// ,  
+ case evEventSMS :  if(!StrCmp(GetMasterNmbr(),strValidNmbr))					 //  .   MasterNmbr,   
+					{ QueueSMS(GetMasterNmbr(),smsPrioAlarm)					; EvQueue.Post(evGsmRx)	;}
+					else SetMasterNmbr((char*)"")								;// ,  
 		break	;
  } 
  return Event->Type		;}
@@ -216,32 +282,28 @@ EVENT_TYPE	TUsartGSM::OnEvent(TEvent* Event)
 //***************************************************************
 uint16_t TUsartGSM::OnEventGSM(void)
 {uint16_t	msgMsg = msgEmpty	;
+ int		ix = -1				;
 
- if(StateTrg == sttIDLE){
+ if(StateTrg == sttIDLE && FifoRx.GetCntStr() <= 0){		 //   : +CMTI  -  
    if(flINIT){ flINIT = 0	; msgMsg = msgINIT			;}
    
-   else if(*PhoneNmbrCall && !timTxPause){ 					 //        
-	 if(NeedSendSMS)									 //    
-	   strcpy(PhoneNmbrOut,PhoneNmbrCall)				;//     
-	 *PhoneNmbrCall = 0									;//  
-	 msgMsg = msgCLIP		;
-   }
-   else if(FIxDelSMS>=0 && !timTxPause){					 //   ,   
+   else if(FIxDelSMS>=0){								 //   ,   
 	 msgMsg = msgDelSMS		;
    }
-   else if(NeedSendSMS && !timTxPause && !timGuardSMS){
-	 if(*PhoneNmbrSMS && !*PhoneNmbrOut){ 
-	   strcpy(PhoneNmbrOut,PhoneNmbrSMS)	; *PhoneNmbrSMS = 0	;}
-	 if(*PhoneNmbrOut) msgMsg = msgSendSMS	;	 
-   }
-   else if(FIxInSMS>=0 && !timTxPause){					 //        
+   else if(FIxInSMS>=0){								 //     -    
 	 FIxRdSMS = FIxInSMS	; FIxInSMS = -1				;//  IxSMS   
 	 msgMsg   = msgInSMS	;
    }
-   else if(FIxMemSMS>=0){
-     FIxRdSMS = FIxMemSMS	; FIxMemSMS++	;
-	 if(FIxMemSMS > FTtlMemSMS) FIxMemSMS=FTtlMemSMS=FCntMemSMS=0	;
-	 msgMsg = msgMemSMS		;
+   else if(flRdAllSMS){ flRdAllSMS = 0		;				 //     -   
+	 msgMsg = msgRdAllSMS	;
+   }
+   else if(*PhoneNmbrCall){ 							 //    
+	 *PhoneNmbrCall = 0									;//   (   )
+	 msgMsg = msgCLIP		;
+   }
+   else if((ix = Sched->Take(SchedId,Ticks)) >= 0){	 // ,  ,      
+	 SmsIx  = ix			;
+	 msgMsg = msgSendSMS	;
    }
    else if(flNeedCNMI){ flNeedCNMI = 0		;
      msgMsg = msgSetCNMI	;
@@ -252,20 +314,40 @@ uint16_t TUsartGSM::OnEventGSM(void)
    else if(flDelAllSMS){ flDelAllSMS = 0	;
      msgMsg = msgDelAllSMS	;
    }
+   if(msgMsg != msgEmpty) State = sttIDLE	;//  :   ,   (  ), -    1
  }
+ if(ix == SCHED_TURN) EvQueue.Post(evGsmRx)	;//     - 
 
  return	msgMsg	;}
 //***************************************************************
 
 //***************************************************************
+//  ,   ,     (MsgAwt):
+//	msgOK     -   : OK, ERROR, +CMS/+CME ERROR, NO CARRIER
+//	msgPROMPT -  '>'  
+//   , URC    (. OnURC).
+int		TUsartGSM::IsAwaited(int Msg)
+{
+ if(MsgAwt == msgEmpty || Msg == msgTimeOut) return 1		;
+ if(MsgAwt == msgOK) return (Msg == msgOK || Msg == msgERROR || Msg == msgNO_CRR)	;
+ return (Msg == MsgAwt || Msg == msgERROR)					;}
+//***************************************************************
+//  :   Msg   tim 
+int		TUsartGSM::Await(int Msg,int tim)
+{MsgAwt = Msg	;
+ return tim		;}
+//***************************************************************
+//   -   StateTrg/SttPhase:  ,
+//       ,  .
+//   Await() -   ,     msgTimeOut.
 int		TUsartGSM::Operate(int Msg)
-{int	result = TIM_WAIT_PWR_ON;
+{int	result = TIM_NEXT	;
 
  switch(Msg){
    case msgINIT			: StateTrg = sttINIT	; SttPhase = 1	; break	;
    case	msgCLIP 		: StateTrg = sttATH		; SttPhase = 1	; break	;
    case msgInSMS		: StateTrg = sttRD_SMS	; SttPhase = 1	; break	;
-   case msgMemSMS		: StateTrg = sttRD_SMS	; SttPhase = 1	; break	;
+   case msgRdAllSMS		: StateTrg = sttRD_ALL_SMS;SttPhase = 1	; break	;
    case msgDelSMS		: StateTrg = sttDEL_SMS	; SttPhase = 1	; break	;
    case msgSendSMS		: StateTrg = sttInfSMS	; SttPhase = 1	; break	;
    case msgSetCNMI		: StateTrg = sttSetCNMI	; SttPhase = 1	; break	;
@@ -286,6 +368,8 @@ int		TUsartGSM::Operate(int Msg)
 	 case sttATH		 	: result = Operate_ATH(Msg)			; break	;
 	 case sttSetCNMI		: result = Operate_SetCNMI(Msg)		; break	;
 	 case sttGetCNMI		: result = Operate_GetCNMI(Msg)		; break	;
+	 case sttRD_ALL_SMS		: result = Operate_RD_ALL_SMS(Msg)	; break	;
+	 case sttDEL_RD_SMS		: result = Operate_DEL_RD_SMS(Msg)	; break	;
 	 case sttIDLE		 	: result = Operate_IDLE(Msg)		; break	;
 	 default	   			: result = TIM_WAIT_PWR_ON			;
    }
@@ -306,16 +390,19 @@ int		TUsartGSM::Operate(int Msg)
 	  case sttIDLE		 	: StateTrg = sttREQ_CNT_SMS		; break	;//   
 	  case sttSetCNMI		: StateTrg = sttGetCNMI			; break	;
 	  case sttGetCNMI		: StateTrg = sttIDLE			; break	;
+	  case sttRD_ALL_SMS	: StateTrg = sttDEL_RD_SMS		; break	;//    
+	  case sttDEL_RD_SMS	: StateTrg = sttIDLE			; break	;
+	  case sttOFF			: break	;//   -  MdmInit
 	  default      			: StateTrg = sttIDLE			;
    }
  }
  
- if(result <= 0) result = TIM_WAIT_500	;
+ if(result <= 0) result = TIM_NEXT	;
  
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_IDLE(int Msg)
-{int	result = 500		;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
    case	1	: result = TIM_IDLE			; break	;
@@ -337,71 +424,140 @@ int		TUsartGSM::Operate_IDLE(int Msg)
 // }
 // return result	;}
 //***************************************************************
+// FifoRx  :       USB (  
+// ),       GetS().
+//   -  "AT":   -  (100, 200 ... 1600 )
+//  ,    TIM_PROBE_LIMIT  MdmInit.  0 -  
+// (SttPhase    1).
 int		TUsartGSM::Operate_INIT(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
  flINIT = 0		;
 
  switch(SttPhase){
-   case	1 : ResetFiFo()		; WriteStringLN(strAT)			; break	;
-   case 2 : 				  WriteStringLN(strINIT1)		; break	;
-   case 3 : 				  WriteStringLN(strINIT2)		; break	;
-   case	4 : if(Msg == msgOK){ State  = StateTrg				;
-							  strMsg = strMsg_INIT_OK		;
+   case	0 : SttPhase = 1	;//   -  
+   case	1 : DropTx()		; WriteStringLN(strPROBE)		; PrbCnt++	; result = Await(msgOK,TIM_WAIT_PROBE)	; break	;
+   case	2 : if(Msg != msgOK && Ticks - TickInit < (uint32_t)TIM_PROBE_LIMIT){//  
+			  result = PrbWait	; SttPhase = 0	; if(PrbWait < (int)TIM_PROBE_STEP_MAX) PrbWait *= 2	; break	;}
+							  WriteStringLN(strAT)			; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case 3 : 				  WriteStringLN(strINIT1)		; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case 4 : 				  WriteStringLN(strINIT2)		; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case	5 : if(Msg == msgOK){ strMsg = strMsg_INIT_OK		;
 							  flMdmPresent = flInitOK = 1	;
 							  flNeedCNMI   = 1				;
-							  flDelAllSMS  = 1				;}
+							  flRdAllSMS   = 1				;//  ,    
+			  if(TickLost) LOG_I(LOG_GSM,"GSM #%d back: %u ms, AT x%d\n",SchedId,CLK_TO_MS(Ticks - TickLost),PrbCnt)	;
+			  else         LOG_I(LOG_GSM,"GSM #%d up: %u ms, AT x%d\n",SchedId,CLK_TO_MS(Ticks - TickInit),PrbCnt)	;
+			  TickLost = 0	;}
 			else			 {strMsg = strMsg_INIT_ERR		;
 							  flMdmPresent = 0				;}
-			break	;
+			State  = StateTrg								; break	;
    default: SttPhase = 0	; result = -1	;
  }
  return result	;}
 //***************************************************************
-//      
+//      . "+CPMS:"  ParseCPMS(),
+//    OnEventGSM()  flRdAllSMS.
 int		TUsartGSM::Operate_REQ_CNT_SMS(int Msg)
-{int	result = 1000		;
- static	int	needReadSMS = 0	;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : needReadSMS = 0	; WriteStringLN(strREQ_CNT_SMS)	; break	;
-   case	2 : if(Msg == msgMemSMS) needReadSMS = 1			; break	;//   "CPMS:"  
-   case	3 : if(needReadSMS && Msg == msgOK){ 						 //  ""  
-			  StateTrg = sttRD_SMS	; SttPhase = 1	; result = -1	;}
-			else State = StateTrg	; 
-			break	;
+   case	1 : WriteStringLN(strREQ_CNT_SMS)	; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case	2 : State = StateTrg											; break	;// OK, ERROR  
    default: SttPhase = 0	; result = -1			;
  }
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_ATH(int Msg)
-{int	result = 1000		;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : WriteStringLN("ATH"); result = 2000		; break	;// !!!
-   case	2 : State = StateTrg	; result = 100		; break	;//  ""  
+   case	1 : WriteStringLN("ATH"); result = Await(msgOK,TIM_WAIT_ATH)	; break	;//  
+   case	2 : State = StateTrg											; break	;
    default: SttPhase = 0		; result = -1		;
  }
  return result	;}
 //***************************************************************
+//      pos (   )  SmsOutBuf,
+//       .
+int		TUsartGSM::GetPartSMS(int pos,int* len)
+{int	cnt	;
+
+ cnt = FnGetInfSMS ? FnGetInfSMS(SmsOutBuf,PDU_LEN_TEXT,pos) : 0	;
+ if(!FnGetInfSMS && pos < (int)sizeof(strNO_INFO)-1){
+   cnt = sizeof(strNO_INFO)-1 - pos	; memcpy(SmsOutBuf,strNO_INFO + pos,cnt)	;}
+ if(cnt < 0) cnt = 0	;
+ if(len) *len = cnt		;
+ return	TPdu::Fit(SmsOutBuf,cnt,SmsCnt > 1)	;}
+//***************************************************************
+// PDU    PduOutBuf  AT+CMGS=<>. 0 -  .
+int		TUsartGSM::NextPartSMS(void)
+{char	cmd[20]		;
+ int	cnt, len	;
+
+ cnt = GetPartSMS(SmsPos,0)											;
+ len = TPdu::Encode(PduOutBuf,sizeof(PduOutBuf),PhoneNmbrOut,SmsOutBuf,cnt,
+					SmsRef,SmsCnt > 1 ? SmsCnt:0,SmsSeq)			;
+ if(len <= 0 || (cnt == 0 && SmsPos < SmsLen)) return 0				;
+ SmsPos += cnt	;
+ sprintf(cmd,strSEND_SMS,len)	; WriteStringLN(cmd)				;
+ return	1	;}
+//***************************************************************
+//   . :   -  MarkInSMS(),   (, . ).
+void	TUsartGSM::QueueSMS(const char* nmbr,int prio)
+{
+ Sched->Queue.Put(nmbr,prio,TickInSMS ? TickInSMS : Ticks)	; TickInSMS = 0	;}
+//***************************************************************
+//  :  -    ,  -   
+// ( ,   ).    -  .
+// ,  Sched   , .
+void	TUsartGSM::EndSMS(int ok)
+{int	lat = Sched->Done(SchedId,ok,Ticks)	;
+ TSmsQueue*	q = &Sched->Queue			;
+
+ if(lat >= 0){ LatSMS = lat	; if(LatSMS > LatSMSMax) LatSMSMax = LatSMS	;
+   sprintf(StrDbg,"%s #%d, %d ms, p50 %u, p95 %u, q %d/%u, drop %u, fail %u",strMsg_SMS_SEND_OK,SchedId,LatSMS,
+		   q->GetLat(50),q->GetLat(95),q->GetCnt(),q->CntMax,q->CntDrop,q->CntFail)	; strMsg = StrDbg	;}
+ else strMsg = ok ? strMsg_SMS_SEND_OK : strMsg_SMS_SEND_ERR	;
+ if(!Sched->IsUp(SchedId)) flINIT = 1	;
+ State = StateTrg	; SmsIx = -1	; *PhoneNmbrOut = 0	;}
+//***************************************************************
+// .   :    FnGetInfSMS  ,   
+//  .  -     UDH (  ,  
+//  ). AT+CMGS      "+CMGS: <mr>" ,
+// "OK"   ;      "OK".
 int		TUsartGSM::Operate_InfSMS(int Msg)
-{int	result = 500	;
- char	*str = 0		;
+{int		result = TIM_NEXT	;
+ int		pos, len = 0		;
+ TSmsOut*	rec					;
 
  switch(SttPhase){
-   case	1 : if(*PhoneNmbrOut && NeedSendSMS && !timGuardSMS){ 
-			  Msg = msgOK	; WriteStringLN_P(strSEND_SMS,PhoneNmbrOut)	;}
+   case	1 : if((rec = Sched->Queue.GetRec(SmsIx)) != 0){
+			  strcpy(PhoneNmbrOut,rec->Nmbr)								;
+			  SmsLen = FnGetInfSMS ? FnGetInfSMS(0,0,0) : sizeof(strNO_INFO)-1	;
+			  SmsCnt = 1	; SmsSeq = 1	; SmsPos = 0	; SmsRef++		;
+			  if(GetPartSMS(0,&len) < SmsLen){							 //    
+				for(SmsCnt=2,SmsSeq=0,pos=0;pos < SmsLen && SmsSeq < SMS_OUT_PART_MAX;SmsSeq++){
+				  if((len = GetPartSMS(pos,0)) <= 0) break	;
+				  pos += len								;}
+				SmsCnt = SmsSeq	; SmsSeq = 1	; SmsLen = pos		;}//  
+			  len = NextPartSMS()										;}
+			if(len > 0) result = Await(msgPROMPT,TIM_WAIT_ANS)		;
+			else EndSMS(0)											;
    break	;
    
    case	2 : if(Msg == msgPROMPT){
-				str = FnGetInfSMS ? FnGetInfSMS(SmsOutBuf,LenBF):
-									(char*)strNO_INFO			;
-				WriteStringLN_P(str,"\032\r\n")	; NeedSendSMS = 0	; 
-				*PhoneNmbrOut =0	; timGuardSMS = TIM_GUARD_SMS	;}
+				WriteStringLN_P(PduOutBuf,"\032")		;
+				result = SmsSeq < SmsCnt ? Await(msgCMGS,TIM_WAIT_CMGS)://   -  
+										   Await(msgOK  ,TIM_WAIT_CMGS)	;}
+			else{ if(Msg == msgTimeOut) WriteString(strESC)		;//    
+				  EndSMS(0)										;}
    break	;
    
-   case 3 : if(Msg == msgOK)   { strMsg = strMsg_SMS_SEND_OK	;}// TODO TODO
-	   else if(Msg == msgERROR){ strMsg = strMsg_SMS_SEND_ERR	;}
-	   State = StateTrg	; NeedSendSMS = 0	; *PhoneNmbrOut =0	;
+   case 3 : if(Msg == msgCMGS && SmsSeq < SmsCnt){				 //  
+			  SmsSeq++	;
+			  if(NextPartSMS()){ result = Await(msgPROMPT,TIM_WAIT_ANS)	; SttPhase = 1	; break	;}
+			  Msg = msgERROR	;}
+			EndSMS(Msg == msgOK)	;// +CMS ERROR /  -  
    break	;
    
    default: SttPhase = 0	; result = -1	;			
@@ -409,28 +565,56 @@ int		TUsartGSM::Operate_InfSMS(int Msg)
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_RD_SMS(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
  char	str[20]		;
 
  switch(SttPhase){
    case	1 :	if(FIxRdSMS<0) FIxRdSMS = 1					;
 			sprintf(str,strRD_SMS,FIxRdSMS)				;
 			FIxDelSMS = FIxRdSMS	; FIxRdSMS = -1		;
-			WriteStringLN(str)		; result = 2000		; break	;
+			WriteStringLN(str)		; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
    case	2 : if(Msg == msgOK) strMsg = strMsg_RD_SMS_OK	; 
-								      result = 100		; break	;
-   case 3 :	State = StateTrg							; break	;
+			State = StateTrg							; break	;
    default: SttPhase = 0			; result = -1		;
  }
  return result	;}
 //***************************************************************
+//     : "+CMGL:"      
+// ,   CMGR.     .
+//      OK -   ,    
+// ,    .
+int		TUsartGSM::Operate_RD_ALL_SMS(int Msg)
+{int	result = TIM_NEXT	;
+
+ switch(SttPhase){
+   case	1 : FCntRdSMS = 0	; WriteStringLN(strLST_SMS)	; result = Await(msgOK,TIM_WAIT_CMGL)	; break	;
+   case	2 : if(Msg == msgOK){ State = StateTrg			;
+			  sprintf(StrDbg,strMsg_RD_ALL_SMS_OK,FCntRdSMS)	; strMsg = StrDbg	;}
+			else{ StateTrg = sttIDLE	; SttPhase = 1	; result = -1	;}
+			break	;
+   default: SttPhase = 0	; result = -1				;
+ }
+ return result	;}
+//***************************************************************
+int		TUsartGSM::Operate_DEL_RD_SMS(int Msg)
+{int	result = TIM_NEXT	;
+
+ switch(SttPhase){
+   case	1 : WriteStringLN(strDEL_RD_SMS)				; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case	2 : if(Msg == msgOK)    strMsg = strMsg_DEL_RD_SMS_OK;
+	   else if(Msg == msgERROR) strMsg = strMsg_DEL_SMS_ERR;
+	   State = StateTrg									; break	;   
+   default: SttPhase = 0	; result = -1				;
+ }
+ return result	;}
+//***************************************************************
 int		TUsartGSM::Operate_DEL_SMS(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
  char	str[20]		;
 
  switch(SttPhase){
    case	1 : sprintf(str,strDEL_SMS,FIxDelSMS)			; 
-			FIxDelSMS = -1	; WriteStringLN(str)		; break	;
+			FIxDelSMS = -1	; WriteStringLN(str)		; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
    case	2 : if(Msg == msgOK)    strMsg = strMsg_DEL_SMS_OK;
 	   else if(Msg == msgERROR) strMsg = strMsg_DEL_SMS_ERR;
 	   State = StateTrg									; break	;   
@@ -439,10 +623,10 @@ int		TUsartGSM::Operate_DEL_SMS(int Msg)
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_DEL_SMS1(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : WriteStringLN(strDEL_SMS1)					; break	;
+   case	1 : WriteStringLN(strDEL_SMS1)					; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
    case	2 : if(Msg == msgOK) strMsg = strMsg_DEL_SMS_OK	;
 	   else if(Msg == msgERROR){}
 	   State = StateTrg									; break	;   
@@ -451,10 +635,10 @@ int		TUsartGSM::Operate_DEL_SMS1(int Msg)
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_DEL_ALL_SMS(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : WriteStringLN(strDEL_ALL_SMS)				; break	;
+   case	1 : WriteStringLN(strDEL_ALL_SMS)				; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
    case	2 : if(Msg == msgOK) strMsg = strMsg_DEL_ALL_SMS_OK	;
 	   else if(Msg == msgERROR){}
 	   State = StateTrg									; break	;   
@@ -463,10 +647,10 @@ int		TUsartGSM::Operate_DEL_ALL_SMS(int Msg)
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_SetCNMI(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : WriteStringLN(strSET_MODE_CNMI)				; break	;
+   case	1 : WriteStringLN(strSET_MODE_CNMI)				; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
    case	2 : if(Msg == msgOK) strMsg = strMsg_SET_MODE_CNMI_OK	;
 	   else if(Msg == msgERROR){}
 	   State = StateTrg									; break	;   
@@ -475,11 +659,11 @@ int		TUsartGSM::Operate_SetCNMI(int Msg)
  return result	;}
 //***************************************************************
 int		TUsartGSM::Operate_GetCNMI(int Msg)
-{int	result = 500;
+{int	result = TIM_NEXT	;
 
  switch(SttPhase){
-   case	1 : WriteStringLN(strGET_MODE_CNMI)				;
-	   State = StateTrg									; break	;   
+   case	1 : WriteStringLN(strGET_MODE_CNMI)				; result = Await(msgOK,TIM_WAIT_ANS)	; break	;
+   case	2 : State = StateTrg									; break	;   
    default: SttPhase = 0	; result = -1				;
  }
  return result	;}
@@ -498,84 +682,102 @@ char*	TUsartGSM::GetMasterNmbr(void)
 //***************************************************************
 uint16_t	TUsartGSM::ParseTextSMS(char* str)
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 6, lenPrm = 16	;
- char			Prm[cntPrm][lenPrm]		;
- char*			pPrm = &Prm[0][0]		;
- int			Val[cntPrm]				;
- char			Dlm[] = ",= #*"			;
+ TTokenizer		Tkn(str,",= #*")		;// ,,
+ TToken			Psw,Cmd,Prm				;
 
- flEventNeed = NeedSendSMS = 0			;
+ flEventNeed = 0						;//        
  strncpy(SmsInBuf,str,LenBF-1)			;
  strMsg = SmsInBuf						;
  
- ParseParams(str,Dlm,pPrm,Val,cntPrm,lenPrm)						;
- if(Val[0] == PswGSM){
-   if(!StrCmp(Prm[1],cmdNewPass)){ PswGSM = Val[2]					; 
+ Tkn.Next(&Psw)	; Tkn.Next(&Cmd)	; Tkn.Next(&Prm)					;
+ if((uint32_t)Psw.Int(-1) == PswGSM){
+   if(!Cmd.Cmp(cmdNewPass)){ PswGSM = Prm.Int()						; 
 	 if(FnSetPswGSM ) FnSetPswGSM(PswGSM)							;
 	 strMsg = StrDbg	; sprintf(StrDbg,"new Psw = %d", PswGSM)	;
 								   flEventNeed = evGetEvent			;}
-   if(!StrCmp(Prm[1],cmdStart  ))  flEventNeed = evStartP			;
-   if(!StrCmp(Prm[1],cmdStop   ))  flEventNeed = evStopP			;
-//   if(!StrCmp(Prm[1],cmdTermTrg)){ flEventNeed = evSetTermo			; 
-//								   flValueNeed = Val[2]				;}
-   if(!StrCmp(Prm[1],cmdMaster)){   SetMasterNmbr(PhoneNmbrSMS)		;
+   if(!Cmd.Cmp(cmdStart  ))  flEventNeed = evStartP					;
+   if(!Cmd.Cmp(cmdStop   ))  flEventNeed = evStopP					;
+   if(!Cmd.Cmp(cmdUsbStat))  EvQueue.Post(evUsbStat)				;//   
+//   if(!Cmd.Cmp(cmdTermTrg)){ flEventNeed = evSetTermo				; 
+//								   flValueNeed = Prm.Int()			;}
+   if(!Cmd.Cmp(cmdMaster)){   SetMasterNmbr(PhoneNmbrIn)			;
 								   flEventNeed = evGetEvent			;}
    
-   if(flEventNeed && *PhoneNmbrSMS){ NeedSendSMS = 1 ; timGuardSMS = 0	;}//   
-   sprintf(StrDbg," true Psw %d",Val[0])		; strMsg = StrDbg	;
- }
- else{sprintf(StrDbg," wrong Psw %d",Val[0])	; strMsg = StrDbg	;
-   NeedSendSMS = 0 ; *PhoneNmbrSMS = 0			;
+   if(flEventNeed && *PhoneNmbrIn) QueueSMS(PhoneNmbrIn,smsPrioReply)	;//   
+   sprintf(StrDbg," true Psw %d",Psw.Int())		; strMsg = StrDbg	;
  }
+ else{sprintf(StrDbg," wrong Psw %d",Psw.Int())	; strMsg = StrDbg	;}
+ *PhoneNmbrIn = 0	; TickInSMS = 0	;
 
  msgMsg = msgSMS_PARSED		;
- timTxPause = TIM_TX_PAUSE	;//   TX 
  return	msgMsg	;}
 //***************************************************************
+//***************************************************************
+//  PDU  +CMGR / +CMGL / +CMT.      PduAssm,
+//   ,   .
+uint16_t	TUsartGSM::ParsePduSMS(char* str)
+{TPduSMS		Sms						;
+ char*			text					;
 
+ if(!TPdu::Decode(str,&Sms)){ LOG_W(LOG_GSM,"%s\n",strMsg_PDU_ERR)	; return msgEmpty	;}
+ LOG_D(LOG_GSM,"SMS %.20s %d/%d\n",Sms.Nmbr,Sms.Seq,Sms.Cnt)	;
+ if(!(text = PduAssm.Add(&Sms,Ticks))) return msgEmpty			;//   
 
-static	char	bufSmpl[160]		; 
+ snprintf(PhoneNmbrIn,sizeof(PhoneNmbrIn),"\"%.*s\"",(int)sizeof(PhoneNmbrIn)-3,Sms.Nmbr)	;//    : "+79..."
+ if(StrCmp(PhoneNmbrIn,strValidNmbr)){ *PhoneNmbrIn = 0	; return msgEmpty	;}//     "+79"    SMS!
+ 
+ return	ParseTextSMS(text)	;}
 //***************************************************************
 uint16_t	TUsartGSM::Parse(char* str,int cnt)
 {uint16_t	msgMsg = msgEmpty				;
+ const TAnsGSM*	ans							;
  
  if(cnt>0 && str[0] != '\r' && str[0] != '\n'){
-   if(flWaitSMS){
-     strDbg = DecodeHEX_SMS(str,bufSmpl)	;   
-     msgMsg = ParseTextSMS(str)				; flWaitSMS = 0		;}
-   if(!strDbg) strDbg = str										;//     
-//   xputs(strDbg)	; xputs("\r")			;
+   if(flWaitSMS){							 //  PDU,    str  
+     msgMsg = ParsePduSMS(str)				;
+	 if(flWaitSMS == 2) msgMsg = msgEmpty	;//   +CMT -  URC
+	 flWaitSMS = 0							;
+	 return	msgMsg							;}
  }
 	  if(*str == smbPROMPT)			msgMsg = msgPROMPT			;
- else if(!StrCmp(str,strOK))		msgMsg = msgOK				;
- else if(!StrCmp(str,strERROR)) 	msgMsg = msgERROR			;
- else if(!StrCmp(str,strNO_CRR))	msgMsg = msgNO_CRR			;
- 
- else if(!StrCmp(str,strAnsCPMS)) 	msgMsg = ParseCPMS(str)		;
- else if(!StrCmp(str,strAnsCMGR)) 	msgMsg = ParseCMGR(str)		;
- else if(!StrCmp(str,strAnsCLIP)) 	msgMsg = ParseCLIP(str)		;
- else if(!StrCmp(str,strAnsCMTI)) 	msgMsg = ParseCMTI(str)		;//  !
- else if(!StrCmp(str,strAnsCMT )) 	msgMsg = ParseCMT(str)		;//  !
+ else if((ans = FindAns(str)) != 0){
+   if(ans->Urc) OnURC(ans,str)								;//   
+   else msgMsg = ans->Parse ? (this->*ans->Parse)(str) : ans->Msg	;}
  
  return	msgMsg	;}
 //***************************************************************
-//   ,  , ,   NeedSendSMS
+//   :  ,  .
+//  (ATH,  )  OnEventGSM(),   .
+void	TUsartGSM::OnURC(const TAnsGSM* ans,char* str)
+{
+ if(ans->Parse) (this->*ans->Parse)(str)	;}
+//***************************************************************
+//     TblAns  ,  strlen
+const TAnsGSM*	TUsartGSM::FindAns(const char* str)
+{int	lo = 0, hi = CntAns-1, mid, ix, dif	;
+
+ while(lo <= hi){
+   mid = (lo + hi) >> 1	; dif = 0			;
+   for(ix=0;ix<TblAns[mid].Len && !dif;ix++)
+     dif = toupper((uint8_t)str[ix]) - toupper((uint8_t)TblAns[mid].Str[ix])	;//   str (0) 
+   if(!dif) return TblAns + mid	;
+   if(dif < 0) hi = mid-1	; else lo = mid+1	;
+ }
+ return 0	;}
+//***************************************************************
+//   ,   (),  .   
 //	RING
 //	+CLIP: "+79231234567",145,"",,"",0
 uint16_t	TUsartGSM::ParseCLIP(char* str)
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 6, lenPrm = 16	;
- char			Prm[cntPrm][lenPrm]		;
- char*			pPrm = &Prm[0][0]		;
- int			Val[cntPrm]				;
- char			Dlm[] = ", "			;
+ TTokenizer		Tkn(str,", ")			;
+ TToken			Nmbr					;
  
- int result = ParseParams(str,Dlm,pPrm,Val,cntPrm,lenPrm)	;
- 
- strncpy(PhoneNmbrCall,Prm[1],20)		;
- if(!StrCmp(PhoneNmbrCall,strValidNmbr)){ NeedSendSMS = 1	;}
+ Tkn.Skip(1)	; Tkn.Next(&Nmbr)		;
+ Nmbr.Copy(PhoneNmbrCall,sizeof(PhoneNmbrCall))	;
+ MarkInSMS()							;
+ if(!StrCmp(PhoneNmbrCall,strValidNmbr)) QueueSMS(PhoneNmbrCall,smsPrioInfo)	;
 
- timTxPause = TIM_TX_PAUSE				;//   TX 
  return	msgMsg	;}
 //***************************************************************
 //     "- "
@@ -583,134 +785,140 @@ uint16_t	TUsartGSM::ParseCLIP(char* str)
 //	OK
 uint16_t	TUsartGSM::ParseCPMS(char* str)
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 4				;
- int			Val[cntPrm]				;
- char			Dlm[] = ", "			;
- 
- int result = ParseParams(str,Dlm,0,Val,cntPrm,0)	;
+ TTokenizer		Tkn(str,", ")			;
+ TToken			Cnt,Ttl					;
  
- FCntMemSMS = Val[2]					;
- FTtlMemSMS = Val[3]					;
- if(FCntMemSMS > 0 && FTtlMemSMS > 0) FIxMemSMS = 0	;//    
- else FIxMemSMS = FCntMemSMS = FTtlMemSMS = -1		;
+ Tkn.Skip(2)	; Tkn.Next(&Cnt)	; Tkn.Next(&Ttl)	;
+ FCntMemSMS = Cnt.Int()					;
+ FTtlMemSMS = Ttl.Int()					;
+ if(FCntMemSMS > 0 && FTtlMemSMS > 0) flRdAllSMS = 1	;//    
+ else FCntMemSMS = FTtlMemSMS = -1					;
  
- timTxPause = TIM_TX_PAUSE				;//   TX 
  return	msgMsg		;}
 //***************************************************************
 //	+CMTI: "SM",1
 uint16_t	TUsartGSM::ParseCMTI(char* str)		//  !
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 3				;
- int			Val[cntPrm]				;
- char			Dlm[] = ",:"			;
+ TTokenizer		Tkn(str,",:")			;
+ TToken			Ix						;
  
- int result = ParseParams(str,Dlm,0,Val,cntPrm,0)	;
- if(Val[2]>=0){ FIxInSMS = Val[2]		;}//    
+ Tkn.Skip(2)	; Tkn.Next(&Ix)			;
+ if(Ix.Int(-1)>=0){
+   if(flRdAllSMS || (FIxInSMS >= 0 && FIxInSMS != Ix.Int())){ flRdAllSMS = 1	; FIxInSMS = -1	;}//     -   
+   else FIxInSMS = Ix.Int()	;//   
+   MarkInSMS()	;}
  
- timTxPause = TIM_TX_PAUSE				;//   TX 
  return	msgMsg	;}
 //***************************************************************
-// +CMT: "+79131236578",,"14/03/21,19:16:04+28"
+//  PDU:   -  PDU,    ParsePduSMS()
+// +CMT: ,25
+// 07919761980614F8040B919721436587F90000...
 uint16_t	TUsartGSM::ParseCMT(char* str)		//  ! ,     
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 6, lenPrm = 16	;
- char			Prm[cntPrm][lenPrm]		;
- char*			pPrm = &Prm[0][0]		;
- int			Val[cntPrm]				;
- char			Dlm[] = ",:"			;
- 
- int result = ParseParams(str,Dlm,pPrm,Val,cntPrm,lenPrm)	;
-
- char*	pNmbr = strchr(Prm[1],'\"')							;
- if(pNmbr){
-   strncpy(PhoneNmbrSMS,pNmbr,16)							;//   ! 
-   if(!StrCmp(PhoneNmbrSMS,strValidNmbr))					 //     "+79"    SMS!
-     flWaitSMS = 1											;//      
-   else{ *PhoneNmbrSMS = 0									;}
- }
+
+ *PhoneNmbrIn = 0	; flWaitSMS = 2	; MarkInSMS()		;//      
  flNeedCNMI = 1							;//   CNMI!!!
- timTxPause = TIM_TX_PAUSE				;//   TX 
  return	msgMsg	;}
 //***************************************************************
 //     " "
 // sample: 
-//	+CMGR: "REC UNREAD","+79231234567","","14/03/21,19:16:04+28"
-//	45,stop
+//	+CMGR: 0,,25						 0 - REC UNREAD
+//	07919761980614F8040B919721436587F90000...
 //	OK
 uint16_t	TUsartGSM::ParseCMGR(char* str)
 {uint16_t		msgMsg = msgEmpty		;
- const int		cntPrm = 6, lenPrm = 16	;
- char			Prm[cntPrm][lenPrm]		;
- char*			pPrm = &Prm[0][0]		;
- int			Val[cntPrm]				;
- char			Dlm[] = ","				;
- int			isUnread = 0			;
+ TTokenizer		Tkn(str,",:")			;
+ TToken			Stat					;
  
 // flNeedCNMI = 1							;//   CNMI!!!
- int result = ParseParams(str,Dlm,pPrm,Val,cntPrm,lenPrm)	;
- char*	str2 = strchr(Prm[0],'\"')							;
- if(str2 && !StrCmp(str2+1,"REC UNR")) isUnread = 1			;
- 
- strncpy(PhoneNmbrSMS,Prm[1],16)							;//   ! 
- if(isUnread && !StrCmp(PhoneNmbrSMS,strValidNmbr))			 //     "+79"    SMS!
-   flWaitSMS = 1											;//      
- else{ *PhoneNmbrSMS = 0				;}
+ Tkn.Skip(1)	; Tkn.Next(&Stat)		;
+ *PhoneNmbrIn = 0						;
+ if(Stat.Int(-1) == 0) flWaitSMS = 1	;//      
  
- timTxPause = TIM_TX_PAUSE*5			;//    TX 
  return	msgMsg	;}
 //***************************************************************
-
-//***************************************************************
-// >> 0020 041F 0440 0438 043C 0435 0440 0447 0438 043A
-// ++        CF   F0   E8   EC   E5   F0   F7   E8   EA
-// >> 00340035002C043F04400438043C0435044004470438043A0020043D043E043C043504400020043404320430003D00340038
-//static	char	Smpl[]="00340035002C043F04400438043C0435044004470438043A0020043D043E043C043504400020043404320430003D00340038";
-char*	TUsartGSM::DecodeHEX_SMS(char* str,char* buf)
-{u16			hVal						;
- u8*			uVal = (u8*)&hVal			;
- char			*end , start[8] = "0000"	;
- int			len = (str && *str) ? strlen(str) : 0	;
+//      "   ", PDU -  
+// sample: 
+//	+CMGL: 1,0,,25
+//	07919761980614F8040B919721436587F90000...
+//	+CMGL: 2,0,,140
+//	07919761980614F8440B919721436587F90000...	  
+//	OK
+uint16_t	TUsartGSM::ParseCMGL(char* str)
+{uint16_t		msgMsg = msgEmpty		;
+ TTokenizer		Tkn(str,",:")			;
+ TToken			Stat					;
  
- if(!len || (len % 4)) str = buf = 0		;//      4
+ Tkn.Skip(2)	; Tkn.Next(&Stat)		;
+ FCntRdSMS++	; *PhoneNmbrIn = 0		;
+ if(Stat.Int(-1) == 0) flWaitSMS = 1	;//      
  
- start[4] = 0			;
- for(int ix=0;str && str[ix*4] && buf;ix++){
-   strncpy(start,str+ix*4,4)				;
-   hVal = strtoul(start,&end,16)			;
-   if(end-start==4) buf[ix] = uVal[0] + ((uVal[1] != 4) ? 0:0xB0)	;
-   else buf = 0	;   
- }
-
- return buf	;}
+ return	msgMsg	;}
 //***************************************************************
 
 //***************************************************************
-int		TUsartGSM::FnListenData(void* Buf,int Len)	// callback  CDC
-{char*	Str = (char*)Buf	;
- Log.d(Str)	; 
- if(Instance){
-   for(int ix=0;Str && Str[ix] && ix<Len;ix++) Instance->FifoRx.In(Str[ix])	;
- }
+int		TUsartGSM::FnListenData(void* Ctx,void* Buf,int Len)	// callback  CDC
+{TUsartGSM*	gsm = (TUsartGSM*)Ctx	;
+ char*		Str = (char*)Buf		;
+ LOG_D(LOG_GSM,"%.*s",Len,Str)	; 
+ if(gsm && gsm->FifoRx.Write(Str,Len) && gsm->FifoRx.GetCntStr()) EvQueue.PostOnce(evGsmRx)	;//    
  return 0	;}
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-void	TUsartGSM::FnMdmInit(void)		// callback  CDC Mdm
+char*	TUsartGSM::FnGetRxBuff(void* Ctx,int* Len)	// callback  CDC:   
+{
+ if(Len) *Len = 0	;
+ return Ctx ? ((TUsartGSM*)Ctx)->FifoRx.GetWrBuf(Len) : 0	;}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+int		TUsartGSM::FnCommitRx(void* Ctx,int Len)	// callback  CDC:    FifoRx
+{TUsartGSM*	gsm = (TUsartGSM*)Ctx	;
+ int		n	;
+
+ if(!gsm) return Len	;
+ n = gsm->FifoRx.Commit(Len)	;//    -  ,    GetS
+ if(n && gsm->FifoRx.GetCntStr()) EvQueue.PostOnce(evGsmRx)	;
+ return n	;}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+char*	TUsartGSM::FnGetTxBuff(void* Ctx,int* Len)	// callback  CDC:   (  OTG)
+{
+ if(Len) *Len = 0	;
+ return Ctx ? ((TUsartGSM*)Ctx)->FifoTx.GetRdBuf(Len) : 0	;}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+void	TUsartGSM::FnCommitTx(void* Ctx,int Len)	// callback  CDC: Len   
+{
+ if(Ctx) ((TUsartGSM*)Ctx)->FifoTx.Skip(Len)	;}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+int		TUsartGSM::FnGetTxLen(void* Ctx)	// callback  CDC:    DropTx
 {
- Log.d("InitMDM OK\n")	;
- if(Instance){ Instance->InitGSM()		;}
+ return Ctx ? ((TUsartGSM*)Ctx)->FifoTx.GetLen() : 0	;}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+void	TUsartGSM::FnMdmInit(void* Ctx)	// callback  CDC Mdm
+{TUsartGSM*	gsm = (TUsartGSM*)Ctx	;
+
+ LOG_I(LOG_GSM,"InitMDM OK #%d\n",gsm ? gsm->SchedId : -1)	;
+ if(gsm){ gsm->InitGSM()		;}
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+void	TUsartGSM::FnMdmLost(void* Ctx)	// callback  CDC:    
+{TUsartGSM*	gsm = (TUsartGSM*)Ctx	;
+
+ LOG_W(LOG_GSM,"MDM lost #%d\n",gsm ? gsm->SchedId : -1)	;
+ if(gsm){ gsm->LostGSM()		;}
 }
 //***************************************************************
-void	TUsartGSM::Init(void)
+//  -   pdev,      sched.   sched -
+//   Value  TmrOut: evGsmTimeOut    .
+void	TUsartGSM::Init(TSmsSched* sched,USB_OTG_CORE_HANDLE* pdev)
 {const	char	EndS[] = "\n>"			;//  " "
- Instance = this	;
- SetFifoRx(GsmBufRx,LenBF,0,EndS)		;
- SetFifoTx(GsmBufTx,LenBF)				; 
+ Sched = sched	; SchedId = sched->Add()	; TmrOut.Value = (short)SchedId	;
+ SetFifoRx(BufRx,LenFIFO,0,EndS)		;
+ SetFifoTx(BufTx,LenFIFO)				; 
  FnGetInfSMS = 0	; //FnGetPswGSM = 0	; FnSetPswGSM = 0	;
 // TUsart::InitHW(USART_GSM,9600)			;
- flEventNeed = 0	;
+ flEventNeed = 0	; TickLost = 0	;
+ FIxRdSMS = FIxDelSMS = FIxInSMS = -1	;//   
  
- FnWriteBuff = USBH_CDC_WriteBuff		;
- cbUSBH_CDC_ListenData = FnListenData	;
- cbUSBH_CDC_MDM_Init   = FnMdmInit		;
+ FnStartTx = USBH_CDC_StartTx	; FnDropTx = USBH_CDC_DropTx	; Dev = &Cdc	;
+ USBH_CDC_Bind(&Cdc,pdev,&CdcCb,this)	;
  
  InitHW()			;
 }
@@ -719,20 +927,40 @@ void	TUsartGSM::InitGSM(void)
 {flMdmPresent = 0			; strMsg = 0	;
  FCntMemSMS = FTtlMemSMS = FLenSMS = FReadAll = 0			;
  State = StateTrg = sttNone	; 
- *PhoneNmbrSMS = *PhoneNmbrCall = *PhoneNmbrOut = 0			;
- timGuardSMS = 0			;
+ *PhoneNmbrCall = *PhoneNmbrOut = *PhoneNmbrIn = 0	;
+ SmsIx = -1					; MsgAwt = msgEmpty			;//    .   
+ Sched->SetUp(SchedId,0)	;//      ;    
 		 
 // StoreFlash.Init(BANK_STORE_GSM,PAGE_CNT_GSM,0)	;
 // StoreFlash.RestoreRec(&StoreRec)				;
 
  PswGSM = FnGetPswGSM ? FnGetPswGSM():0		;
  sprintf(StrDbg,"PswGSM = %d,%s",PswGSM,GetMasterNmbr())	; strMsg = StrDbg	;
- FIxRdSMS=FIxDelSMS=FIxMemSMS=FIxInSMS=-1	;
+ FCntRdSMS = 0								;
  flWaitSMS = 0								;
- flInCall=flInSMS=flNeedCNMI=flGetCNMI=flDelAllSMS=flInitOK=0		;
+ flInCall=flInSMS=flNeedCNMI=flGetCNMI=flDelAllSMS=flRdAllSMS=flInitOK=0	;
 
+ TickInit = Clock.Now()	; PrbCnt = 0	; PrbWait = TIM_PROBE_FIRST	;
  flINIT = 1		;
- timOut = 5000	;//  5   !!!
+ flTimeOut = 0	; Timers.Start(&TmrOut,TickInit + TIM_PROBE_FIRST)	;//  -   AT
+}
+//***************************************************************
+// USB  ( ,  ):   ,
+//  - .   -       ( 
+//    ),   .   
+// ,   (TickInSMS)     .
+//    -  FifoRx/FifoTx   ,  .
+void	TUsartGSM::LostGSM(void)
+{
+ if(StateTrg == sttRD_SMS && State != StateTrg && FIxDelSMS >= 0 && FIxInSMS < 0){
+   FIxInSMS = FIxDelSMS	; FIxDelSMS = -1	;}// CMGR ,    
+ flMdmPresent = 0		; TickLost = Clock.Now() | 1	;
+ State = StateTrg = sttOFF	; MsgAwt = msgEmpty	; SmsIx = -1	;
+ flTimeOut = flWaitSMS = 0	; strRcv = 0	; cntRcv = 0	;
+ Timers.Stop(&TmrOut)	; Timers.Stop(&TmrSms)	;
+ ResetFiFo()			;
+ Sched->SetUp(SchedId,0)	; Sched->SetIdle(SchedId,0)	;
+ EvQueue.Post(evGsmRx)	;//     
 }
 //***************************************************************
 void	TUsartGSM::InitHW(void)
@@ -754,45 +982,55 @@ void	TUsartGSM::InitHW(void)
 // GPIO_Init(STT_PORT, &GPIO_InitStructure)				; 
 }
 //***************************************************************
-char*	TUsartGSM::GetS(char* buf,int maxLen)
+//    FifoRx    GetS, buf -    
+char*	TUsartGSM::GetS(char* buf,int maxLen,int* len)
 {
- if(buf && maxLen>0 && FifoRx.CntStr>0){ 
-   DisableRxIRQ()					;
-   buf = FifoRx.GetS(buf,maxLen)	;
-   EnableRxIRQ()					;
+ if(len) *len = 0					;
+ if(buf && maxLen>0 && FifoRx.GetCntStr()>0){ 
+   buf = FifoRx.GetS(buf,maxLen,len);// SPSC,    
+   if(USBH_CDC_RxParked(Dev)) EvQueue.PostOnce(evUsbIrq)	;//     FifoRx -  ,  Handle
  }
  else buf = 0						;
  
  return buf							;}
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-void	TUsartGSM::WriteString(char* Str)
+// FifoTx -   : WriteString* ,  - 
+// OTG (USBH_CDC_OnURB),     ,   . 
+//     . Flush   ,   .
+void	TUsartGSM::Flush(void)
 {
- FifoTx.Reset()		;
-
- for(int ix=0;Str && Str[ix];ix++) FifoTx.In(Str[ix])	;
+ if(FnStartTx) FnStartTx(Dev)		;
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//  FifoTx - : Reset()  ,   CDC
+void	TUsartGSM::DropTx(void)
+{
+ if(FnDropTx) FnDropTx(Dev)			;
+ else FifoTx.Reset()				;
+}
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+void	TUsartGSM::WriteString(const char* Str)
+{
+ if(Str) FifoTx.Write(Str,strlen(Str))	;
 
- if(FnWriteBuff) FnWriteBuff(FifoTx.GetBuf(),FifoTx.GetLen())	;
+ Flush()			;
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 void	TUsartGSM::WriteStringLN(const char* Str)
 {
- FifoTx.Reset()		;
-
- for(int ix=0;Str && Str[ix];ix++) FifoTx.In(Str[ix])	;
- FifoTx.In('\r')	; FifoTx.In('\n')	;
+ if(Str) FifoTx.Write(Str,strlen(Str))	;
+ FifoTx.Write("\r\n",2)				;
 
- if(FnWriteBuff) FnWriteBuff(FifoTx.GetBuf(),FifoTx.GetLen())	;
+ Flush()			;
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 void	TUsartGSM::WriteStringLN_P(const char* Str,const char* Prm)
 {
- FifoTx.Reset()		;
+ if(Str) FifoTx.Write(Str,strlen(Str))	;
+ if(Prm) FifoTx.Write(Prm,strlen(Prm))	;
+ FifoTx.Write("\r\n",2)				;
  
- for(int ix=0;Str && Str[ix];ix++) FifoTx.In(Str[ix])	;
- for(int ix=0;Prm && Prm[ix];ix++) FifoTx.In(Prm[ix])	;
- FifoTx.In('\r')	; FifoTx.In('\n');
- 
- if(FnWriteBuff) FnWriteBuff(FifoTx.GetBuf(),FifoTx.GetLen())	;
+ Flush()			;
 }
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //int TUsartGSM::SendChar(int ch)
@@ -808,56 +1046,9 @@ void	TUsartGSM::DisableRxIRQ(void){}
 void	TUsartGSM::EnableTxIRQ (void){}
 void	TUsartGSM::DisableTxIRQ(void){}
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-//       !!!!!
-void	TUsartGSM::FOnTimer(void)
-{
- if(timOperate >0) timOperate--		;
- if(timOut     >0) timOut--			;
- if(timRepeat  >0) timRepeat--		;
- if(timGuardSMS>0) timGuardSMS--	;
- if(timTxPause >0) timTxPause--		;//  ,  UART GSM      
-}
 //***************************************************************
-void	TUsartGSM::OnTimer(void){if(Instance) Instance->FOnTimer()	;}
-//***************************************************************
-
 
 
-//***************************************************************
-int	ParseParams(char* str,char* dlm,char* Prm,int* Val,const int CntPrm,const int LenPrm)
-{int		result = 0						;
- int		ix=0,ixPrm=0,ixP=0				;
- int		isDlm=0,endStr=0				;
- const int	lenBufPrm = 20					;
- char		bufPrm[lenBufPrm]				;
- char*		cPrm     = bufPrm				;
- int		lenPrm   = lenBufPrm			;
 
- if(str && *str && dlm && *dlm && CntPrm){
-   cPrm   = (Prm  && LenPrm) ? Prm + ixPrm*LenPrm : bufPrm	;
-   lenPrm = (Prm  && LenPrm) ? LenPrm     : lenBufPrm		;
-   ixP = 0	;
- 
-   for(ix=0;ixPrm < CntPrm && !endStr && cPrm;ix++){
-     isDlm = 0	;
-	 for(int ixD=0;dlm[ixD];ixD++){							 //   - ?
-       if(str[ix] == dlm[ixD]){ isDlm = 1	; break	;}}
-     if(str[ix] == '\r' || str[ix] == '\n' || !str[ix]) endStr = 1	;//   ?
-	 
-	 if(!isDlm && !endStr){											//       
-	   if(ixP < lenPrm-1) cPrm[ixP++] = str[ix]		;}
-	 else{
-	   cPrm[ixP] = 0		; ixP = 0	;							// 
-       if(Val) Val[ixPrm] = atoi(cPrm)	;
-	   result = (++ixPrm)				;
-	   if(ixPrm >= CntPrm) endStr = 1	;
-	   if(!endStr){
-         cPrm   = (Prm && LenPrm) ? Prm + ixPrm*LenPrm : bufPrm		;
-         lenPrm = (Prm && LenPrm) ? LenPrm     : lenBufPrm			;
-	   }
-	 }
-   }
- }
- return result		;}
 //***************************************************************
 #pragma diag_suppress 177
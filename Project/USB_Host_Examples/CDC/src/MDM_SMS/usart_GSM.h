@@ -5,13 +5,20 @@
 #include		<stdint.h>
 #include		"EventGUI.h"
 #include		"FiFo.h"
+#include		"Pdu.h"
+#include		"SmsSched.h"
+#include		"TimerWheel.h"
 #include		"usbh_msc_core.h"
 //#include		"Store.h"
 //*******************************************************************
 typedef char*		(*TGetString)(char*,int)		;
+typedef int			(*TGetText)(char* Buf,int Size,int Pos)	;// Buf=0 -  ,    Pos
 typedef	uint32_t	(*TGetUInt32Value)(void)		;
 typedef	void		(*TSetUInt32Value)(uint32_t)	;
-typedef	USBH_Status	(*TWriteBuff)(void* Data,int Len)		;
+typedef	USBH_Status	(*TStartTx)(void* Dev)			;
+//*******************************************************************
+#define		GSM_LEN_FIFO		1024	//  !  PDU -  350 .
+#define		GSM_LEN_BF			200		//     
 //*******************************************************************
 #pragma	pack(push,1)
 //-----------------------------------------------------
@@ -33,22 +40,32 @@ typedef	USBH_Status	(*TWriteBuff)(void* Data,int Len)		;
 //} TGSM_Stage	;
 //==================================================
 //*******************************************************************
+struct	TAnsGSM	;
+//*******************************************************************
 class	TUsartGSM/*:public TUsart*/{
 // TStoreFlash			StoreFlash				;
 // TStoreRecordGSM		StoreRec				;
- int					timOperate				;
- int					timOut,timRepeat		;
- int					timGuardSMS				;//     
- int					timTxPause				;//  ,  UART GSM      
+ TTimer					TmrOut					;//   Operate ( )
+ TTimer					TmrSms					;//     Sched
+ uint32_t				Ticks					;// Clock.Now()    OnEvent
+ uint32_t				TickInSMS				;//    (/), 0 - 
+ uint32_t				TickInit				;// MdmInit:   AT
+ uint32_t				TickLost				;//    USB, 0 -  ( )
+ int					PrbWait					;//     AT, 
+ short					PrbCnt					;
  short					FLenSMS					;
  char					FCntMemSMS,FTtlMemSMS	;
- char					FIxInSMS,FIxMemSMS		;
+ char					FIxInSMS,FCntRdSMS		;// FCntRdSMS -     CMGL
  char					FIxRdSMS,FIxDelSMS		;// ,   , 
  char					FPrsSMS,FReadAll		;
- char					NeedSendSMS				;
+ int					SmsIx					;//  ,  , -1 - 
+ TSmsSched*				Sched					;//     
+ int					SchedId					;//    Sched
+ uint8_t				SmsRef,SmsCnt,SmsSeq	;//   : , , 
+ int					SmsLen,SmsPos			;//  ,   
  char					SttPhase,prSttPhase		;
  char					PhoneNmbrCall[20]		;
- char					PhoneNmbrSMS[20]		;
+ char					PhoneNmbrIn[20]			;//   
  char					PhoneNmbrOut[20]		;
  char					TextInSMS[200]			;
  uint32_t				PswGSM					;
@@ -58,28 +75,47 @@ class	TUsartGSM/*:public TUsart*/{
  char					flEventNeed,flEventMsg	;
  char					flINIT,flValueNeed		;
  char					flInitOK				;
- char					flWaitSMS				;//   
+ char					flTimeOut				;// TmrOut 
+ char					flWaitSMS				;//  PDU: 1 -  +CMGR/+CMGL, 2 -  +CMT
  char					flInCall,flInSMS		;
  char					flNeedCNMI,flGetCNMI	;
  char					flDelAllSMS				;
+ char					flRdAllSMS				;//    ,   
 
  TFiFo					FifoRx		;
  TFiFo					FifoTx		;
+ char					BufRx[GSM_LEN_FIFO]	;
+ char					BufTx[GSM_LEN_FIFO]	;
+ char					PduOutBuf[PDU_LEN_HEX]	;//    "> " -    
+ char					RcvBuf[PDU_LEN_HEX]		;// ,    FifoRx
+ char					SmsInBuf[GSM_LEN_BF]	;//    -  
+ char					SmsOutBuf[GSM_LEN_BF]	;//     FnGetInfSMS
+ char					StrDbg[GSM_LEN_BF]		;
+ char					StrMasterNmbr[40]		;
+ const char*			strMsg					;//      Poll (StrDbg/SmsInBuf)
+ USBH_CDC_Dev			Cdc			;//      OTG
+ TPduAssm				PduAssm		;//   
+
+ static const TAnsGSM	TblAns[]	;//   
+ static const int		CntAns		;
+ static const USBH_CDC_Cb_TypeDef	CdcCb	;
 
 public:
  int					flMdmPresent				;
  int/*TGSM_State*/		State,StateTrg,prStateTrg	;//    
 // TGSM_Stage				Stage,StageTrg			;//    
 // int					StgPhase					;
- int					MsgAwt						;//  
-
- static TUsartGSM*		Instance					;
+ int					MsgAwt						;//    , 0 - 
+ int					LatSMS,LatSMSMax			;//  ->   , 
+ void*					Dev							;//  FnStartTx/FnDropTx
 
 				TUsartGSM(void)						;
 
  void					InitGSM(void)				;
+ void					LostGSM(void)				;//    USB:  
  void					InitHW(void)				;
- void					Init(void)					;
+ void					Init(TSmsSched* sched,USB_OTG_CORE_HANDLE* pdev)	;
+ int					GetId(void){ return SchedId	;}
  
  void					SetFifoRx(char* buf,int size,callbackIfCR fnIfCR=0,const char* strEndS=0)
 						{ FifoRx.Set(buf,size,fnIfCR,strEndS)	;}
@@ -87,38 +123,56 @@ public:
 						{ FifoTx.Set(buf,size,fnIfCR,strEndS)	;}
  void					ResetFiFo(void){ FifoRx.Reset()	; FifoTx.Reset()	;}
 
- void					WriteString(char* Str)					;
+ void					WriteString(const char* Str)			;
  void					WriteStringLN(const char* Str)			;
  void					WriteStringLN_P(const char* Str,const char* Prm)	;
- int					SendChar(int ch)						;
- char*					GetS(char* buf,int lenBuf)				;//   ,  
+ char*					GetS(char* buf,int lenBuf,int* len=0)	;//   ,  
+ void					Flush(void)								;// FifoTx -> 
+ void					DropTx(void)							;//  
  __inline void			EnableRxIRQ(void)	;
  __inline void			DisableRxIRQ(void)	;
  __inline void			EnableTxIRQ(void)	;
  __inline void			DisableTxIRQ(void)	;
  
  EVENT_TYPE				OnEvent(TEvent* Event)				;
-		void			FOnTimer(void)						;
- static void			OnTimer(void)						;
+ void					Poll(void)							;//     
+ uint32_t				GetTicks(void){ return Ticks		;}
 			
 //		void			ReceiveBuf (class TFiFo* fifo,int cnt)	;
 // static void			FReceiveBuf(class TFiFo* fifo,int cnt)	;
 // void					ReqCntSMS(void)						;
  TGetUInt32Value		FnGetPswGSM							;
  TSetUInt32Value		FnSetPswGSM							;
- TGetString				FnGetInfSMS							;
- TWriteBuff				FnWriteBuff							;
- static	int				FnListenData(void* Buf,int Len)		;
- static void			FnMdmInit(void)						;
+ TGetText				FnGetInfSMS							;//  . ,  
+ TStartTx				FnStartTx							;
+ TStartTx				FnDropTx							;
+ static	int				FnListenData(void* Ctx,void* Buf,int Len)	;
+ static	char*			FnGetRxBuff(void* Ctx,int* Len)		;
+ static	int				FnCommitRx(void* Ctx,int Len)		;
+ static	char*			FnGetTxBuff(void* Ctx,int* Len)		;
+ static	void			FnCommitTx(void* Ctx,int Len)		;
+ static	int				FnGetTxLen(void* Ctx)				;
+ static void			FnMdmInit(void* Ctx)				;
+ static void			FnMdmLost(void* Ctx)				;
 private:
  uint16_t				OnEventGSM(void)					;
  uint16_t				Parse(char* str,int cnt)			;
+ const TAnsGSM*			FindAns(const char* str)			;
+ void					OnURC(const TAnsGSM* ans,char* str)	;
+ int					IsAwaited(int Msg)					;// Msg -    ?
+ int					Await(int Msg,int tim)				;//  Msg   tim 
  uint16_t				ParseCPMS(char* str)				;
  uint16_t				ParseCMGR(char* str)				;
+ uint16_t				ParseCMGL(char* str)				;
  uint16_t				ParseCMTI(char* str)				;
  uint16_t				ParseCMT (char* str)				;
  uint16_t				ParseCLIP(char* str)				;
- char*					DecodeHEX_SMS (char* str,char* buf)	;
+ void					MarkInSMS(void){ if(!TickInSMS) TickInSMS = Ticks | 1	;}
+ void					QueueSMS(const char* nmbr,int prio)	;//  .   
+ void					EndSMS(int ok)						;//   -> Sched
+ uint16_t				ParsePduSMS(char* str)				;
+ int					GetPartSMS(int pos,int* len)		;//     pos
+ int					NextPartSMS(void)					;//  AT+CMGS  
  uint16_t				ParseSMS (char* str)				;
  uint16_t				ParseTextSMS (char* str)			;
  
@@ -135,6 +189,8 @@ private:
  int					Operate_IDLE(int Msg=0)				;//   
  int					Operate_SetCNMI(int Msg)			;
  int					Operate_GetCNMI(int Msg)			;
+ int					Operate_RD_ALL_SMS(int Msg)			;
+ int					Operate_DEL_RD_SMS(int Msg)			;
 
  char*					GetMasterNmbr(void)					;
  void					SetMasterNmbr(char* src)			;
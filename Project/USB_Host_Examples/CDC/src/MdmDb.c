@@ -0,0 +1,114 @@
+#include	"MdmDb.h"
+#include	<string.h>
+#if			!defined(MDMDB_HOST) || defined(MDMDB_HOST_FLASH)	//   flash  FatFS  
+#include	<stm32f4xx.h>
+#include	"ff.h"
+#include	"Log.h"
+#define		MDMDB_FLASH
+#endif
+//===============================================
+#define		MDMDB_VER			1
+#define		MDMDB_KEY(v,p)		(((uint32_t)(v) << 16) | (p))
+//===============================================
+static const TMdmDbHdr*		Db		= 0	;//  
+static const TMdmRec*		DbRec	= 0	;
+//===============================================
+uint32_t	MdmDbCrc(uint32_t crc,const void* data,uint32_t len)
+{const uint8_t*	ptr = (const uint8_t*)data	;
+ int			bit	;
+
+ crc = ~crc	;
+ while(len--){ crc ^= *ptr++	;
+   for(bit=0;bit<8;bit++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)))	;}
+ return ~crc	;}
+//===============================================
+//   : , ,  , CRC.
+int			MdmDbCheck(const void* img,uint32_t size)
+{const TMdmDbHdr*	hdr = (const TMdmDbHdr*)img	;
+ const TMdmRec*		rec	;
+ uint32_t			ix, key, prev = 0	;
+
+ if(!img || size < sizeof(*hdr)) return -1	;
+ if(hdr->Sign != MDMDB_SIGN || hdr->Ver != MDMDB_VER || hdr->Cnt > MDMDB_CNT_MAX) return -1	;
+ if(sizeof(*hdr) + hdr->Cnt*sizeof(TMdmRec) > size) return -1	;
+
+ rec = (const TMdmRec*)(hdr + 1)	;
+ for(ix=0;ix<hdr->Cnt;ix++,rec++){
+   key = MDMDB_KEY(rec->Vid,rec->Pid)	;
+   if((ix && key <= prev) || rec->MsgLen > MDMDB_MSG_MAX) return -1	;//    
+   prev = key	;}
+ if(MdmDbCrc(0,hdr + 1,hdr->Cnt*sizeof(TMdmRec)) != hdr->Crc) return -1	;
+ return hdr->Cnt	;}
+//===============================================
+int			MdmDbSet(const void* img,uint32_t size)
+{
+ if(MdmDbCheck(img,size) < 0) return 0	;
+ Db = (const TMdmDbHdr*)img	; DbRec = (const TMdmRec*)(Db + 1)	;
+ return 1	;}
+//===============================================
+const TMdmRec*	MdmDbFind(uint16_t vid,uint16_t pid)
+{uint32_t	key = MDMDB_KEY(vid,pid), mid	;
+ int		lo = 0, hi = Db ? (int)Db->Cnt - 1 : -1, ix	;
+
+ while(lo <= hi){
+   ix  = (lo + hi) >> 1	;
+   mid = MDMDB_KEY(DbRec[ix].Vid,DbRec[ix].Pid)	;
+   if(mid == key) return DbRec + ix	;
+   if(mid < key) lo = ix + 1	; else hi = ix - 1	;}
+ return 0	;}
+//===============================================
+#ifdef		MDMDB_FLASH
+void		MdmDbInit(void)
+{
+ if(MdmDbSet((const void*)MDMDB_FLASH_ADDR,MDMDB_FLASH_SIZE)){
+   LOG_I(LOG_CDC,"MdmDb: flash, %d\n",Db->Cnt)	; return	;}
+ MdmDbSet(MdmDbRom,MdmDbRomSize)	;
+ LOG_I(LOG_CDC,"MdmDb: rom, %d\n",Db ? Db->Cnt : 0)	;}
+//===============================================
+//   :  CRC (     
+// ),  -  flash.   :  
+//   ,       .
+//   (~1 )   flash -    MSC.
+int			MdmDbUpdate(void)
+{static uint32_t	buf[64]				;
+ static FIL			file				;
+ const TMdmDbHdr*	old = (const TMdmDbHdr*)MDMDB_FLASH_ADDR	;
+ TMdmDbHdr			hdr					;
+ UINT				rd					;
+ uint32_t			len, pos, crc = 0, addr, ix	;
+ int				ok = 0				;
+
+ if(f_open(&file,MDMDB_FILE,FA_READ | FA_OPEN_EXISTING) != FR_OK) return 0	;
+ if(f_read(&file,&hdr,sizeof(hdr),&rd) != FR_OK || rd != sizeof(hdr) ||
+	hdr.Sign != MDMDB_SIGN || hdr.Ver != MDMDB_VER || hdr.Cnt > MDMDB_CNT_MAX ||
+	file.fsize != sizeof(hdr) + hdr.Cnt*sizeof(TMdmRec)){
+   LOG_W(LOG_CDC,"MdmDb: %s bad\n",MDMDB_FILE)	; f_close(&file)	; return 0	;}
+ if(MdmDbCheck(old,MDMDB_FLASH_SIZE) >= 0 && old->Crc == hdr.Crc && old->Cnt == hdr.Cnt){
+   f_close(&file)	; return 0	;}//  
+
+ len = hdr.Cnt*sizeof(TMdmRec)	;
+ for(pos=0;pos < len;pos += rd){
+   if(f_read(&file,buf,sizeof(buf),&rd) != FR_OK || !rd) break	;
+   crc = MdmDbCrc(crc,buf,rd)	;}
+ if(pos != len || crc != hdr.Crc){
+   LOG_W(LOG_CDC,"MdmDb: %s crc\n",MDMDB_FILE)	; f_close(&file)	; return 0	;}
+
+ f_lseek(&file,sizeof(hdr))	;
+ FLASH_Unlock()	;
+ FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)	;
+ if(FLASH_EraseSector(FLASH_Sector_11,VoltageRange_3) == FLASH_COMPLETE){
+   addr = MDMDB_FLASH_ADDR + sizeof(hdr)	; ok = 1	;
+   for(pos=0;ok && pos < len;pos += rd){		 //  -  4 
+     if(f_read(&file,buf,sizeof(buf),&rd) != FR_OK || !rd){ ok = 0	; break	;}
+     for(ix=0;ok && ix < rd/4;ix++,addr += 4) ok = FLASH_ProgramWord(addr,buf[ix]) == FLASH_COMPLETE	;}
+   for(ix=0;ok && ix < sizeof(hdr)/4;ix++)
+     ok = FLASH_ProgramWord(MDMDB_FLASH_ADDR + ix*4,((uint32_t*)&hdr)[ix]) == FLASH_COMPLETE	;
+ }
+ FLASH_Lock()	; f_close(&file)	;
+
+ ok = ok && MdmDbSet(old,MDMDB_FLASH_SIZE)	;
+ if(!ok) MdmDbSet(MdmDbRom,MdmDbRomSize)	;
+ LOG_I(LOG_CDC,"MdmDb: update %s, %d\n",ok ? "ok" : "err",Db ? Db->Cnt : 0)	;
+ return ok	;}
+#endif
+//===============================================
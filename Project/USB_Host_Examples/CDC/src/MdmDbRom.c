@@ -0,0 +1,14 @@
+//  tools/mdmdb.py  modems.txt -   !
+//   12D1:155B
+//   19D2:2000
+#include	"MdmDb.h"
+//===============================================
+const uint32_t	MdmDbRom[]={
+  0x3142444D,0x00020001,0x7BFC821A,0x155B12D1,0x1FFF62FF,0x00000BB8,
+  0x43425355,0x78563412,0x00000000,0x11000000,0x00002006,0x00000001,
+  0x00000000,0x00000000,0x200019D2,0x1F01FFFF,0x00000BB8,0x43425355,
+  0x00000292,0x00000000,0x1B060000,0x02000000,0x00000000,0x00000000,
+  0x00000000,
+};
+const uint32_t	MdmDbRomSize = sizeof(MdmDbRom)	;
+//===============================================
@@ -0,0 +1,29 @@
+#include	"Trace.h"
+#include	"Log.h"
+//===============================================
+#ifndef		LOG_HOST
+#define		TRACE_TIME()		(*(volatile uint32_t*)0xE0001004)	// DWT CYCCNT,  Clock.Init()
+#else
+#include	<time.h>
+#define		TRACE_TIME()		((uint32_t)clock())
+#endif
+//===============================================
+static uint8_t*		TracePut(uint8_t* p,uint32_t val)
+{
+ p[0] = (uint8_t)val	; p[1] = (uint8_t)(val >> 8)	;
+ p[2] = (uint8_t)(val >> 16)	; p[3] = (uint8_t)(val >> 24)	;
+ return p + 4	;}
+//-----------------------------------------------
+//    LogWrite:    (. LOG_DROP)
+void	TraceRec(const char* fmt,int n,uint32_t a0,uint32_t a1,uint32_t a2,uint32_t a3)
+{uint8_t	frm[2 + 4 + 4 + 4*TRACE_ARG_MAX], *p = frm	;
+
+ *p++ = TRACE_SYNC	; *p++ = (uint8_t)n	;
+ p = TracePut(p,(uint32_t)(uintptr_t)fmt)		;
+ p = TracePut(p,TRACE_TIME())		;
+ if(n > 0) p = TracePut(p,a0)		;
+ if(n > 1) p = TracePut(p,a1)		;
+ if(n > 2) p = TracePut(p,a2)		;
+ if(n > 3) p = TracePut(p,a3)		;
+ LogWrite((const char*)frm,(int)(p - frm))	;}
+//===============================================
@@ -1,5 +1,11 @@
 //------------------------------------------------------------------------
 #include	"UsbhCore.h"
+#include	"EventQueue.h"
+#include	"Clock.h"
+#include	"Log.h"
+#include	"DescCache.h"
+#include	"UsbhStat.h"
+#include	<stdio.h>
 //------------------------------------------------------------------------
 USB_OTG_CORE_HANDLE    USB_OTG_Core	;
 USBH_HOST              USB_Host		;
@@ -9,15 +15,45 @@ TUsbhCore*		TUsbhCore::Instance = 0		;
 void	TUsbhCore::Init(void)
 {Instance = this	;
  USBH_Init(&USB_OTG_Core,USB_OTG_FS_CORE_ID,&USB_Host,&USBH_MSC_cb,&USR_cb)	; 
+ USB_Host.desc_cb = &DescCacheCb	;//    USBH_Process
 }
 //------------------------------------------------------------------------
 EVENT_TYPE		TUsbhCore::OnEvent(TEvent* Event)
 {
  switch(Event->Type){
-   default : USBH_Process(&USB_OTG_Core, &USB_Host)	;
+   case evUsbIrq: USBH_Process(&USB_OTG_Core, &USB_Host)	;//  , , TmrProc
+				  if((USB_Host.gState != HOST_IDLE && USB_Host.gState != HOST_CLASS) || USBH_CDC_Pending(&USB_OTG_Core))
+				    Timers.Start(&TmrProc,Clock.Now() + 1)	;// ,   -   
+				  if(USB_Host.gState != HOST_CLASS) EnumDone = 0	;
+				  else if(!EnumDone){ EnumDone = 1	; OnEnumDone()	;}
+   break	;
+   case evUsbStat: UsbhStatLog(&USB_OTG_Core)	;
+				  LOG_I(LOG_USBH,"desc cache: hit %u miss %u drop %u flash %u erase %u\n",
+						DescCacheStat.CntHit,DescCacheStat.CntMiss,DescCacheStat.CntDrop,DescCacheStat.CntFlash,DescCacheStat.CntErase)	;
+   break	;
  }
  return	Event->Type	;}
 //------------------------------------------------------------------------
+//   :   -   .
+// ,    USBH_Process:       .
+void			TUsbhCore::OnEnumDone(void)
+{
+ LOG_I(LOG_USBH,"Enum %04X:%04X: %u us%s\n",USB_Host.device_prop.Dev_Desc.idVendor,USB_Host.device_prop.Dev_Desc.idProduct,
+	   USB_Host.EnumUs,USB_Host.DescCached ? ", cached" : "")	;
+ DescCacheSave(&USB_Host.device_prop)	;}
+//------------------------------------------------------------------------
+//  OTG     NAK:  main,   -
+//  -     (URB)  - .
+void			TUsbhCore::OnIRQ(void)
+{static uint32_t	prConn = 0						;
+ static URB_STATE	prUrb[USB_OTG_MAX_TX_FIFOS]		;
+ int				ix, chg = 0						;
+
+ if(USB_OTG_Core.host.ConnSts != prConn){ prConn = USB_OTG_Core.host.ConnSts	; chg = 1	;}
+ for(ix=0;ix<USB_OTG_MAX_TX_FIFOS;ix++)
+   if(USB_OTG_Core.host.URB_State[ix] != prUrb[ix]){ prUrb[ix] = USB_OTG_Core.host.URB_State[ix]	; chg = 1	;}
+ if(chg) EvQueue.PostOnce(evUsbIrq)				;}
+//------------------------------------------------------------------------
 void			TUsbhCore::FOnTimer(void)
 {
 }
@@ -6,17 +6,24 @@
 #include 	"usbh_usr.h"
 #include 	"usbh_msc_core.h"
 #include	"EventGUI.h"
+#include	"TimerWheel.h"
 //------------------------------------------------------------------------
+extern	USB_OTG_CORE_HANDLE		USB_OTG_Core	;
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
 class		TUsbhCore{
  
  static TUsbhCore*		Instance		;
+ TTimer					TmrProc			;//  
+ uint8_t				EnumDone		;//  , OnEnumDone  
+ 
+ void					OnEnumDone(void)					;
  public:
-			TUsbhCore(void){}
+			TUsbhCore(void):TmrProc(evUsbIrq),EnumDone(0){}
  
  
  EVENT_TYPE				OnEvent(TEvent* Event)				;
+ static void			OnIRQ(void)							;//   OTG
 		void			FOnTimer(void)						;
  static void			OnTimer(void)						;
  
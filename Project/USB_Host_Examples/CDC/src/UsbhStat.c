@@ -0,0 +1,23 @@
+#include	"UsbhStat.h"
+#include	"usb_hcd.h"
+#include	"Log.h"
+#include	<stdio.h>
+//===============================================
+void	UsbhStatLog(USB_OTG_CORE_HANDLE* pdev)
+{const HC_STAT*	st			;
+ char			str[LOG_LINE - 16]	;
+ int			ix, bin, pos	;
+
+ for(ix=0;ix<USB_OTG_MAX_TX_FIFOS;ix++){
+   st = HCD_GetStat(pdev,ix)	;
+   if(!st->Submit) continue		;
+   LOG_I(LOG_USBH,"hc%d ep%02X: sub %u rtr %u B %u ok %u nrdy %u err %u stall %u\n",ix,pdev->host.channel[ix] & 0xFF,
+		 st->Submit,st->Retry,st->Bytes,st->Urb[URB_DONE],st->Urb[URB_NOTREADY],st->Urb[URB_ERROR],st->Urb[URB_STALL])	;
+   LOG_I(LOG_USBH,"  nak %u nyet %u xact %u bbl %u tgl %u\n",
+		 st->Ev[HC_NAK],st->Ev[HC_NYET],st->Ev[HC_XACTERR],st->Ev[HC_BBLERR],st->Ev[HC_DATATGLERR])	;
+   for(bin=0,pos=0;bin<HC_STAT_LAT_CNT && pos < (int)sizeof(str)-24;bin++)
+     if(st->Lat[bin]) pos += sprintf(str + pos," <%lu:%u",2ul << bin,st->Lat[bin])	;
+   if(pos) LOG_I(LOG_USBH,"  lat us%s\n",str)	;
+ }
+}
+//===============================================
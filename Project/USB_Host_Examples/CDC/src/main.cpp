@@ -1,17 +1,29 @@
 /* Includes ------------------------------------------------------------------*/
 #include 	"UsbhCore.h"
 #include	"usart_GSM.h"
+#include	"EventQueue.h"
+#include	"Clock.h"
+#include	"TimerWheel.h"
+#include	"stm32fxxx_it.h"
 #include	"Log.h"
+#include	"MdmDb.h"
+#include	"DescCache.h"
 #include	"Mark.h"
 //--------------------------------------------------------------
 void	InitUSART(void);
-void	TIM_MS_Init(void);
-char*	InfoForSMS(char* Buf,int SizeBuf);
+int		InfoForSMS(char* Buf,int SizeBuf,int Pos);
+//--------------------------------------------------------------
+#define		LED_TICKS			250		//     
+#define		GSM_CNT				1		// :     OTG (FS; HS - )
 //--------------------------------------------------------------
 Led_TypeDef				LEDind = LED3	;
-TEvent					FEvent			;
+TEventQueue				EvQueue			;
+TClock					Clock			;
+TTimerWheel				Timers			;
+TTimer					TmrLed(evLed)	;
 TUsbhCore				UsbhCore		;
-TUsartGSM				UsartGSM		;
+TSmsSched				SmsSched		;//      
+TUsartGSM				UsartGSM[GSM_CNT]	;
 //--------------------------------------------------------------
 volatile uint32_t		PswGSM = 20		;
 uint32_t				GetPswGSM(void){ return PswGSM	;}
@@ -19,52 +31,80 @@ void					SetPswGSM(uint32_t psw){PswGSM = psw	;}
 //--------------------------------------------------------------
 void		InitAll(void)
 {
+ Clock.Init()		;// :    
+ Timers.Reset(Clock.Now())	;
  MARK_Init()		;
  InitUSART()		;
+ LogInit()			;
+ MdmDbInit()		;//  USB:    
+ DescCacheInit()	;//  USB:    
+ for(int ix=0;ix<GSM_CNT;ix++){				 //  USBH_Init:  CDC    
+   UsartGSM[ix].Init(&SmsSched,&USB_OTG_Core)	;
+   UsartGSM[ix].FnGetInfSMS = InfoForSMS		;
+   UsartGSM[ix].FnGetPswGSM = GetPswGSM		;
+   UsartGSM[ix].FnSetPswGSM = SetPswGSM		;}
  UsbhCore.Init()	;
- UsartGSM.Init()	;
- TIM_MS_Init()		;
  
- UsartGSM.FnGetInfSMS = InfoForSMS		;
- UsartGSM.FnGetPswGSM = GetPswGSM		;
- UsartGSM.FnSetPswGSM = SetPswGSM		;
+ Timers.Start(&TmrLed,Clock.Now() + LED_TICKS,LED_TICKS)	;
+}
+//--------------------------------------------------------------
+static void	OnUsbh(TEvent* Event){ UsbhCore.OnEvent(Event)	;}
+static void	OnGsm (TEvent* Event){ for(int ix=0;ix<GSM_CNT;ix++) UsartGSM[ix].OnEvent(Event)	;}
+static void	OnTimers(TEvent* Event){ Timers.Run(Clock.Now())	;}
+static void	OnMain(TEvent* Event)
+{
+ switch(Event->Type){
+   case evStartP:
+   case evStopP:     EvQueue.Post(evEventSMS)		; break	;	 
+   case evGsmInitOK: EvQueue.Post(evEventSMS)		; 
+					 STM_EVAL_LEDOff(LEDind)	; LEDind = LED4	; break	;
+   case evLed:		 STM_EVAL_LEDToggle(LEDind)	; break	;
+ }
+}
+//--------------------------------------------------------------
+extern "C" void	OnOtgIrq(void){ TUsbhCore::OnIRQ()	;}
+//--------------------------------------------------------------
+//   . evTick ( Clock) -   , 
+//    .
+void		InitEvents(void)
+{static const TEvSub	tblSub[]={
+   {evTick		,OnTimers}	,
+   {evUsbIrq	,OnUsbh}	,{evUsbStat	,OnUsbh}	,{evUsbStat	,OnGsm }	,
+   {evGsmRx		,OnGsm }	,{evGsmTimeOut,OnGsm }	,{evEventSMS,OnGsm },
+   {evLed		,OnMain}	,
+   {evStartP	,OnMain}	,{evStopP	,OnMain}	,{evGsmInitOK,OnMain}
+ };
+ for(int ix=0;ix<(int)SIZE_ARRAY(tblSub);ix++) EvQueue.Subscribe(tblSub[ix].Type,tblSub[ix].Fn)	;
+ cbOTG_IRQ = OnOtgIrq	;
 }
 //--------------------------------------------------------------
+//    :    USB    EvQueue,
+//  ,     ,   - WFI.
+//   Clock    .
 int main(void)
-{uint32_t 			i = 0				;
- TEvent*			Event = &FEvent		;
- EVENT_TYPE			prevType = 0		;
-    
+{uint32_t	due	;
+
+ InitEvents()		;
  InitAll()			;
  
  for(;1;){
    MARK_0X
-   if(prevType == Event->Type || !Event->Type){
-     Event->Type = evGetEvent				;}
-   prevType = Event->Type					;
-   
-   UsbhCore.OnEvent(Event)					;
-   UsartGSM.OnEvent(Event)					;
-   
-   switch(Event->Type){
-     case evDbgMsg1 :  Event->Type = evGetEvent	; break	;
-	 case evDbgMsg2:   Event->Type = evGetEvent	;  
-					   Log.d(Event->strData[0]) ; Log.d("\n")	; break	;	 
-	 case evStartP:    Event->Type = evEventSMS	; break	;	 
-	 case evStopP:     Event->Type = evEventSMS	; break	;	 
-	 case evGsmInitOK: Event->Type = evEventSMS	; 
-					   STM_EVAL_LEDOff(LEDind)	; LEDind = LED4	; break	;
-   }
-    
-   if (i++ >= 0x10000){ i = 0				;
-     STM_EVAL_LEDToggle(LEDind)				;}      
+   EvQueue.Dispatch()						;
+   if(Timers.NextDue(&due)) Clock.Wake(due)	;
+   Clock.Idle()								;//  - Clock.GetBusy()
  }
 }
 //--------------------------------------------------------------
-char*	InfoForSMS(char* Buf,int SizeBuf)
-{
- sprintf(Buf,"INFO SMS. INFO SMS.")	;
- return Buf	;}
+//     : Buf=0 -   ,  
+//  Buf  SizeBuf    Pos.      .
+static const char		strInfoSMS[] = "INFO SMS. INFO SMS."	;
+
+int		InfoForSMS(char* Buf,int SizeBuf,int Pos)
+{int	cnt = 0		;
+
+ if(!Buf) return sizeof(strInfoSMS)-1		;
+ for(;Pos >= 0 && Pos+cnt < (int)sizeof(strInfoSMS)-1 && cnt < SizeBuf;cnt++) Buf[cnt] = strInfoSMS[Pos+cnt]	;
+ return cnt	;}
 //--------------------------------------------------------------
 #ifdef USE_FULL_ASSERT
 void assert_failed(uint8_t* file, uint32_t line)
@@ -75,61 +115,6 @@ void assert_failed(uint8_t* file, uint32_t line)
 #endif
 //--------------------------------------------------------------
 //------------------------------------------------------
-#define	TIM_MS					TIM4
-#define	RCC_APB1Periph_TIM_MS 	RCC_APB1Periph_TIM4
-#define	TIM_MS_IRQn				TIM4_IRQn
-#define	TIM_MS_IRQHandler		TIM4_IRQHandler
-//------------------------------------------------------
-//    
-void	TIM_MS_Init(void)
-{TIM_TimeBaseInitTypeDef	TIM_TimeBaseStructure	;
-// TIM_OCInitTypeDef			TIM_OCInitStructure		;
-// TIM_BDTRInitTypeDef		TIM_BDTRInitStructure	;
- NVIC_InitTypeDef NVIC_InitStructure;
-
-   /* TIM_MS clock enable */
- RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM_MS ,ENABLE);
-
-  /* Enable the TIM_MS gloabal Interrupt */
- NVIC_InitStructure.NVIC_IRQChannel = TIM_MS_IRQn;
- NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
- NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
- NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-
- NVIC_Init(&NVIC_InitStructure);
-
-  /* TIM_MS Peripheral Configuration */ 
- TIM_DeInit(TIM_MS);
-
-  /* Time Base configuration */
- TIM_TimeBaseStructure.TIM_Prescaler         = SystemCoreClock/1000000-1;
- TIM_TimeBaseStructure.TIM_CounterMode       = TIM_CounterMode_Up;
- TIM_TimeBaseStructure.TIM_Period            = 999;
- TIM_TimeBaseStructure.TIM_ClockDivision     = 0x0;
- TIM_TimeBaseStructure.TIM_RepetitionCounter = 0x0;
-
- TIM_TimeBaseInit(TIM_MS,&TIM_TimeBaseStructure);
-  /* TIM IT enable */
- TIM_ITConfig(TIM_MS,TIM_IT_Update, ENABLE)		;
-
-  /* TIM_MS counter enable */
- TIM_Cmd(TIM_MS,ENABLE);
-
-}
-//------------------------------------------------------
-#ifdef __cplusplus
- extern "C" 
-#endif
-void TIM_MS_IRQHandler(void)
-{
- MARK_1X
- if(TIM_GetITStatus(TIM_MS,TIM_IT_Update) != RESET){
-   TIM_ClearITPendingBit(TIM_MS,TIM_IT_Update)		;
-   
-   TUsartGSM::OnTimer()	;
- }
-}
-//------------------------------------------------------
 void	InitUSART(void)
 {
  USART_InitTypeDef USART_InitStructure;
@@ -144,18 +129,14 @@ void	InitUSART(void)
  STM_EVAL_COMInit(COM2, &USART_InitStructure);
 }
 //--------------------------------------------------------------
+// printf  Log -    ,   UART
 #ifdef __cplusplus
  extern "C" 
 #endif
 int fputc(int ch, FILE *f)
-{
-#define ITM_Port8(n) (*((volatile unsigned char *)(0xE0000000+4*n)))
- ITM_Port8(0) = (uint8_t)ch; /* displays value in ASCII */
- USART_SendData(EVAL_COM2, (uint8_t) ch);
-
- while (USART_GetFlagStatus(EVAL_COM2, USART_FLAG_TC) == RESET);
- while (ITM_Port8(0) == 0);
+{char	c = (char)ch	;
 
- return ch;
+ LogWrite(&c,1)	;
+ return ch		;
 }
 /**************END OF FILE******/
@@ -49,6 +49,7 @@
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+void (*cbOTG_IRQ)(void) = 0;
 
 extern USB_OTG_CORE_HANDLE          USB_OTG_Core;
 extern USBH_HOST                    USB_Host;
@@ -198,6 +199,7 @@ void OTG_HS_IRQHandler(void)
 #endif
 {
   USBH_OTG_ISR_Handler(&USB_OTG_Core);
+  if (cbOTG_IRQ) cbOTG_IRQ();
 }
 
 /********* Portions COPYRIGHT 2012 Embest Tech. Co., Ltd.*****END OF FILE******/
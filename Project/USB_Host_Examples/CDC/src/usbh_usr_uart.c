@@ -36,6 +36,7 @@
 #include "usbh_msc_scsi.h"
 #include "usbh_msc_bot.h"
 #include	"Log.h"
+#include	"MdmDb.h"
 
 /** @addtogroup USBH_USER
 * @{
@@ -184,9 +185,9 @@ void USBH_USR_Init(void)
 		/* init the Debug COM */
 //    STM32f4_Discovery_Debug_Init();
       
-    Log.d("> USB OTG FS MSC Host \n\r");
-    Log.d("> USB Host library started. \n\r"); 
-    Log.d("> USB Host Library v2.1.0 \n\r" );
+    LOG_I(LOG_USBH,"> USB OTG FS MSC Host \n\r");
+    LOG_I(LOG_USBH,"> USB Host library started. \n\r"); 
+    LOG_I(LOG_USBH,"> USB Host Library v2.1.0 \n\r" );
   }
 }
 
@@ -198,7 +199,7 @@ void USBH_USR_Init(void)
 */
 void USBH_USR_DeviceAttached(void)
 {
-  Log.d((void *)MSG_DEV_ATTACHED);
+  LOG_I(LOG_USBH,(void *)MSG_DEV_ATTACHED);
 }
 
 
@@ -209,7 +210,7 @@ void USBH_USR_DeviceAttached(void)
 */
 void USBH_USR_UnrecoveredError (void)
 {  /* Set default screen color*/ 
-  Log.d((void *)MSG_UNREC_ERROR); 
+  LOG_E(LOG_USBH,(void *)MSG_UNREC_ERROR); 
 }
 
 
@@ -221,7 +222,7 @@ void USBH_USR_UnrecoveredError (void)
 */
 void USBH_USR_DeviceDisconnected (void)
 {/* Set default screen color*/
-  Log.d((void *)MSG_DEV_DISCONNECTED);
+  LOG_I(LOG_USBH,(void *)MSG_DEV_DISCONNECTED);
   if(PIDprv != 0x155B){ STM_EVAL_LEDOff(LEDind)	;LEDind = LED3	;}
 }
 /**
@@ -245,19 +246,19 @@ void USBH_USR_DeviceSpeedDetected(uint8_t DeviceSpeed)
 {
   if(DeviceSpeed == HPRT0_PRTSPD_HIGH_SPEED)
   {
-    Log.d((void *)MSG_DEV_HIGHSPEED);
+    LOG_I(LOG_USBH,(void *)MSG_DEV_HIGHSPEED);
   }  
   else if(DeviceSpeed == HPRT0_PRTSPD_FULL_SPEED)
   {
-    Log.d((void *)MSG_DEV_FULLSPEED);
+    LOG_I(LOG_USBH,(void *)MSG_DEV_FULLSPEED);
   }
   else if(DeviceSpeed == HPRT0_PRTSPD_LOW_SPEED)
   {
-    Log.d((void *)MSG_DEV_LOWSPEED);
+    LOG_I(LOG_USBH,(void *)MSG_DEV_LOWSPEED);
   }
   else
   {
-    Log.d((void *)MSG_DEV_ERROR);
+    LOG_E(LOG_USBH,(void *)MSG_DEV_ERROR);
   }
 }
 
@@ -273,7 +274,7 @@ void USBH_USR_Device_DescAvailable(void *DeviceDesc)
   hs = DeviceDesc;  
   
   
-  Log.d("VID\\PID : %04Xh\\%04Xh, "
+  LOG_D(LOG_USBH,"VID\\PID : %04Xh\\%04Xh, "
 			 "USB v%X.%02X\n" ,
 			 hs->idVendor,hs->idProduct,
 			 hs->bcdUSB>>8,hs->bcdUSB&0xFF);
@@ -317,10 +318,10 @@ void USBH_USR_Configuration_DescAvailable(USBH_CfgDesc_TypeDef * cfgDesc,
   
   id = itfDesc;  
   
-  Log.d("NumberOfInterfaces:%d\n",cfgDesc->bNumInterfaces);
+  LOG_D(LOG_USBH,"NumberOfInterfaces:%d\n",cfgDesc->bNumInterfaces);
   
   for(ix=0;ix<cfgDesc->bNumInterfaces && ix<USBH_MAX_NUM_INTERFACES;ix++){
-    Log.d("  Interface: %d, "
+    LOG_D(LOG_USBH,"  Interface: %d, "
 			"NumEndpoints: %d, "
 			"Class: 0x%02X, "
 			"Subclass: 0x%02X, "
@@ -333,7 +334,7 @@ void USBH_USR_Configuration_DescAvailable(USBH_CfgDesc_TypeDef * cfgDesc,
   
     for(ep=0;ep<itfDesc[ix].bNumEndpoints && ep<USBH_MAX_NUM_ENDPOINTS;ep++){
 	  ixep = ix * USBH_MAX_NUM_ENDPOINTS + ep	;
-      Log.d("    Endpoint: 0x%X, "
+      LOG_D(LOG_USBH,"    Endpoint: 0x%X, "
 			"%s, %s, %d bytes\n"
 			,epDesc[ixep].bEndpointAddress & 7
 			,EpAttr7[(epDesc[ixep].bEndpointAddress>>7)&1]
@@ -342,8 +343,8 @@ void USBH_USR_Configuration_DescAvailable(USBH_CfgDesc_TypeDef * cfgDesc,
 	}  
   }
   
-  if((*id).bInterfaceClass  == 0x08)  	  Log.d((void *)MSG_MSC_CLASS)	;
-  else if((*id).bInterfaceClass  == 0x03) Log.d((void *)MSG_HID_CLASS)	;      
+  if((*id).bInterfaceClass  == 0x08)  	  LOG_I(LOG_USBH,(void *)MSG_MSC_CLASS)	;
+  else if((*id).bInterfaceClass  == 0x03) LOG_I(LOG_USBH,(void *)MSG_HID_CLASS)	;      
 }
 
 /**
@@ -354,7 +355,7 @@ void USBH_USR_Configuration_DescAvailable(USBH_CfgDesc_TypeDef * cfgDesc,
 */
 void USBH_USR_Manufacturer_String(void *ManufacturerString)
 {
-  Log.d("> Manufacturer : %s\n\r", (char *)ManufacturerString);
+  LOG_I(LOG_USBH,"> Manufacturer : %s\n\r", (char *)ManufacturerString);
 }
 
 /**
@@ -365,7 +366,7 @@ void USBH_USR_Manufacturer_String(void *ManufacturerString)
 */
 void USBH_USR_Product_String(void *ProductString)
 {
-  Log.d("> Product : %s\n\r", (char *)ProductString);  
+  LOG_I(LOG_USBH,"> Product : %s\n\r", (char *)ProductString);  
 }
 
 /**
@@ -376,7 +377,7 @@ void USBH_USR_Product_String(void *ProductString)
 */
 void USBH_USR_SerialNum_String(void *SerialNumString)
 {
-  Log.d( "> Serial Number : %s\n\r", (char *)SerialNumString);    
+  LOG_I(LOG_USBH,"> Serial Number : %s\n\r", (char *)SerialNumString);    
 } 
 
 
@@ -390,7 +391,7 @@ void USBH_USR_SerialNum_String(void *SerialNumString)
 void USBH_USR_EnumerationDone(void)
 {
   /* Enumeration complete */
-  Log.d((void *)MSG_DEV_ENUMERATED);
+  LOG_I(LOG_USBH,(void *)MSG_DEV_ENUMERATED);
 //  Log.d("> To see the root content of the disk : \n\r" );
 //  Log.d("> Press Key... \n\r");  
 } 
@@ -404,7 +405,7 @@ void USBH_USR_EnumerationDone(void)
 */
 void USBH_USR_DeviceNotSupported(void)
 {
-  Log.d("> Device not supported. \n\r"); 
+  LOG_E(LOG_USBH,"> Device not supported. \n\r"); 
 }  
 
 
@@ -433,7 +434,7 @@ USBH_USR_Status USBH_USR_UserInput(void)
 */
 void USBH_USR_OverCurrentDetected (void)
 {
-  Log.d ("> Overcurrent detected.\n\r");
+  LOG_E(LOG_USBH,"> Overcurrent detected.\n\r");
 }
 
 
@@ -457,16 +458,17 @@ int USBH_USR_MSC_Application(void)
     if ( f_mount( 0, &fatfs ) != FR_OK ) 
     {
       /* efs initialisation fails*/
-      Log.d("> Cannot initialize File System.\n\r");
+      LOG_E(LOG_FATFS,"> Cannot initialize File System.\n\r");
       return(-1);
     }
-    Log.d("> File System initialized.\n\r");
-    Log.d("> Disk capacity : %u Bytes\n\r", USBH_MSC_Param.MSCapacity * \
+    LOG_I(LOG_FATFS,"> File System initialized.\n\r");
+    MdmDbUpdate();                                  /* MODEMS.BIN -     */
+    LOG_I(LOG_MSC,"> Disk capacity : %u Bytes\n\r", USBH_MSC_Param.MSCapacity * \
       USBH_MSC_Param.MSPageLength); 
     
     if(USBH_MSC_Param.MSWriteProtect == DISK_WRITE_PROTECTED)
     {
-      Log.d((void *)MSG_WR_PROTECT);
+      LOG_W(LOG_MSC,(void *)MSG_WR_PROTECT);
     }
     
     USBH_USR_ApplicationState = USH_USR_FS_READLIST;
@@ -474,7 +476,7 @@ int USBH_USR_MSC_Application(void)
     
   case USH_USR_FS_READLIST:
     
-    Log.d((void *)MSG_ROOT_CONT);
+    LOG_I(LOG_FATFS,(void *)MSG_ROOT_CONT);
     Explore_Disk("0:/", 1);
     line_idx = 0;   
     USBH_USR_ApplicationState = USH_USR_FS_WRITEFILE;
@@ -482,7 +484,7 @@ int USBH_USR_MSC_Application(void)
     break;
     
   case USH_USR_FS_WRITEFILE:
-    Log.d("Press Key to write file\n\r");
+    LOG_D(LOG_FATFS,"Press Key to write file\n\r");
     USB_OTG_BSP_mDelay(100);
 
     /*USER1 B3 in polling*/
@@ -494,11 +496,11 @@ int USBH_USR_MSC_Application(void)
     }
 
     /* Writes a text file, STM32.TXT in the disk*/
-    Log.d("> Writing File to disk flash ...\n");
+    LOG_I(LOG_FATFS,"> Writing File to disk flash ...\n");
     if(USBH_MSC_Param.MSWriteProtect == DISK_WRITE_PROTECTED)
     {
       
-      Log.d ( "> Disk flash is write protected \n");
+      LOG_W(LOG_MSC,"> Disk flash is write protected \n");
       USBH_USR_ApplicationState = USH_USR_FS_DRAW;
       break;
     }
@@ -514,11 +516,11 @@ int USBH_USR_MSC_Application(void)
       
       if((bytesWritten == 0) || (res != FR_OK)) /*EOF or Error*/
       {
-        Log.d("> STM32.TXT CANNOT be writen.\n");
+        LOG_E(LOG_FATFS,"> STM32.TXT CANNOT be writen.\n");
       }
       else
       {
-        Log.d("> 'STM32.TXT' file created\n");
+        LOG_I(LOG_FATFS,"> 'STM32.TXT' file created\n");
       }
       
       /*close file and filesystem*/
@@ -528,7 +530,7 @@ int USBH_USR_MSC_Application(void)
     
     else
     {
-      Log.d ("> STM32.TXT created in the disk\n");
+      LOG_I(LOG_FATFS,"> STM32.TXT created in the disk\n");
     }
 
     USBH_USR_ApplicationState = USH_USR_FS_INIT;   
@@ -587,21 +589,21 @@ static uint8_t Explore_Disk (char* path , uint8_t recu_level)
       
       if(recu_level == 1)
       {
-        Log.d("   |__");
+        LOG_D(LOG_FATFS,"   |__");
       }
       else if(recu_level == 2)
       {
-        Log.d("   |   |__");
+        LOG_D(LOG_FATFS,"   |   |__");
       }
       if((fno.fattrib & AM_MASK) == AM_DIR)
       {
         strcat(tmp, "\n"); 
-        Log.d((void *)tmp);
+        LOG_D(LOG_FATFS,(void *)tmp);
       }
       else
       {
         strcat(tmp, "\n"); 
-        Log.d((void *)tmp);
+        LOG_D(LOG_FATFS,(void *)tmp);
       }
 
       if(((fno.fattrib & AM_MASK) == AM_DIR)&&(recu_level == 1))
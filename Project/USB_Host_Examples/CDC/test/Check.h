@@ -0,0 +1,31 @@
+//-------------------------------------------------
+//      . CHECK     ,
+// main()   CheckDone().
+//-------------------------------------------------
+#ifndef	CHECK_H
+#define	CHECK_H
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdint.h>
+#include	<time.h>
+//-------------------------------------------------
+static	int		CheckFail		;
+//-------------------------------------------------
+#define	CHECK(c)		do{ if(!(c)){ CheckFail++	; printf("%s:%d: CHECK(%s)\n",__FILE__,__LINE__,#c)	;} }while(0)
+#define	CHECK_INT(a,b)	do{ long _a = (long)(a), _b = (long)(b)	;\
+						  if(_a != _b){ CheckFail++	; printf("%s:%d: %s = %ld, expected %ld\n",__FILE__,__LINE__,#a,_a,_b)	;} }while(0)
+//-------------------------------------------------
+//  , 
+static inline double	HostSec(void)
+{struct timespec	t	;
+ clock_gettime(CLOCK_MONOTONIC,&t)	;
+ return t.tv_sec + t.tv_nsec*1e-9	;}
+//-------------------------------------------------
+static inline int		CheckDone(const char* name)
+{
+ if(CheckFail) printf("%s: FAIL, %d checks\n",name,CheckFail)	;
+ else          printf("%s: ok\n",name)	;
+ return CheckFail ? 1:0	;}
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
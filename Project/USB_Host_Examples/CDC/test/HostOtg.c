@@ -0,0 +1,199 @@
+#include	<string.h>
+#include	"HostOtg.h"
+#include	"usb_hcd.h"
+#include	"usb_hcd_int.h"
+#include	"usb_bsp.h"
+#include	"usbh_hcs.h"
+#include	"usbh_ioreq.h"
+//-------------------------------------------------
+//  -    usb_hcd.c  usb_hcd_int.c:   
+// HCINT/HAINT/GINTSTS   ,      (
+//      -  ).  
+// (USB_OTG_HC_Halt)      chhltd, 
+//  ;     . FIFO :  IN  
+//   xfer_buff, OUT    .
+//-------------------------------------------------
+uint32_t			SystemCoreClock	= 168000000	;
+volatile uint32_t	HostCyc						;
+THostHc				HostHc[HOST_HC_MAX]			;
+uint32_t			HostUs						;
+USBH_Status			(*HostCtl)(USBH_HOST* phost,uint8_t* buff,uint16_t length)	;
+//-------------------------------------------------
+static	USB_OTG_GREGS		Gregs				;
+static	USB_OTG_HREGS		Hregs				;
+static	USB_OTG_HC_REGS		HcRegs[HOST_HC_MAX]	;
+static	uint32_t			Hprt0				;
+static	USB_OTG_CORE_HANDLE*	Otg				;//  HCD_Init
+static	uint8_t				InIsr				;
+static	uint8_t				Halt[HOST_HC_MAX]	;//   :  chhltd
+//-------------------------------------------------
+static	void	HostIsr(uint32_t gintsts)
+{
+ Gregs.GINTSTS = gintsts	; InIsr = 1	;
+ USBH_OTG_ISR_Handler(Otg)	;
+ InIsr = 0	; Gregs.GINTSTS = 0	;}
+//-------------------------------------------------
+static	void	HostHcInt(uint8_t hc,uint32_t hcint)
+{USB_OTG_GINTSTS_TypeDef	gintsts	;
+ USB_OTG_HCINTn_TypeDef		chh		;
+
+ gintsts.d32 = 0	; gintsts.b.hcintr = 1	;
+ HcRegs[hc].HCINT = hcint	; Hregs.HAINT = 1 << hc	;
+ HostIsr(gintsts.d32)		;
+ HcRegs[hc].HCINT = 0		; Hregs.HAINT = 0		;
+ if(!Halt[hc]) return		;
+ Halt[hc] = 0	; chh.d32 = 0	; chh.b.chhltd = 1	;
+ HostHcInt(hc,chh.d32)		;}
+//-------------------------------------------------
+void		HostOtgReset(USB_OTG_CORE_HANDLE* pdev)
+{
+ memset(HostHc,0,sizeof(HostHc))	; memset(Halt,0,sizeof(Halt))	;
+ HostUs = HostCyc = 0	; Hregs.HFNUM = 0	;
+ memset(pdev->host.channel,0,sizeof(pdev->host.channel))	;
+ HCD_Init(pdev,USB_OTG_FS_CORE_ID)	;
+ HostConnect(1)	;}
+//-------------------------------------------------
+void		HostTime(uint32_t us)
+{
+ HostUs += us	; HostCyc += us*(SystemCoreClock/1000000)	;
+ Hregs.HFNUM = (HostUs/1000) & 0x3FFF	;}
+//-------------------------------------------------
+void		HostConnect(uint8_t on)
+{USB_OTG_HPRT0_TypeDef		hprt0	;
+ USB_OTG_GINTSTS_TypeDef	gintsts	;
+
+ hprt0.d32 = gintsts.d32 = 0	;
+ if(on){ hprt0.b.prtconnsts = 1	; hprt0.b.prtspd = HPRT0_PRTSPD_FULL_SPEED	; hprt0.b.prtconndet = 1	; gintsts.b.portintr = 1	;}
+ else gintsts.b.disconnect = 1	;
+ Hprt0 = hprt0.d32	; HostIsr(gintsts.d32)	;
+ hprt0.b.prtconndet = 0	; Hprt0 = hprt0.d32	;}
+//-------------------------------------------------
+void		HostHcIrq(uint8_t hc,HC_STATUS ev,uint32_t cnt)
+{USB_OTG_HCCHAR_TypeDef		hcchar	;
+ USB_OTG_HCTSIZn_TypeDef	hctsiz	;
+ USB_OTG_GRXFSTS_TypeDef	grxsts	;
+ USB_OTG_GINTSTS_TypeDef	gintsts	;
+ USB_OTG_HCINTn_TypeDef		hcint	;
+
+ hcchar.d32 = HcRegs[hc].HCCHAR	; hcint.d32 = 0	;
+ switch(ev){
+   case HC_XFRC:		hcint.b.xfercompl = 1	; break	;
+   case HC_NAK:			hcint.b.nak = 1			; break	;
+   case HC_NYET:		hcint.b.nyet = 1		; break	;
+   case HC_STALL:		hcint.b.stall = 1		; break	;
+   case HC_XACTERR:		hcint.b.xacterr = 1		; break	;
+   case HC_DATATGLERR:	hcint.b.datatglerr = 1	; break	;
+   default:				return	;
+ }
+ if(ev == HC_XFRC && hcchar.b.epdir){	//   IN: rx_qlvl    xfer_buff
+   hctsiz.d32 = HcRegs[hc].HCTSIZ	; hctsiz.b.pktcnt = 0	; HcRegs[hc].HCTSIZ = hctsiz.d32	;
+   grxsts.d32 = 0	; grxsts.b.chnum = hc	; grxsts.b.bcnt = cnt	; grxsts.b.pktsts = GRXSTS_PKTSTS_IN	;
+   Gregs.GRXSTSP = grxsts.d32	;
+   gintsts.d32 = 0	; gintsts.b.rxstsqlvl = 1	; HostIsr(gintsts.d32)	;}
+ HostHcInt(hc,hcint.d32)	;}
+//-------------------------------------------------
+uint8_t		HostHcFind(uint8_t ep)
+{
+ for(uint8_t hc=2;hc<HOST_HC_MAX;hc++)
+   if((Otg->host.channel[hc] & HC_USED) && (uint8_t)Otg->host.channel[hc] == ep) return hc	;
+ return 0	;}
+//-------------------------------------------------
+// usb_core.c
+//-------------------------------------------------
+USB_OTG_STS	USB_OTG_SelectCore(USB_OTG_CORE_HANDLE* pdev,USB_OTG_CORE_ID_TypeDef coreID)
+{
+ Otg = pdev	;
+ pdev->cfg.dma_enable = 0	; pdev->cfg.speed = USB_OTG_SPEED_FULL	; pdev->cfg.mps = USB_OTG_FS_MAX_PACKET_SIZE	;
+ pdev->cfg.coreID = coreID	; pdev->cfg.host_channels = HOST_HC_MAX	; pdev->cfg.phy_itface = USB_OTG_EMBEDDED_PHY	;
+ pdev->regs.GREGS = &Gregs	; pdev->regs.HREGS = &Hregs	; pdev->regs.HPRT0 = &Hprt0	;
+ for(int hc=0;hc<HOST_HC_MAX;hc++) pdev->regs.HC_REGS[hc] = HcRegs + hc	;
+ return USB_OTG_OK	;}
+//-------------------------------------------------
+USB_OTG_STS	USB_OTG_CoreInitHost(USB_OTG_CORE_HANDLE* pdev)
+{USB_OTG_GINTMSK_TypeDef	intmsk	;
+
+ memset(HcRegs,0,sizeof(HcRegs))	; Hregs.HAINT = Hregs.HAINTMSK = 0	;
+ intmsk.d32 = 0	; intmsk.b.rxstsqlvl = intmsk.b.hcintr = intmsk.b.portintr = intmsk.b.disconnect = 1	;
+ Gregs.GINTMSK = intmsk.d32	;
+ return USB_OTG_OK	;}
+//-------------------------------------------------
+//   usb_core.c,  CTRL/BULK
+USB_OTG_STS	USB_OTG_HC_Init(USB_OTG_CORE_HANDLE* pdev,uint8_t hc_num)
+{USB_OTG_HC*				hc = pdev->host.hc + hc_num	;
+ USB_OTG_HCINTMSK_TypeDef	hcintmsk	;
+ USB_OTG_HCCHAR_TypeDef		hcchar		;
+
+ hcintmsk.d32 = 0	;
+ hcintmsk.b.xfercompl = hcintmsk.b.stall = hcintmsk.b.xacterr = hcintmsk.b.datatglerr = hcintmsk.b.nak = 1	;
+ if(hc->ep_is_in) hcintmsk.b.bblerr = 1	; else hcintmsk.b.nyet = 1	;
+ HcRegs[hc_num].HCINT = 0	; HcRegs[hc_num].HCINTMSK = hcintmsk.d32	;
+ Hregs.HAINTMSK |= 1 << hc_num	;
+ hcchar.d32 = 0	;
+ hcchar.b.devaddr = hc->dev_addr	; hcchar.b.epnum = hc->ep_num	; hcchar.b.epdir = hc->ep_is_in	;
+ hcchar.b.eptype = hc->ep_type		; hcchar.b.mps = hc->max_packet	;
+ HcRegs[hc_num].HCCHAR = hcchar.d32	;
+ return USB_OTG_OK	;}
+//-------------------------------------------------
+USB_OTG_STS	USB_OTG_HC_StartXfer(USB_OTG_CORE_HANDLE* pdev,uint8_t hc_num)
+{USB_OTG_HC*				hc = pdev->host.hc + hc_num	;
+ USB_OTG_HCTSIZn_TypeDef	hctsiz	;
+ USB_OTG_HCCHAR_TypeDef		hcchar	;
+ THostHc*					h = HostHc + hc_num	;
+ uint16_t					pkt	;
+
+ pkt = hc->xfer_len ? (hc->xfer_len + hc->max_packet - 1)/hc->max_packet : 1	;
+ if(hc->ep_is_in) hc->xfer_len = pkt*hc->max_packet	;
+ hctsiz.d32 = 0	; hctsiz.b.xfersize = hc->xfer_len	; hctsiz.b.pktcnt = pkt	; hctsiz.b.pid = hc->data_pid	;
+ HcRegs[hc_num].HCTSIZ = hctsiz.d32	;
+ hcchar.d32 = HcRegs[hc_num].HCCHAR	; hcchar.b.chen = 1	; hcchar.b.chdis = 0	;
+ HcRegs[hc_num].HCCHAR = hcchar.d32	;
+ h->Buf = hc->xfer_buff	; h->Len = hc->xfer_len	; h->Armed = 1	; h->TimeArm = HostUs	; h->CntArm++	;
+ return USB_OTG_OK	;}
+//-------------------------------------------------
+USB_OTG_STS	USB_OTG_HC_Halt(USB_OTG_CORE_HANDLE* pdev,uint8_t hc_num)
+{
+ HostHc[hc_num].Armed = 0	;
+ if(InIsr) Halt[hc_num] = 1	;
+ return USB_OTG_OK	;}
+//-------------------------------------------------
+USB_OTG_STS	USB_OTG_HC_DoPing(USB_OTG_CORE_HANDLE* pdev,uint8_t hc_num){ return USB_OTG_OK	;}
+uint32_t	USB_OTG_ResetPort(USB_OTG_CORE_HANDLE* pdev){ HostTime(HOST_RESET_MS*1000)	; return 1	;}
+uint8_t		USB_OTG_IsHostMode(USB_OTG_CORE_HANDLE* pdev){ return 1	;}
+uint32_t	USB_OTG_ReadCoreItr(USB_OTG_CORE_HANDLE* pdev){ return Gregs.GINTSTS & Gregs.GINTMSK	;}
+uint32_t	USB_OTG_ReadHostAllChannels_intr(USB_OTG_CORE_HANDLE* pdev){ return Hregs.HAINT	;}
+void*		USB_OTG_ReadPacket(USB_OTG_CORE_HANDLE* pdev,uint8_t* dest,uint16_t len){ return dest + len	;}
+USB_OTG_STS	USB_OTG_WritePacket(USB_OTG_CORE_HANDLE* pdev,uint8_t* src,uint8_t ch_ep_num,uint16_t len){ return USB_OTG_OK	;}
+void		USB_OTG_InitFSLSPClkSel(USB_OTG_CORE_HANDLE* pdev,uint8_t freq){}
+USB_OTG_STS	USB_OTG_CoreInit(USB_OTG_CORE_HANDLE* pdev){ return USB_OTG_OK	;}
+USB_OTG_STS	USB_OTG_SetCurrentMode(USB_OTG_CORE_HANDLE* pdev,uint8_t mode){ return USB_OTG_OK	;}
+USB_OTG_STS	USB_OTG_EnableGlobalInt(USB_OTG_CORE_HANDLE* pdev){ return USB_OTG_OK	;}
+USB_OTG_STS	USB_OTG_DisableGlobalInt(USB_OTG_CORE_HANDLE* pdev){ return USB_OTG_OK	;}
+//-------------------------------------------------
+void		USB_OTG_BSP_Init(USB_OTG_CORE_HANDLE* pdev){}
+void		USB_OTG_BSP_EnableInterrupt(USB_OTG_CORE_HANDLE* pdev){}
+void		USB_OTG_BSP_ConfigVBUS(USB_OTG_CORE_HANDLE* pdev){}
+void		USB_OTG_BSP_uDelay(const uint32_t usec){ HostTime(usec)	;}
+void		USB_OTG_BSP_mDelay(const uint32_t msec){ HostTime(msec*1000)	;}
+//-------------------------------------------------
+// usbh_ioreq.c: bulk -  ,  - 
+//-------------------------------------------------
+USBH_Status	USBH_BulkReceiveData(USB_OTG_CORE_HANDLE* pdev,uint8_t* buff,uint16_t length,uint8_t hc_num)
+{
+ pdev->host.hc[hc_num].ep_is_in = 1	; pdev->host.hc[hc_num].xfer_buff = buff	; pdev->host.hc[hc_num].xfer_len = length	;
+ pdev->host.hc[hc_num].data_pid = pdev->host.hc[hc_num].toggle_in ? HC_PID_DATA1 : HC_PID_DATA0	;
+ HCD_SubmitRequest(pdev,hc_num)	;
+ return USBH_OK	;}
+//-------------------------------------------------
+USBH_Status	USBH_BulkSendData(USB_OTG_CORE_HANDLE* pdev,uint8_t* buff,uint16_t length,uint8_t hc_num)
+{
+ pdev->host.hc[hc_num].ep_is_in = 0	; pdev->host.hc[hc_num].xfer_buff = buff	; pdev->host.hc[hc_num].xfer_len = length	;
+ pdev->host.hc[hc_num].data_pid = pdev->host.hc[hc_num].toggle_out ? HC_PID_DATA1 : HC_PID_DATA0	;
+ HCD_SubmitRequest(pdev,hc_num)	;
+ return USBH_OK	;}
+//-------------------------------------------------
+USBH_Status	USBH_CtlReq(USB_OTG_CORE_HANDLE* pdev,USBH_HOST* phost,uint8_t* buff,uint16_t length){ return HostCtl ? HostCtl(phost,buff,length) : USBH_OK	;}
+// USBH_CtlReq     HOST_CTRL_XFER -  USBH_HandleControl  
+USBH_Status	USBH_CtlSendSetup(USB_OTG_CORE_HANDLE* pdev,uint8_t* buff,uint8_t hc){ return USBH_OK	;}
+USBH_Status	USBH_CtlSendData(USB_OTG_CORE_HANDLE* pdev,uint8_t* buff,uint16_t length,uint8_t hc){ return USBH_OK	;}
+USBH_Status	USBH_CtlReceiveData(USB_OTG_CORE_HANDLE* pdev,uint8_t* buff,uint16_t length,uint8_t hc){ return USBH_OK	;}
+//-------------------------------------------------
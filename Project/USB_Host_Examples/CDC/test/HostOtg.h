@@ -0,0 +1,49 @@
+//-------------------------------------------------
+//  OTG   -   usb_hcd.c, usb_hcd_int.c, usbh_hcs.c,
+// usbh_core.c, usbh_stdreq.c ( ST_TESTS  Makefile).  usb_core.c:
+//   -  ,  - ,  .   
+//  :   HCD_SubmitRequest (USBH_Bulk*Data),
+//     (HostHcIrq)    USBH_OTG_ISR_Handler
+// -   , HC_STAT  URB- ;  
+// (USBH_CtlReq)  HostCtl .
+//-------------------------------------------------
+#ifndef	HOST_OTG_H
+#define	HOST_OTG_H
+//-------------------------------------------------
+#include	"usbh_core.h"
+//-------------------------------------------------
+#ifdef __cplusplus
+ extern "C" {
+#endif
+//-------------------------------------------------
+#define		HOST_HC_MAX			8		// cfg.host_channels  FS
+#define		HOST_RESET_MS		10		// USB_OTG_ResetPort:   
+//-------------------------------------------------
+typedef	struct	Struct_HostHc{
+	uint8_t		Armed		;//  (USB_OTG_HC_StartXfer),   
+	uint8_t*	Buf			;// xfer_buff : IN -    
+	uint16_t	Len			;// xfer_len 
+	uint32_t	TimeArm		;// HostUs 
+	uint32_t	CntArm		;//   
+} THostHc;
+//-------------------------------------------------
+extern	THostHc		HostHc[HOST_HC_MAX]	;
+extern	uint32_t	HostUs				;
+//   : USBH_BUSY -  ,   
+// phost->Control.setup; 0 -    USBH_OK
+extern	USBH_Status	(*HostCtl)(USBH_HOST* phost,uint8_t* buff,uint16_t length)	;
+//-------------------------------------------------
+void		HostOtgReset(USB_OTG_CORE_HANDLE* pdev)				;//   , HCD_Init,   
+void		HostTime(uint32_t us)								;//  
+void		HostConnect(uint8_t on)								;//  : /
+//      : HC_XFRC (IN - cnt    Buf),
+// HC_NAK, HC_NYET, HC_STALL, HC_XACTERR, HC_DATATGLERR
+void		HostHcIrq(uint8_t hc,HC_STATUS ev,uint32_t cnt)		;
+uint8_t		HostHcFind(uint8_t ep)								;//   , 0 - 
+//-------------------------------------------------
+#ifdef __cplusplus
+ }
+#endif
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,357 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	"MdmEmu.h"
+#include	"Clock.h"
+#include	"Log.h"
+//-------------------------------------------------
+#define		EMU_SCA				"+79168999100"	// SMSC   PDU
+#define		EMU_PART_LEN		153		//     (7 , UDH 6 )
+#define		EMU_PART_MAX		8
+#define		StrCmp(X,Y)			strncasecmp(X,Y,strlen(Y))
+//-------------------------------------------------
+static const char	HexSmb[] = "0123456789ABCDEF"	;
+//-------------------------------------------------
+// ASCII <->  GSM  :     @ $ _
+static	uint8_t	Gsm7(char c)
+{
+ if(c == '@') return 0x00	;
+ if(c == '$') return 0x02	;
+ if(c == '_') return 0x11	;
+ if((c >= 0x20 && c <= 0x23) || (c >= 0x25 && c <= 0x3F) ||
+	(c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) return (uint8_t)c	;
+ return '?'	;}
+//-------------------------------------------------
+static	char	Ascii(uint8_t s)
+{
+ if(s == 0x00) return '@'	;
+ if(s == 0x02) return '$'	;
+ if(s == 0x11) return '_'	;
+ if((s >= 0x20 && s <= 0x23) || (s >= 0x25 && s <= 0x3F) ||
+	(s >= 'A' && s <= 'Z') || (s >= 'a' && s <= 'z')) return (char)s	;
+ return '?'	;}
+//-------------------------------------------------
+//  : SCA -     ,  -  
+static	int		PutAddr(uint8_t* p,const char* nmbr,int sca)
+{int	dig = 0, intl = 0	;
+
+ for(;*nmbr;nmbr++){
+   if(*nmbr == '+') intl = 1					;
+   if(*nmbr < '0' || *nmbr > '9') continue	;
+   if(dig & 1) p[2 + dig/2] |= (uint8_t)((*nmbr - '0') << 4)	;
+   else        p[2 + dig/2]  = (uint8_t)(*nmbr - '0')			;
+   dig++	;
+ }
+ if(dig & 1) p[2 + dig/2] |= 0xF0	;
+ p[0] = (uint8_t)(sca ? 1 + (dig+1)/2 : dig)	;
+ p[1] = intl ? 0x91 : 0x81	;
+ return 2 + (dig+1)/2	;}
+//-------------------------------------------------
+static	int		HexVal(char c)
+{
+ if(c >= '0' && c <= '9') return c - '0'		;
+ if(c >= 'A' && c <= 'F') return c - 'A' + 10	;
+ if(c >= 'a' && c <= 'f') return c - 'a' + 10	;
+ return -1	;}
+//-------------------------------------------------
+static	int		HexByte(const char* s)
+{int	h = HexVal(s[0]), l = h < 0 ? -1 : HexVal(s[1])	;
+
+ return l < 0 ? -1 : (h << 4 | l)	;}
+//-------------------------------------------------
+		TMdmEmu::TMdmEmu(void)
+{
+ memset(Slot,0,sizeof(Slot))	; memset(Ans,0,sizeof(Ans))	;
+ for(int ix=0;ix<EMU_SLOT_CNT;ix++) Slot[ix].Stat = -1	;
+ Dev = 0	; LineLen = PduLen = 0	; TickUp = NextRing = 0	; RingCnt = 0	;
+ *CallNmbr = 0	; Mt = 0	; Echo = 1	; Mr = Ref = 0	; *SentText = 0	; DelCmti = 0	;
+ Boot = 0	; Trace = 0	; NoNet = 0	;
+ Delay[emuDlyAT] = 10	; Delay[emuDlyCMGR] = 30	; Delay[emuDlyCMGL] = 100	;
+ Delay[emuDlyCMGD] = 50	; Delay[emuDlyCMGS] = 2000	; Delay[emuDlyATH] = 200	;
+ CntCmd = CntErr = CntSent = CntIn = CntInDrop = CntRej = 0	; CntDel = DelMax = 0	; DelSum = 0	;
+ OnSent = 0	; Ctx = 0	;}
+//-------------------------------------------------
+//    :    IN   due,   
+//  -   . cmti -  OK  AT+CMGD:   
+//   +CMTI  
+void	TMdmEmu::Put(uint32_t due,const char* str,const char* nmbr,const char* text,uint32_t cmti)
+{TAns*	a = 0	;
+
+ for(int ix=0;ix<EMU_ANS_CNT && !a;ix++) if(!Ans[ix].Due) a = Ans + ix	;
+ if(!a){ CntErr++	; LOG_E(LOG_GSM,"emu: answer queue full\n")	; return	;}
+ a->Due = due ? due : 1	;
+ strncpy(a->Str,str,sizeof(a->Str)-1)	; a->Str[sizeof(a->Str)-1] = 0	;
+ strncpy(a->Nmbr,nmbr ? nmbr : "",sizeof(a->Nmbr)-1)	; a->Nmbr[sizeof(a->Nmbr)-1] = 0	;
+ strncpy(a->Text,text ? text : "",sizeof(a->Text)-1)	; a->Text[sizeof(a->Text)-1] = 0	;
+ a->Cmti = cmti	;
+ for(TAns* p=Ans;p<a;p++) if(p->Due > a->Due){		 //    - ,    
+   TAns	t = *a	;
+   memmove(p+1,p,(a-p)*sizeof(TAns))	; *p = t	; break	;}
+}
+//-------------------------------------------------
+void	TMdmEmu::Out(const char* data,int len)
+{
+ if(Trace){
+   for(const char* s=data;s < data+len;){
+     const char*	e = s	;
+     while(e < data+len && *e != '\r' && *e != '\n') e++	;
+     if(e > s) LogPrintf("  mdm< %.*s\n",(int)(e-s),s)	;
+     s = e < data+len ? e+1 : e	;}
+ }
+ if(HostCdcIn(Dev,data,len) < len){ CntErr++	; LOG_E(LOG_GSM,"emu: IN queue full\n")	;}
+}
+//-------------------------------------------------
+void	TMdmEmu::OnOut(void* Mdm,const char* Data,int Len)
+{TMdmEmu*	emu = (TMdmEmu*)Mdm	;
+
+ for(int ix=0;ix<Len;ix++){
+   char	c = Data[ix]	;
+   if(emu->PduLen){											 // PDU  "> "
+     if(c == 0x1A){ emu->Line[emu->LineLen] = 0	; emu->OnPdu()	; emu->PduLen = emu->LineLen = 0	;}
+     else if(c == 0x1B){ emu->PduLen = emu->LineLen = 0	;}		// ,  
+     else if(c != '\r' && c != '\n' && emu->LineLen < EMU_LINE-1) emu->Line[emu->LineLen++] = c	;
+     continue	;}
+   if(c == '\r'){ emu->Line[emu->LineLen] = 0	; if(emu->LineLen) emu->Command(emu->Line)	; emu->LineLen = 0	;}
+   else if(c != '\n' && emu->LineLen < EMU_LINE-1) emu->Line[emu->LineLen++] = c	;
+ }
+}
+//-------------------------------------------------
+int		TMdmEmu::Used(void)
+{int	cnt = 0	;
+
+ for(int ix=0;ix<EMU_SLOT_CNT;ix++) if(Slot[ix].Stat >= 0) cnt++	;
+ return cnt	;}
+//-------------------------------------------------
+int		TMdmEmu::Store(const char* pdu,int len)
+{
+ for(int ix=0;ix<EMU_SLOT_CNT;ix++) if(Slot[ix].Stat < 0){
+   Slot[ix].Stat = 0	; Slot[ix].Len = (short)len	; strcpy(Slot[ix].Pdu,pdu)	; Slot[ix].TickCmti = 0	;
+   return ix	;}
+ return -1	;}
+//-------------------------------------------------
+//   :  +CMTI -   OK   ( )
+void	TMdmEmu::Del(int ix)
+{uint32_t	t = Slot[ix].TickCmti	;
+
+ if(Slot[ix].Stat >= 0 && t && (!DelCmti || (int32_t)(t - DelCmti) < 0)) DelCmti = t	;
+ Slot[ix].Stat = -1	; Slot[ix].TickCmti = 0	;}
+//-------------------------------------------------
+//  : "AT"    ';',    
+//    . AT+CMGS -  : "> "   PDU  ^Z.
+void	TMdmEmu::Command(char* cmd)
+{uint32_t	due = Clock.Now()	;
+ char		str[EMU_LINE+4]		;
+ char*		next				;
+ int		ok = 1				;
+
+ if((int32_t)(due - TickUp) < 0) return	;//  - 
+ CntCmd++	;
+ if(Trace) LogPrintf("  mdm> %s\n",cmd)	;
+ if(Echo){ snprintf(str,sizeof(str),"%s\r",cmd)	; Put(due,str)	;}
+ due += Delay[emuDlyAT]	;
+ if(StrCmp(cmd,"AT")){ CntErr++	; Put(due,"\r\nERROR\r\n")	; return	;}
+ cmd += 2	;
+ if(!StrCmp(cmd,"+CMGS=")){
+   PduLen = atoi(cmd+6)	;
+   if(PduLen > 0 && PduLen <= 164) Put(due,"\r\n> ")	;
+   else{ PduLen = 0	; CntErr++	; Put(due,"\r\n+CMS ERROR: 304\r\n")	;}
+   return	;}
+ for(;ok && cmd;cmd = next){
+   if((next = strchr(cmd,';')) != 0) *next++ = 0	;
+   ok = SubCommand(cmd,&due)	;}
+ if(!ok) CntErr++	;
+ Put(due,ok ? "\r\nOK\r\n" : "\r\nERROR\r\n",0,0,ok ? DelCmti : 0)	;
+ DelCmti = 0	;}
+//-------------------------------------------------
+//   "AT":  -     *due (  
+//  ). 0 - ERROR.
+int		TMdmEmu::SubCommand(char* cmd,uint32_t* due)
+{char	out[EMU_LINE+4]	;
+ int	ix, stat, n		;
+
+ *out = 0	;
+ if(!*cmd) return 1	;
+ if(!StrCmp(cmd,"E0") || !StrCmp(cmd,"E1")) Echo = cmd[1] == '1'	;
+ else if(!StrCmp(cmd,"^CURC=") || !StrCmp(cmd,"+CLIP=") || !StrCmp(cmd,"+CMGF=0")){}
+ else if(!StrCmp(cmd,"+COPS?")) snprintf(out,sizeof(out),"\r\n+COPS: 0,0,\"MdmEmu\",2\r\n")	;
+ else if(!StrCmp(cmd,"I"))      snprintf(out,sizeof(out),"\r\nManufacturer: host\r\nModel: MdmEmu\r\nRevision: 1\r\n")	;
+ else if(!StrCmp(cmd,"+CSQ"))   snprintf(out,sizeof(out),"\r\n+CSQ: 21,99\r\n")	;
+ else if(!StrCmp(cmd,"+CPMS?")){ n = Used()	;
+   snprintf(out,sizeof(out),"\r\n+CPMS: \"SM\",%d,%d,\"SM\",%d,%d,\"SM\",%d,%d\r\n",n,EMU_SLOT_CNT,n,EMU_SLOT_CNT,n,EMU_SLOT_CNT)	;}
+ else if(!StrCmp(cmd,"+CPMS=")){ n = Used()	;
+   snprintf(out,sizeof(out),"\r\n+CPMS: %d,%d,%d,%d,%d,%d\r\n",n,EMU_SLOT_CNT,n,EMU_SLOT_CNT,n,EMU_SLOT_CNT)	;}
+ else if(!StrCmp(cmd,"+CNMI?")) snprintf(out,sizeof(out),"\r\n+CNMI: 1,%d,2,2,1\r\n",Mt)	;
+ else if(!StrCmp(cmd,"+CNMI=")){ const char* p = strchr(cmd,',')	; Mt = p ? (char)atoi(p+1) : 0	;}
+ else if(!StrCmp(cmd,"H")){ *CallNmbr = 0	; *due += Delay[emuDlyATH]	;}
+ else if(!StrCmp(cmd,"+CMGL=")){
+   stat = atoi(cmd+6)	; *due += Delay[emuDlyCMGL]	;
+   for(ix=0;ix<EMU_SLOT_CNT;ix++){
+     if(Slot[ix].Stat < 0 || (stat != 4 && Slot[ix].Stat != stat)) continue	;
+     snprintf(out,sizeof(out),"\r\n+CMGL: %d,%d,,%d\r\n",ix+1,Slot[ix].Stat,Slot[ix].Len)	; Put(*due,out)	;
+     snprintf(out,sizeof(out),"%s\r\n",Slot[ix].Pdu)	; Put(*due,out)	;
+     Slot[ix].Stat = 1	;}
+   *out = 0	;}
+ else if(!StrCmp(cmd,"+CMGR=")){
+   ix = atoi(cmd+6) - 1	; *due += Delay[emuDlyCMGR]	;
+   if(ix < 0 || ix >= EMU_SLOT_CNT || Slot[ix].Stat < 0) return 0	;
+   snprintf(out,sizeof(out),"\r\n+CMGR: %d,,%d\r\n",Slot[ix].Stat,Slot[ix].Len)	; Put(*due,out)	;
+   snprintf(out,sizeof(out),"%s\r\n",Slot[ix].Pdu)	;
+   Slot[ix].Stat = 1	;}
+ else if(!StrCmp(cmd,"+CMGD=")){
+   const char*	p = strchr(cmd,',')	;
+   ix = atoi(cmd+6) - 1	; n = p ? atoi(p+1) : 0	; *due += Delay[emuDlyCMGD]	;
+   if(n == 0){ if(ix < 0 || ix >= EMU_SLOT_CNT) return 0	; Del(ix)	;}
+   else for(ix=0;ix<EMU_SLOT_CNT;ix++) if(n == 4 || Slot[ix].Stat == 1) Del(ix)	;}
+ else return 0	;
+ if(*out) Put(*due,out)	;
+ return 1	;}
+//-------------------------------------------------
+// PDU  ^Z:  TPDU    AT+CMGS,    -  
+//   
+void	TMdmEmu::OnPdu(void)
+{char		nmbr[PDU_LEN_NMBR], text[PDU_LEN_TEXT+1], str[32]	;
+ int		seq, cnt, len = (int)strlen(Line)	;
+ uint32_t	due = Clock.Now() + Delay[emuDlyAT]	;
+ char		hex[EMU_LINE]	;
+
+ if(Trace) LogPrintf("  mdm> %s^Z\n",Line)	;
+ strcpy(hex,Line)	;
+ if((len & 1) || HexByte(Line) < 0 || len/2 - 1 - HexByte(Line) != PduLen ||
+	!Submit(hex,nmbr,sizeof(nmbr),text,&seq,&cnt)){
+   CntErr++	; Put(due,"\r\n+CMS ERROR: 304\r\n")	; return	;}
+ due += Delay[emuDlyCMGS] - Delay[emuDlyAT]	;
+ if(NoNet){ CntRej++	; Put(due,"\r\n+CMS ERROR: 500\r\n")	; return	;}
+ if(seq <= 1) *SentText = 0	;
+ strncat(SentText,text,sizeof(SentText)-strlen(SentText)-1)	;
+ snprintf(str,sizeof(str),"\r\n+CMGS: %d\r\n",++Mr)	;
+ if(seq >= cnt){ CntSent++	; Put(due,str,nmbr,SentText)	;}
+ else Put(due,str)	;
+ Put(due,"\r\nOK\r\n")	;}
+//-------------------------------------------------
+void	TMdmEmu::Attach(USBH_CDC_Dev* dev)
+{
+ Dev = dev	; TickUp = Clock.Now() + Boot	;
+ Mt = 0	; Echo = 1	; LineLen = PduLen = 0	; memset(Ans,0,sizeof(Ans))	;
+ HostCdcAttach(dev,this,OnOut)	;}
+//-------------------------------------------------
+//  :  ,    SIM 
+void	TMdmEmu::Lost(void)
+{
+ HostCdcDetach(Dev)	; memset(Ans,0,sizeof(Ans))	; *CallNmbr = 0	; LineLen = PduLen = 0	;}
+//-------------------------------------------------
+void	TMdmEmu::Call(const char* nmbr)
+{
+ strncpy(CallNmbr,nmbr,sizeof(CallNmbr)-1)	; CallNmbr[sizeof(CallNmbr)-1] = 0	;
+ RingCnt = 0	; NextRing = Clock.Now()	;}
+//-------------------------------------------------
+//  :  - ,      (  +CMT)
+void	TMdmEmu::Sms(const char* nmbr,const char* text)
+{char		hex[PDU_LEN_HEX], str[40]	;
+ int		len = (int)strlen(text), cnt, seq, tlen, ix	;
+ uint32_t	now = Clock.Now()	;
+
+ cnt = len <= PDU_LEN_TEXT ? 1 : (len + EMU_PART_LEN-1)/EMU_PART_LEN	;
+ if(cnt > EMU_PART_MAX) cnt = EMU_PART_MAX	;
+ Ref++	;
+ for(seq=1;seq<=cnt;seq++){
+   int	pos = (seq-1)*EMU_PART_LEN, n = cnt > 1 ? EMU_PART_LEN : len	;
+   if(n > len - pos) n = len - pos	;
+   tlen = Deliver(hex,sizeof(hex),nmbr,text + pos,n,Ref,cnt > 1 ? cnt : 0,seq)	;
+   CntIn++	;
+   if(Mt == 2 && Dev && Dev->Active){
+     snprintf(str,sizeof(str),"\r\n+CMT: ,%d\r\n",tlen)	; Put(now,str)	;
+     strcat(hex,"\r\n")	; Put(now,hex)	; continue	;}
+   if((ix = Store(hex,tlen)) < 0){ CntInDrop++	; continue	;}
+   if(Mt == 1 && Dev && Dev->Active){ snprintf(str,sizeof(str),"\r\n+CMTI: \"SM\",%d\r\n",ix+1)	; Put(now,str)	;
+     Slot[ix].TickCmti = now ? now : 1	;}
+ }
+}
+//-------------------------------------------------
+void	TMdmEmu::Frame(void)
+{uint32_t	now = Clock.Now()	;
+ char		str[64]	;
+ int		ix	;
+
+ if(!Dev || !Dev->Active) return	;
+ if(*CallNmbr && (int32_t)(now - NextRing) >= 0 && (int32_t)(now - TickUp) >= 0){
+   if(RingCnt++ < EMU_RING_MAX){
+     Put(now,"\r\nRING\r\n")	;
+     snprintf(str,sizeof(str),"\r\n+CLIP: \"%s\",%d,\"\",,\"\",0\r\n",CallNmbr,*CallNmbr == '+' ? 145 : 129)	; Put(now,str)	;}
+   else *CallNmbr = 0	;
+   NextRing = now + EMU_RING_MS	;}
+ for(ix=0;ix<EMU_ANS_CNT && Ans[ix].Due && (int32_t)(now - Ans[ix].Due) >= 0;ix++){
+   Out(Ans[ix].Str,(int)strlen(Ans[ix].Str))	;
+   if(Ans[ix].Cmti){ uint32_t d = now - Ans[ix].Cmti	; CntDel++	; DelSum += d	; if(d > DelMax) DelMax = d	;}
+   if(*Ans[ix].Nmbr && OnSent) OnSent(Ctx,Ans[ix].Nmbr,Ans[ix].Text,now)	;}
+ if(ix){ memmove(Ans,Ans+ix,(EMU_ANS_CNT-ix)*sizeof(TAns))	; memset(Ans+EMU_ANS_CNT-ix,0,ix*sizeof(TAns))	;}
+}
+//-------------------------------------------------
+// SMS-DELIVER: SMSC, , PID/DCS 0,  , UD (7 , UDH
+// 8-   ).   TPDU.
+int		TMdmEmu::Deliver(char* hex,int size,const char* nmbr,const char* text,int len,
+						 uint8_t ref,uint8_t cnt,uint8_t seq)
+{static const uint8_t	Scts[7] = {0x62,0x10,0x71,0x51,0x00,0x00,0x21}	;
+ uint8_t	pdu[PDU_LEN_HEX/2]	;
+ uint8_t*	ud					;
+ int		ix = 0, sca, udhl = 0, k0, bit, n, udl	;
+
+ memset(pdu,0,sizeof(pdu))	;
+ ix = sca = PutAddr(pdu,EMU_SCA,1)	;
+ pdu[ix++] = (uint8_t)(0x04 | (cnt > 1 ? 0x40 : 0))	;// SMS-DELIVER,   [+UDHI]
+ ix += PutAddr(pdu + ix,nmbr,0)	;
+ pdu[ix++] = 0x00	; pdu[ix++] = 0x00	;
+ memcpy(pdu + ix,Scts,7)	; ix += 7	;
+ udl = ix++	; ud = pdu + ix	;
+ if(cnt > 1){ ud[0] = 5	; ud[1] = 0x00	; ud[2] = 3	; ud[3] = ref	; ud[4] = cnt	; ud[5] = seq	; udhl = 6	;}
+ k0 = (udhl*8 + 6)/7	;
+ if(len > 160 - k0) len = 160 - k0	;
+ for(n=0;n<len;n++){
+   bit = (k0 + n)*7	;
+   ud[bit/8] |= (uint8_t)(Gsm7(text[n]) << (bit & 7))	;
+   if((bit & 7) > 1) ud[bit/8 + 1] |= (uint8_t)(Gsm7(text[n]) >> (8 - (bit & 7)))	;}
+ pdu[udl] = (uint8_t)(k0 + len)	;
+ ix += ((k0 + len)*7 + 7)/8	;
+ if(size < 2*ix + 1) return 0	;
+ for(n=0;n<ix;n++){ hex[2*n] = HexSmb[pdu[n] >> 4]	; hex[2*n+1] = HexSmb[pdu[n] & 0x0F]	;}
+ hex[2*ix] = 0	;
+ return ix - sca	;}
+//-------------------------------------------------
+// SMS-SUBMIT  :      (7   UCS2),
+// seq/cnt -  UDH  ( 1/1). hex     .
+int		TMdmEmu::Submit(char* hex,char* nmbr,int size,char* text,int* seq,int* cnt)
+{uint8_t*	pdu = (uint8_t*)hex	;
+ uint8_t*	ud	;
+ int		n, ix, p, fo, dig, dcs, udl, udhl = 0, bit, k	;
+
+ for(n=0;hex[2*n];n++){ if((ix = HexByte(hex + 2*n)) < 0) return 0	; pdu[n] = (uint8_t)ix	;}
+ *seq = *cnt = 1	;
+ p = 1 + pdu[0]	; if(p + 4 > n) return 0	;
+ fo = pdu[p++]	; if((fo & 0x03) != 0x01) return 0	;
+ p++	;// MR
+ dig = pdu[p++]	; k = 0	;
+ if(pdu[p++] == 0x91 && k < size-1) nmbr[k++] = '+'	;
+ for(ix=0;ix<dig && k < size-1;ix++) nmbr[k++] = (char)('0' + ((pdu[p + ix/2] >> ((ix & 1)*4)) & 0x0F))	;
+ nmbr[k] = 0	; p += (dig+1)/2	;
+ p++	;// PID
+ dcs = pdu[p++]	;
+ switch((fo >> 3) & 3){ case 2: p += 1	; break	; case 1: case 3: p += 7	; break	;}
+ if(p >= n) return 0	;
+ udl = pdu[p++]	; ud = pdu + p	;
+ if(fo & 0x40){
+   udhl = ud[0] + 1	;
+   for(ix=1;ix + 1 < udhl;ix += 2 + ud[ix+1])
+     if(ud[ix] == 0x00 && ud[ix+1] == 3){ *cnt = ud[ix+3]	; *seq = ud[ix+4]	;}}
+ k = 0	;
+ if(dcs == 0x00){
+   if(((udl*7 + 7)/8) > n - p) return 0	;
+   for(ix=(udhl*8 + 6)/7;ix<udl && k<PDU_LEN_TEXT;ix++){
+     bit = ix*7	;
+     text[k++] = Ascii((uint8_t)(((ud[bit/8] | (ud[bit/8 + 1] << 8)) >> (bit & 7)) & 0x7F))	;}}
+ else if(dcs == 0x08){
+   if(udl > n - p) return 0	;
+   for(ix=udhl;ix + 1 < udl && k<PDU_LEN_TEXT;ix += 2) text[k++] = ud[ix] ? '?' : (char)ud[ix+1]	;}
+ else return 0	;
+ text[k] = 0	;
+ return 1	;}
+//-------------------------------------------------
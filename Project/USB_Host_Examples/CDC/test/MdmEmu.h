@@ -0,0 +1,94 @@
+//-------------------------------------------------
+#ifndef	MDM_EMU_H
+#define	MDM_EMU_H
+//-------------------------------------------------
+#include	<stdint.h>
+#include	"usbh_msc_core.h"
+#include	"Pdu.h"
+//-------------------------------------------------
+#define		EMU_SLOT_CNT		15		//   "SM"
+#define		EMU_ANS_CNT			64		//    
+#define		EMU_LINE			(PDU_LEN_HEX+16)
+#define		EMU_RING_MS			3000	// RING + CLIP,   ATH
+#define		EMU_RING_MAX		10		//     
+//-------------------------------------------------
+enum{
+  emuDlyAT		= 0,	//  
+  emuDlyCMGR	= 1,
+  emuDlyCMGL	= 2,
+  emuDlyCMGD	= 3,
+  emuDlyCMGS	= 4,	//  ^Z  +CMGS: 
+  emuDlyATH		= 5,
+  emuDlyCnt
+};
+//-------------------------------------------------
+//     (  ): , , 
+typedef	void	(*TEmuSent)(void* Ctx,const char* Nmbr,const char* Text,uint32_t Tick)	;
+//-------------------------------------------------
+//   :   AT-  (usart_GSM) 
+//  HostCdc,     .   - "SM", PDU
+// (SMS-DELIVER  UDH  ),  -  7  (ASCII-
+//  GSM).  CNMI: 0 -    , 1 - +CMTI, 2 - +CMT.
+class	TMdmEmu{
+ struct	TSlot{
+   char				Stat						;// -1 , 0 , 1 
+   uint32_t			TickCmti					;//   +CMTI  , 0 -  
+   short			Len							;// TPDU  +CMGR/+CMGL
+   char				Pdu[PDU_LEN_HEX]			;
+ };
+ struct	TAns{
+   uint32_t			Due							;// 0 -  
+   char				Str[EMU_LINE]				;
+   char				Nmbr[PDU_LEN_NMBR]			;//  :  TEmuSent
+   char				Text[PDU_PART_MAX*PDU_LEN_TEXT+1]	;
+   uint32_t			Cmti						;// OK  AT+CMGD:   +CMTI 
+ };
+ USBH_CDC_Dev*		Dev							;
+ TSlot				Slot[EMU_SLOT_CNT]			;
+ TAns				Ans[EMU_ANS_CNT]			;
+ char				Line[EMU_LINE]				;//   \r  PDU  ^Z
+ int				LineLen						;
+ int				PduLen						;//  PDU  "> ",  TPDU; 0 - 
+ uint32_t			TickUp						;//    ()
+ uint32_t			NextRing					;
+ int				RingCnt						;
+ char				CallNmbr[PDU_LEN_NMBR]		;
+ char				Mt							;// CNMI <mt>
+ char				Echo						;
+ uint8_t			Mr,Ref						;
+ char				SentText[PDU_PART_MAX*PDU_LEN_TEXT+1]	;//  
+ uint32_t			DelCmti						;//     +CMTI:  
+ void		Put(uint32_t due,const char* str,const char* nmbr=0,const char* text=0,uint32_t cmti=0)	;
+ void		Command(char* cmd)					;
+ int		SubCommand(char* cmd,uint32_t* due)	;// 0 - ERROR
+ void		OnPdu(void)							;
+ int		Store(const char* pdu,int len)		;
+ int		Used(void)							;
+ void		Del(int ix)							;//   (AT+CMGD)
+ void		Out(const char* data,int len)		;
+public:
+ int				Boot						;//      
+ int				Delay[emuDlyCnt]			;
+ int				Trace						;//  -  
+ int				NoNet						;//    : +CMS ERROR  
+ uint32_t			CntCmd,CntErr				;// ; ERROR  ,     
+ uint32_t			CntSent,CntIn,CntInDrop		;
+ uint32_t			CntRej						;//  (NoNet)
+ uint32_t			CntDel,DelMax				;//  +CMTI  OK  AT+CMGD  : , , 
+ double				DelSum						;
+ TEmuSent			OnSent						;
+ void*				Ctx							;
+   TMdmEmu(void)								;
+ void		Attach(USBH_CDC_Dev* dev)			;
+ void		Lost(void)							;
+ void		Call(const char* nmbr)				;
+ void		Sms(const char* nmbr,const char* text)	;
+ void		Frame(void)							;// 1 : URC,   
+ static void	OnOut(void* Mdm,const char* Data,int Len)	;
+ static int		Deliver(char* hex,int size,const char* nmbr,const char* text,int len,
+						uint8_t ref,uint8_t cnt,uint8_t seq)	;// SMS-DELIVER,  TPDU
+ static int		Submit(char* hex,char* nmbr,int size,char* text,int* seq,int* cnt)	;//  SMS-SUBMIT, 0 - 
+};
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,93 @@
+//-------------------------------------------------
+//  CDC    ( usbh_msc_core.c  HostOtg.c):
+//  FS   ( +CMGL),  64  - RXB_PKT_US  .
+//     GSM_LEN_FIFO    5 + rand(2*T) .
+//  - /   ,  IN  : - InBuff
+//   ,    , -   .
+//       .
+//	cdc_rx_bench [T, ]
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	"HostOtg.h"
+#include	"usbh_msc_core.h"
+#include	"MdmDb.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		RXB_PKT_US		55		// 64  +   ACK  12 /
+#define		RXB_RUN_US		2000000
+#define		RXB_RING		1024	// GSM_LEN_FIFO
+#define		RXB_LINE_RATE	(64*1000000/RXB_PKT_US)
+//-------------------------------------------------
+static	USB_OTG_CORE_HANDLE		Core			;
+static	USBH_HOST				Host			;
+static	USBH_CDC_Dev			Dev				;
+static	char					Ring[RXB_RING]	;
+static	uint32_t				Wr, Rd, Sent	;
+static	uint32_t				Bad, Idle		;
+//-------------------------------------------------
+static	char*	GetRxBuff(void* Ctx,int* Len)
+{uint32_t	off = Wr % RXB_RING, free = RXB_RING - (Wr - Rd)	;
+
+ *Len = RXB_RING - off < free ? RXB_RING - off : free	;
+ return *Len ? Ring + off : 0	;}
+//-------------------------------------------------
+static	int		CommitRx(void* Ctx,int Len){ Wr += Len	; return Len	;}
+//-------------------------------------------------
+static const USBH_CDC_Cb_TypeDef	CdcCb = {0,GetRxBuff,CommitRx}	;
+//-------------------------------------------------
+static	uint32_t	Rnd		;
+static	uint32_t	Random(uint32_t n){ Rnd = Rnd*1103515245 + 12345	; return n ? (Rnd >> 8) % n : 0	;}
+//-------------------------------------------------
+// T -      ; 1 - IN 
+//  idle ()
+static	void	Run(uint32_t t,double idle)
+{uint8_t	in	;
+ THostHc*	h	;
+ uint32_t	next = 0, n	;
+
+ USBH_MSC_cb.DeInit(&Core,&Host)	;
+ HostOtgReset(&Core)	; Wr = Rd = Sent = Bad = Idle = 0	; Rnd = 7	;
+ USBH_Alloc_Channel(&Core,0x00)	; USBH_Alloc_Channel(&Core,0x80)	;// 0, 1 - ,   HOST_DEV_ATTACHED
+ CHECK_INT(USBH_MSC_cb.Init(&Core,&Host),USBH_OK)	;
+ USBH_MSC_cb.Requests(&Core,&Host)	;
+ in = Dev.hc_num_in	; h = HostHc + in	;
+ for(;HostUs < RXB_RUN_US;HostTime(1)){
+   if(h->Armed && h->TimeArm + RXB_PKT_US <= HostUs){
+     for(n=0;n<64 && n<h->Len;n++) h->Buf[n] = (uint8_t)(Sent + n)	;
+     Sent += n	;
+     HostHcIrq(in,HC_XFRC,n)	;}
+   if(!h->Armed) Idle++	;
+   if(HostUs < next) continue	;
+   USBH_MSC_cb.Machine(&Core,&Host)	;
+   for(;Rd != Wr;Rd++) if((uint8_t)Ring[Rd % RXB_RING] != (uint8_t)Rd) Bad++	;// GetS
+   next = HostUs + 5 + Random(2*t)	;}
+
+ printf("loop %5u us: %8.0f B/s (line %u), IN idle %4.1f%%\n",t,Wr*1e6/RXB_RUN_US,RXB_LINE_RATE,Idle*100.0/RXB_RUN_US)	;
+ CHECK_INT(Bad,0)	;
+ CHECK(Sent - Wr <= 2*USBH_CDC_IN_BUFF)	;
+ CHECK(Idle < idle*RXB_RUN_US)			;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{
+ CHECK(MdmDbSet(MdmDbRom,MdmDbRomSize))		;
+ CHECK(USBH_CDC_Bind(&Dev,&Core,&CdcCb,0))	;
+ Dev.Mdm = MdmDbFind(0x12D1,0x155B)			;//     
+ Host.device_prop.Dev_Desc.idVendor = 0x12D1	; Host.device_prop.Dev_Desc.idProduct = 0x1506	;
+ Host.device_prop.Cfg_Desc.bNumInterfaces = 1		;
+ Host.device_prop.Itf_Desc[0].bInterfaceClass = 0xFF	; Host.device_prop.Itf_Desc[0].bInterfaceProtocol = 0x62	;
+ Host.device_prop.Itf_Desc[0].bNumEndpoints = 2	;
+ Host.device_prop.Ep_Desc[0][0].bEndpointAddress = 0x81	; Host.device_prop.Ep_Desc[0][0].bmAttributes = EP_TYPE_BULK	;
+ Host.device_prop.Ep_Desc[0][0].wMaxPacketSize = 64		;
+ Host.device_prop.Ep_Desc[0][1].bEndpointAddress = 0x01	; Host.device_prop.Ep_Desc[0][1].bmAttributes = EP_TYPE_BULK	;
+ Host.device_prop.Ep_Desc[0][1].wMaxPacketSize = 64		;
+
+ if(argc > 1){ Run(atoi(argv[1]),1)	; return CheckDone("cdc_rx_bench")	;}
+ Run(0,0.02)	;
+ Run(250,0.02)	;
+ Run(500,0.10)	;
+ Run(1000,1)	;//   - ,   IN
+ Run(2000,1)	;
+ return CheckDone("cdc_rx_bench")	;}
+//-------------------------------------------------
@@ -0,0 +1,334 @@
+//-------------------------------------------------
+//    CDC   ( usbh_msc_core.c 
+// HostOtg.c):    URB     
+//     (GetS   ).    
+//  0..J .     ,     
+//    (URB ->  = 0)  IN    ,
+//    .   -    InBuff, 
+//  USBH_CDC_Handle  GetS;      .
+// OUT:  200      , NAK - .
+//  OUT:         ZLP;
+// DropTx,    ,   ,    , -
+//    AT ; ,  NAK- , 
+//  USBH_CDC_TX_NAK_MS   . ,   
+// (  ),    GetS,  ; 
+// USBH_Process  GetS ,     (USBH_CDC_RxParked).
+//   -  HC_STAT (UsbhStatLog)      .
+//	cdc_urb [, ]
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	"HostOtg.h"
+#include	"usb_hcd.h"
+#include	"UsbhStat.h"
+#include	"Log.h"
+#include	"usbh_msc_core.h"
+#include	"MdmDb.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		URB_STEP		5		//  , 
+#define		URB_PKT_US		50		//  64    FS
+#define		URB_RUN_US		2000000
+#define		URB_RING		1024	// GSM_LEN_FIFO
+#define		URB_SEQ			(1 << 18)	//    ( ,  InBuff,  )
+#define		URB_LINE		40		//  :   URB_LINE_US
+#define		URB_LINE_US		20000
+#define		URB_TX_LEN		200		//   :   URB_TX_US
+#define		URB_TX_US		10000
+#define		URB_TX_NAK		3		//    OUT   NAK
+#define		URB_TX_MAX_US	500		// 4   NAK -    
+#define		URB_STREAM		200000	//  , /:  10    
+//-------------------------------------------------
+typedef	struct	Struct_UrbRes{
+	uint32_t	Bytes			;
+	uint32_t	Pkt, PktRing	;// ;       
+	uint32_t	RearmIsr		;// IN    
+	uint32_t	RingMax			;// URB -> , 
+	double		RingSum			;
+	uint32_t	ReadMax			;//  -> , 
+	double		ReadSum			;
+	uint32_t	TxCnt, TxMax	;// ;  , 
+	double		TxSum			;
+	uint32_t	Bad				;//        
+} TUrbRes;
+//-------------------------------------------------
+static	USB_OTG_CORE_HANDLE		Core				;
+static	USBH_HOST				Host				;
+static	USBH_CDC_Dev			Dev					;
+static	uint32_t				RdyT[URB_SEQ]		;//    
+static	uint32_t				CompT[URB_SEQ]		;//  URB 
+static	uint32_t				Prod, Sent			;// : ,  
+static	char					Ring[URB_RING]		;
+static	uint32_t				Wr, Rd				;
+static	char					TxBuf[URB_TX_LEN + 16]	;
+static	int						TxHead, TxLen		;
+static	uint32_t				TxT0, TxPkt, TxGot	;
+static	uint32_t				CntInit				;
+static	TUrbRes					Res					;
+static	uint32_t				Take = ~0u			;//     (  TFiFo)
+//-------------------------------------------------
+//  FnGetRxBuff  TUsartGSM:    
+static	char*	GetRxBuff(void* Ctx,int* Len)
+{uint32_t	off = Wr % URB_RING, free = URB_RING - (Wr - Rd)	;
+
+ *Len = URB_RING - off < free ? URB_RING - off : free	;
+ return *Len ? Ring + off : 0	;}
+//-------------------------------------------------
+static	int		CommitRx(void* Ctx,int Len)
+{uint32_t	lat	;
+
+ if((uint32_t)Len > Take) Len = Take	;
+ if(Take != ~0u) Take -= Len	;
+ for(int ix=0;ix<Len;ix++,Wr++){
+   lat = HostUs - CompT[Wr % URB_SEQ]	;
+   Res.RingSum += lat	; if(lat > Res.RingMax) Res.RingMax = lat	;}
+ Res.Bytes += Len	;
+ return Len	;}
+//-------------------------------------------------
+static	char*	GetTxBuff(void* Ctx,int* Len)
+{
+ *Len = TxLen - TxHead	;
+ return *Len > 0 ? TxBuf + TxHead : 0	;}
+//-------------------------------------------------
+static	void	CommitTx(void* Ctx,int Len)
+{uint32_t	t	;
+
+ TxHead += Len	;
+ if(TxHead < TxLen) return	;
+ t = HostUs - TxT0	; Res.TxCnt++	; Res.TxSum += t	; if(t > Res.TxMax) Res.TxMax = t	;}
+//-------------------------------------------------
+static	int		GetTxLen(void* Ctx){ return TxLen - TxHead	;}
+static	void	MdmInit(void* Ctx){ CntInit++	;}
+//-------------------------------------------------
+static const USBH_CDC_Cb_TypeDef	CdcCb = {0,GetRxBuff,CommitRx,MdmInit,GetTxBuff,CommitTx,0,GetTxLen}	;
+//-------------------------------------------------
+// GetS:   ,      (seq & 0xFF)
+static	void	Read(void)
+{uint32_t	lat	;
+
+ for(;Rd != Wr;Rd++){
+   if((uint8_t)Ring[Rd % URB_RING] != (uint8_t)Rd) Res.Bad++	;
+   lat = HostUs - RdyT[Rd % URB_SEQ]	;
+   Res.ReadSum += lat	; if(lat > Res.ReadMax) Res.ReadMax = lat	;}
+}
+//-------------------------------------------------
+// : IN  ( ,  ), OUT -  ,  NAK
+static	void	Bus(void)
+{uint8_t	in = Dev.hc_num_in, out = Dev.hc_num_out	;
+ THostHc*	h = HostHc + in	;
+ uint32_t	n, was	;
+
+ if(h->Armed && Sent < Prod && RdyT[Sent % URB_SEQ] + URB_PKT_US <= HostUs && h->TimeArm + URB_PKT_US <= HostUs){
+   for(n=0;n < Dev.InEpSize && n < h->Len && Sent + n < Prod;n++){
+     h->Buf[n] = (uint8_t)(Sent + n)	; CompT[(Sent + n) % URB_SEQ] = HostUs	;}
+   Sent += n	; Res.Pkt++	;
+   was = Res.Bytes	;
+   HostHcIrq(in,HC_XFRC,n)	;
+   if(Res.Bytes - was >= n) Res.PktRing++	;
+   if(HostHc[in].Armed) Res.RearmIsr++	;}
+
+ h = HostHc + out	;
+ if(h->Armed && h->TimeArm + URB_PKT_US <= HostUs){
+   if(h->Len && ++TxPkt % URB_TX_NAK == 0){ HostHcIrq(out,HC_NAK,0)	; return	;}
+   for(n=0;n<h->Len;n++,TxGot++) if(h->Buf[n] != (char)('A' + TxGot % 26)) Res.Bad++	;
+   HostHcIrq(out,HC_XFRC,0)	;}
+}
+//-------------------------------------------------
+static	uint32_t	Rnd		;
+static	uint32_t	Random(uint32_t n){ Rnd = Rnd*1103515245 + 12345	; return n ? (Rnd >> 8) % n : 0	;}
+//-------------------------------------------------
+//    :    , USBH_CDC_INIT,   IN
+static	void	Attach(void)
+{
+ USBH_MSC_cb.DeInit(&Core,&Host)	;
+ HostOtgReset(&Core)	;
+ USBH_Alloc_Channel(&Core,0x00)	; USBH_Alloc_Channel(&Core,0x80)	;// 0, 1 - ,   HOST_DEV_ATTACHED
+ CHECK_INT(USBH_MSC_cb.Init(&Core,&Host),USBH_OK)	;
+ CHECK(Dev.Active)	;
+ USBH_MSC_cb.Requests(&Core,&Host)	;
+ USBH_MSC_cb.Machine(&Core,&Host)	;
+ USBH_MSC_cb.Machine(&Core,&Host)	;
+ CHECK(HostHc[Dev.hc_num_in].Armed)	;}
+//-------------------------------------------------
+//    OUT:    ( NAK- ), IN 
+static	uint32_t				OutLen[16]			;//  ,    
+static	int						OutCnt, Nak			;
+static	char					OutGot[URB_TX_LEN + 16]	;
+static	uint32_t				OutGotLen			;
+//-------------------------------------------------
+static	void	BusOut(uint32_t us)
+{THostHc*	h	;
+ uint32_t	end = HostUs + us	;
+
+ for(;HostUs < end;HostTime(URB_STEP)){
+   h = HostHc + Dev.hc_num_out	;
+   if(h->Armed && h->TimeArm + URB_PKT_US <= HostUs){
+     if(Nak){ HostHcIrq(Dev.hc_num_out,HC_NAK,0)	; continue	;}
+     if(OutCnt < 16) OutLen[OutCnt++] = h->Len	;
+     if(OutGotLen + h->Len <= sizeof(OutGot)){ memcpy(OutGot + OutGotLen,h->Buf,h->Len)	; OutGotLen += h->Len	;}
+     HostHcIrq(Dev.hc_num_out,HC_XFRC,0)	;}
+   USBH_MSC_cb.Machine(&Core,&Host)	;}
+}
+//-------------------------------------------------
+static	void	TxPut(const char* buf,int len)
+{
+ memcpy(TxBuf + TxLen,buf,len)	; TxLen += len	;}
+//-------------------------------------------------
+static	void	TxCmd(int len)
+{int		ix	;
+
+ TxHead = TxLen = 0	;
+ for(ix=0;ix<len;ix++) TxBuf[ix] = 'A' + ix % 26	;
+ TxLen = len	;}
+//-------------------------------------------------
+static	void	TxAttach(void)
+{
+ memset(&Res,0,sizeof(Res))	; Prod = Sent = Wr = Rd = 0	; TxHead = TxLen = 0	;
+ OutCnt = Nak = 0	; OutGotLen = 0	;
+ Attach()	;}
+//-------------------------------------------------
+//   1  2   -  ZLP  ; 100  -  ZLP
+static	void	TestZlp(void)
+{static const int	Len[] = {64,128,100}	;
+ int	ix, n, pkt	;
+
+ TxAttach()	;
+ for(ix=0;ix<3;ix++){
+   OutCnt = 0	; OutGotLen = 0	;
+   TxCmd(Len[ix])	; CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;
+   BusOut(5000)	;
+   pkt = (Len[ix] + 63)/64	;
+   printf("tx %3d B: %d packets, last %u B\n",Len[ix],OutCnt,OutCnt ? OutLen[OutCnt - 1] : 0)	;
+   CHECK_INT(OutCnt,pkt + (Len[ix] % 64 == 0))	;
+   for(n=0;n<pkt && n<OutCnt;n++) CHECK_INT(OutLen[n],n < pkt - 1 || Len[ix] % 64 == 0 ? 64 : Len[ix] % 64)	;
+   if(Len[ix] % 64 == 0) CHECK_INT(OutLen[pkt],0)	;
+   CHECK_INT(OutGotLen,Len[ix])	; CHECK(!memcmp(OutGot,TxBuf,Len[ix]))	;
+   CHECK_INT(TxHead,TxLen)	; CHECK(!HostHc[Dev.hc_num_out].Armed)	; CHECK(!Dev.TxBusy)	;}
+}
+//-------------------------------------------------
+// DropTx    ,   AT ( Operate_INIT): 
+// ,   ,  - 
+static	void	TestDropBusy(void)
+{
+ TxAttach()	;
+ TxCmd(URB_TX_LEN)	; CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;
+ CHECK(Dev.TxBusy)	; CHECK(HostHc[Dev.hc_num_out].Armed)	;
+ CHECK_INT(USBH_CDC_DropTx(&Dev),USBH_OK)	;
+ CHECK_INT(TxHead,0)	;//   -  
+ TxPut("AT\r",3)	; CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;
+ BusOut(5000)	;
+ printf("drop busy: %d packets, %u B out, queue %d/%d\n",OutCnt,OutGotLen,TxHead,TxLen)	;
+ CHECK_INT(OutCnt,2)	; CHECK_INT(OutLen[0],64)	; CHECK_INT(OutLen[1],3)	;
+ CHECK_INT(OutGotLen,67)	;
+ CHECK(!memcmp(OutGot,TxBuf,64))	; CHECK(!memcmp(OutGot + 64,"AT\r",3))	;
+ CHECK_INT(TxHead,TxLen)	; CHECK_INT(Dev.CntTxDrop,0)	;}
+//-------------------------------------------------
+//  NAK- :  USBH_CDC_TX_NAK_MS ( HFNUM, +-1 ) 
+// , CntTxDrop,     
+static	void	TestNakForever(void)
+{uint32_t	t0, t = 0	;
+
+ TxAttach()	; Nak = 1	;
+ TxCmd(URB_TX_LEN)	; t0 = HostUs	; CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;
+ while(!Dev.CntTxDrop && HostUs - t0 < 2*USBH_CDC_TX_NAK_MS*1000) BusOut(URB_STEP)	;
+ t = HostUs - t0	;
+ printf("nak forever: drop after %.1f ms, nak %u, queue %d/%d\n",t/1000.0,HCD_GetStat(&Core,Dev.hc_num_out)->Ev[HC_NAK],TxHead,TxLen)	;
+ CHECK_INT(Dev.CntTxDrop,1)	;
+ CHECK(t + 1000 >= USBH_CDC_TX_NAK_MS*1000)	; CHECK(t <= (USBH_CDC_TX_NAK_MS + 1)*1000)	;
+ CHECK_INT(TxHead,TxLen)	; CHECK_INT(OutCnt,0)	;
+ CHECK(!HostHc[Dev.hc_num_out].Armed)	; CHECK(!Dev.TxBusy)	;
+ Nak = 0	; TxPut("AT\r",3)	; CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;
+ BusOut(1000)	;
+ CHECK_INT(OutCnt,1)	; CHECK_INT(OutGotLen,3)	; CHECK(!memcmp(OutGot,"AT\r",3))	;
+ CHECK_INT(Dev.CntTxDrop,1)	;}
+//-------------------------------------------------
+//    ,   10 : 54   InBuff[InHead], IN
+//    ;  GetS  ,   
+static	void	TestShortCommit(void)
+{int	ix	;
+
+ TxAttach()	;
+ Take = 10	;
+ for(ix=0;ix<64;ix++) RdyT[Prod++ % URB_SEQ] = HostUs	;
+ HostTime(URB_PKT_US)	; Bus()	;
+ printf("short commit: sent %u, ring %u, InBuff %u\n",Sent,Wr,Dev.InLen[Dev.InHead])	;
+ CHECK_INT(Sent,64)	; CHECK_INT(Wr,10)	; CHECK_INT(Dev.InLen[Dev.InHead],54)	;
+ CHECK(HostHc[Dev.hc_num_in].Armed)	;
+ CHECK(HostHc[Dev.hc_num_in].Buf == (uint8_t*)Dev.InBuff[Dev.InHead ^ 1])	;
+ CHECK_INT(USBH_CDC_RxParked(&Dev),1)	; CHECK_INT(USBH_CDC_RxParked(&Dev),0)	;
+ USBH_MSC_cb.Machine(&Core,&Host)	;
+ CHECK_INT(Wr,10)	;//    
+ CHECK_INT(USBH_CDC_RxParked(&Dev),1)	;
+ Take = ~0u	; USBH_MSC_cb.Machine(&Core,&Host)	;
+ CHECK_INT(Wr,64)	; CHECK_INT(Dev.InLen[0] + Dev.InLen[1],0)	;
+ CHECK_INT(USBH_CDC_RxParked(&Dev),0)	;//   -  
+ Read()	; CHECK_INT(Res.Bad,0)	;}
+//-------------------------------------------------
+// jit -     5 + rand(jit) ; rate - , /, 0 - 
+static	void	Run(uint32_t jit,uint32_t rate)
+{uint32_t	next = 0, line = 0, tx = 0	;
+ int		ix	;
+
+ memset(&Res,0,sizeof(Res))	; Prod = Sent = Wr = Rd = 0	; TxHead = TxLen = 0	; TxPkt = TxGot = 0	; Rnd = 7	;
+ Attach()	;
+ for(;HostUs < URB_RUN_US;HostTime(URB_STEP)){
+   if(rate) while(line <= HostUs && Prod - Rd < URB_SEQ/2){ RdyT[Prod++ % URB_SEQ] = line	; line += 1000000/rate	;}
+   else if(line <= HostUs){ for(ix=0;ix<URB_LINE;ix++) RdyT[Prod++ % URB_SEQ] = HostUs	; line += URB_LINE_US	;}
+   Bus()	;
+   if(HostUs < next) continue	;
+   USBH_MSC_cb.Machine(&Core,&Host)	;	//  main(): USBH_Process
+   Read()	;
+   if(TxHead == TxLen && tx <= HostUs){
+     for(ix=0;ix<URB_TX_LEN;ix++) TxBuf[ix] = 'A' + (TxGot + ix) % 26	;
+     TxHead = 0	; TxLen = URB_TX_LEN	; TxT0 = HostUs	; tx = HostUs + URB_TX_US	;
+     CHECK_INT(USBH_CDC_StartTx(&Dev),USBH_OK)	;}
+   next = HostUs + URB_STEP + Random(jit)	;}
+
+ printf("jitter %5u us, %-6s: %6.0f B/s, pkt %u (to ring in ISR %u), URB->ring avg %5.0f max %5u us, modem->GetS avg %5.0f max %5u us, tx %dB avg %4.0f max %4u us\n",
+		jit,rate ? "stream" : "lines",Res.Bytes*1e6/URB_RUN_US,Res.Pkt,Res.PktRing,Res.Bytes ? Res.RingSum/Res.Bytes : 0,Res.RingMax,
+		Wr ? Res.ReadSum/Wr : 0,Res.ReadMax,URB_TX_LEN,Res.TxCnt ? Res.TxSum/Res.TxCnt : 0,Res.TxMax)	;
+ UsbhStatLog(&Core)	;							// ,    "usb"
+ while(!LogEmpty()) usleep(1000)		;
+ CHECK_INT(HCD_GetStat(&Core,Dev.hc_num_in)->Bytes,Sent)	;
+ CHECK_INT(HCD_GetStat(&Core,Dev.hc_num_out)->Bytes,TxGot)	;
+ CHECK_INT(HCD_GetStat(&Core,Dev.hc_num_out)->Retry,HCD_GetStat(&Core,Dev.hc_num_out)->Ev[HC_NAK])	;
+ CHECK_INT(Res.Bad,0)	;
+ CHECK(Sent - Wr <= 2*USBH_CDC_IN_BUFF)	;//   -      InBuff
+ CHECK(Res.TxCnt > 0)	;
+ CHECK(Res.TxMax < URB_TX_MAX_US)	;
+ if(!rate){									//   :  -  
+   CHECK_INT(Res.RingMax,0)				;
+   CHECK_INT(Res.PktRing,Res.Pkt)			;
+   CHECK_INT(Res.RearmIsr,Res.Pkt)		;
+   CHECK(Prod - Sent <= URB_LINE)		;}
+}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{static const uint32_t	Jit[] = {0,2000,10000}	;
+ int		ix	;
+
+ LogInit()	;
+ CHECK(MdmDbSet(MdmDbRom,MdmDbRomSize))		;
+ CHECK(USBH_CDC_Bind(&Dev,&Core,&CdcCb,0))	;
+ Dev.Mdm = MdmDbFind(0x12D1,0x155B)			;//     
+ CHECK(Dev.Mdm != 0)	;
+ Host.device_prop.Dev_Desc.idVendor = 0x12D1	; Host.device_prop.Dev_Desc.idProduct = 0x1506	;
+ Host.device_prop.Cfg_Desc.bNumInterfaces = 1		;
+ Host.device_prop.Itf_Desc[0].bInterfaceClass = 0xFF	; Host.device_prop.Itf_Desc[0].bInterfaceProtocol = 0x62	;
+ Host.device_prop.Itf_Desc[0].bNumEndpoints = 2	;
+ Host.device_prop.Ep_Desc[0][0].bEndpointAddress = 0x81	; Host.device_prop.Ep_Desc[0][0].bmAttributes = EP_TYPE_BULK	;
+ Host.device_prop.Ep_Desc[0][0].wMaxPacketSize = 64		;
+ Host.device_prop.Ep_Desc[0][1].bEndpointAddress = 0x01	; Host.device_prop.Ep_Desc[0][1].bmAttributes = EP_TYPE_BULK	;
+ Host.device_prop.Ep_Desc[0][1].wMaxPacketSize = 64		;
+
+ if(argc > 1){ Run(atoi(argv[1]),0)	; Run(atoi(argv[1]),URB_STREAM)	;}
+ else for(ix=0;ix<(int)(sizeof(Jit)/sizeof(Jit[0]));ix++){ Run(Jit[ix],0)	; Run(Jit[ix],URB_STREAM)	;}
+ TestZlp()		;
+ TestDropBusy()	;
+ TestNakForever()	;
+ TestShortCommit()	;
+ CHECK(CntInit > 0)	;
+ return CheckDone("cdc_urb")	;}
+//-------------------------------------------------
@@ -0,0 +1,254 @@
+//-------------------------------------------------
+//     ( usbh_core.c, usbh_stdreq.c 
+// DescCache.c  HostOtg.c):  EnumUs,     ,
+//     -   (desc_cb = 0)   ,  RAM 
+//  flash  .  - :   
+// (SETUP, DATA  64 , STATUS) - , 1 ;    
+// ENC_STR_MS.  - Huawei   :  ,  .
+//   -     DESCC_FLASH_ADDR, FLASH_ProgramWord
+//   1->0. :      bcdDevice,
+//  ,  , SET_CONFIGURATION   ,
+// Init      -      
+// device_prop,     . Flash  
+// DescCacheSave (main),  USBH_Process -  .
+//	enum_cache
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<string.h>
+#include	<sys/mman.h>
+#include	"HostOtg.h"
+#include	"Check.h"
+// Ram, FlashUsed - : ""  
+#include	"DescCache.c"
+//-------------------------------------------------
+#define		ENC_STR_MS		5		//   
+#define		ENC_ERASE_MS	1000	//   128 
+#define		ENC_MS_MAX		5000	//   - 
+#define		ENC_CFG_LEN		85
+//-------------------------------------------------
+typedef	struct	Struct_EncRes{
+	uint32_t	Us		;// EnumUs
+	uint32_t	Ctl		;//  
+	uint32_t	Str		;//   
+	uint8_t		Cached	;
+} TEncRes;
+//-------------------------------------------------
+static	USB_OTG_CORE_HANDLE	Core					;
+static	USBH_HOST			Host					;
+static	uint8_t*			Flash					;
+static	uint32_t			FlashBad				;//  0->1   
+static	uint32_t			CntProg					;//    
+static	uint8_t				DevD[USB_DEVICE_DESC_SIZE] = {18,1,0x10,0x01,0,0,0,64,0xD1,0x12,0x06,0x15,0x00,0x01,1,2,3,1}	;
+static	uint8_t				CfgD[ENC_CFG_LEN]		;
+static	uint8_t				StrD[3][64]				;
+static	int					CtlLeft = -1			;//   , -1 -  
+static	uint32_t			CntCtl, CntStr, CntRej	;
+static	uint32_t			CntInit					;
+static	USBH_Device_TypeDef	Ref						;//   
+//-------------------------------------------------
+FLASH_Status	FLASH_ProgramWord(uint32_t addr,uint32_t data)
+{uint32_t*	w = (uint32_t*)(uintptr_t)addr	;
+
+ if((addr & 3) || addr < DESCC_FLASH_ADDR || addr + 4 > DESCC_FLASH_ADDR + DESCC_FLASH_SIZE){ FlashBad++	; return FLASH_ERROR_PGA	;}
+ if((*w & data) != data) FlashBad++	;
+ *w &= data	; CntProg++	;
+ return FLASH_COMPLETE	;}
+//-------------------------------------------------
+FLASH_Status	FLASH_EraseSector(uint32_t sector,uint8_t range)
+{
+ CHECK_INT(sector,FLASH_Sector_10)	;
+ memset(Flash,0xFF,DESCC_FLASH_SIZE)	; HostTime(ENC_ERASE_MS*1000)	; CntProg++	;
+ return FLASH_COMPLETE	;}
+//-------------------------------------------------
+void	FLASH_Unlock(void){}
+void	FLASH_Lock(void){}
+void	FLASH_ClearFlag(uint32_t flag){}
+//-------------------------------------------------
+// :  vendor 3+2+2 ,  - interrupt IN
+static	void	MakeCfg(void)
+{static const uint8_t	NumEp[3] = {3,2,2}	;
+ static const uint8_t	Ep[7][2] = {{0x81,3},{0x82,2},{0x01,2},{0x83,2},{0x02,2},{0x84,2},{0x03,2}}	;
+ uint8_t*	p = CfgD	;
+ int		i, e, k = 0	;
+
+ *p++ = 9	; *p++ = 2	; *p++ = ENC_CFG_LEN	; *p++ = 0	; *p++ = 3	; *p++ = 1	; *p++ = 0	; *p++ = 0xA0	; *p++ = 250	;
+ for(i=0;i<3;i++){
+   *p++ = 9	; *p++ = 4	; *p++ = i	; *p++ = 0	; *p++ = NumEp[i]	; *p++ = 0xFF	; *p++ = 0xFF	; *p++ = 0xFF	; *p++ = 0	;
+   for(e=0;e<NumEp[i];e++,k++){
+     *p++ = 7	; *p++ = 5	; *p++ = Ep[k][0]	; *p++ = Ep[k][1]	;
+     *p++ = Ep[k][1] == 3 ? 16 : 64	; *p++ = 0	; *p++ = Ep[k][1] == 3 ? 5 : 0	;}}
+}
+//-------------------------------------------------
+static	void	MakeStr(uint8_t* d,const char* s)
+{int	n	;
+
+ d[0] = 2 + 2*strlen(s)	; d[1] = USB_DESC_TYPE_STRING	;
+ for(n=0;*s;n++){ d[2+2*n] = *s++	; d[3+2*n] = 0	;}}
+//-------------------------------------------------
+//  :    ( USBH_Process - )
+static	USBH_Status	Ctl(USBH_HOST* phost,uint8_t* buff,uint16_t length)
+{USB_Setup_TypeDef*	s = &phost->Control.setup	;
+ const uint8_t*		src = 0	;
+ int				len = 0, type = s->b.wValue.w >> 8, ix = s->b.wValue.w & 0xFF	;
+
+ if(s->b.bRequest == USB_REQ_GET_DESCRIPTOR) switch(type){
+   case USB_DESC_TYPE_DEVICE:			src = DevD	; len = sizeof(DevD)	; break	;
+   case USB_DESC_TYPE_CONFIGURATION:	src = CfgD	; len = sizeof(CfgD)	; break	;
+   case USB_DESC_TYPE_STRING:			if(ix >= 1 && ix <= 3){ src = StrD[ix-1]	; len = src[0]	;} break	;}
+ if(len > length) len = length	;
+ if(CtlLeft < 0){
+   CtlLeft = 1 + (len + 63)/64 + (type == USB_DESC_TYPE_STRING && src ? ENC_STR_MS : 0)	;
+   CntCtl++	; if(type == USB_DESC_TYPE_STRING && src) CntStr++	;}
+ if(CtlLeft > 0){ CtlLeft--	; return USBH_BUSY	;}
+ CtlLeft = -1	;
+ if(s->b.bRequest == USB_REQ_SET_CONFIGURATION && s->b.wValue.w != CfgD[5]){ CntRej++	; return USBH_NOT_SUPPORTED	;}// STALL
+ if(src) memcpy(buff,src,len)	;
+ return USBH_OK	;}
+//-------------------------------------------------
+static	void	Nop(void){}
+static	void	NopP(void* p){}
+static	void	NopSpd(uint8_t s){}
+static	void	NopCfg(USBH_CfgDesc_TypeDef* c,USBH_InterfaceDesc_TypeDef* i,USBH_EpDesc_TypeDef* e){}
+static	USBH_USR_Status	Input(void){ return USBH_USR_RESP_OK	;}
+static	int		App(void){ return 0	;}
+static	USBH_Usr_cb_TypeDef	Usr = {Nop,Nop,Nop,Nop,Nop,Nop,NopSpd,NopP,Nop,NopCfg,NopP,NopP,NopP,Nop,Input,App,Nop,Nop}	;
+//-------------------------------------------------
+//     - ,    
+static	USBH_Status	ClsInit(USB_OTG_CORE_HANDLE* pdev,void* phost)
+{
+ CntInit++	;
+ return Host.device_prop.Ep_Desc[0][0].bEndpointAddress == CfgD[20] ? USBH_OK : USBH_NOT_SUPPORTED	;}
+static	void		ClsDeInit(USB_OTG_CORE_HANDLE* pdev,void* phost){}
+static	USBH_Status	ClsOk(USB_OTG_CORE_HANDLE* pdev,void* phost){ return USBH_OK	;}
+static	USBH_Class_cb_TypeDef	Cls = {ClsInit,ClsDeInit,ClsOk,ClsOk}	;
+//-------------------------------------------------
+static	int		Same(const USBH_Device_TypeDef* a,const USBH_Device_TypeDef* b)
+{
+ return !memcmp(&a->Cfg_Desc,&b->Cfg_Desc,sizeof(*a) - offsetof(USBH_Device_TypeDef,Cfg_Desc))	;}
+//-------------------------------------------------
+//   ;    -   main (TUsbhCore),
+//   -   (OnEnumDone). cache 2 - main 
+// DescCacheSave   (  )
+static	TEncRes	Attach(int cache)
+{TEncRes	r	;
+ uint32_t	c0 = CntCtl, s0 = CntStr, w0 = CntProg	;
+ int		ms	;
+
+ HostConnect(0)	; USBH_Process(&Core,&Host)	; HostConnect(1)	;
+ memset(&Host.device_prop.Dev_Desc,0,sizeof(Host.device_prop) - offsetof(USBH_Device_TypeDef,Dev_Desc))	;
+ Host.desc_cb = cache ? &DescCacheCb : 0	;
+ for(ms=0;ms<ENC_MS_MAX && Host.gState != HOST_CLASS;ms++){ USBH_Process(&Core,&Host)	; HostTime(1000)	;}
+ CHECK(Host.gState == HOST_CLASS)	; CHECK_INT(CntProg - w0,0)	;
+ if(cache == 1) DescCacheSave(&Host.device_prop)	;
+ r.Us = Host.EnumUs	; r.Ctl = CntCtl - c0	; r.Str = CntStr - s0	; r.Cached = Host.DescCached	;
+ return r	;}
+//-------------------------------------------------
+//  ,      
+static	void	CheckSame(void)
+{TEncRes	r	;
+ USBH_Device_TypeDef	got = Host.device_prop	;
+
+ r = Attach(0)	; (void)r	;
+ CHECK(Same(&got,&Host.device_prop))	;}
+//-------------------------------------------------
+//    
+static	uint32_t	Dead(void)
+{uint32_t	ix, n = 0	;
+
+ for(ix=0;ix<FlashUsed;ix++) if(Slot(ix)->Sign == DESCC_SIGN && Slot(ix)->Crc == DESCC_DEAD) n++	;
+ return n	;}
+//-------------------------------------------------
+static	void	Reboot(void)
+{
+ memset(Ram,0,sizeof(Ram))	; RamNext = 0	; Pend = 0	; Kill = 0	;
+ memset(&DescCacheStat,0,sizeof(DescCacheStat))	;
+ DescCacheInit()	;}
+//-------------------------------------------------
+static	void	Print(const char* name,TEncRes r)
+{
+ printf("%-24s %5.1f ms, ctl %u (str %u)%s; hit %u miss %u drop %u, flash %u erase %u\n",name,r.Us/1000.0,r.Ctl,r.Str,r.Cached ? ", cached" : "",
+		DescCacheStat.CntHit,DescCacheStat.CntMiss,DescCacheStat.CntDrop,DescCacheStat.CntFlash,DescCacheStat.CntErase)	;}
+//-------------------------------------------------
+int		main(void)
+{TEncRes	full, r	;
+ uint32_t	ix	;
+
+ Flash = mmap((void*)DESCC_FLASH_ADDR,DESCC_FLASH_SIZE,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,-1,0)	;
+ if(Flash != (uint8_t*)DESCC_FLASH_ADDR){ printf("no memory at 0x%08X\n",DESCC_FLASH_ADDR)	; return 2	;}
+ MakeCfg()	;
+ MakeStr(StrD[0],"HUAWEI Technology")	; MakeStr(StrD[1],"HUAWEI Mobile")	; MakeStr(StrD[2],"0123456789ABCDEF")	;
+ memset(Flash,0xA5,DESCC_FLASH_SIZE)	;//   10 -  
+ HostOtgReset(&Core)	; HostCtl = Ctl	;
+ USBH_Init(&Core,USB_OTG_FS_CORE_ID,&Host,&Cls,&Usr)	;
+ HostConnect(1)	;// HCD_Init  ConnSts
+ DescCacheInit()	;
+ CHECK_INT(FlashUsed,DESCC_SLOTS)	;
+
+ //  :    
+ full = Attach(0)	; Print("no cache",full)	;
+ Ref = Host.device_prop	;
+ CHECK(!full.Cached)	; CHECK_INT(full.Str,3)	;
+ CHECK_INT(Host.device_prop.Cfg_Desc.bNumInterfaces,3)	;
+ CHECK_INT(Host.device_prop.Ep_Desc[2][1].bEndpointAddress,0x03)	;
+
+ //    - ,     
+ r = Attach(1)	; Print("cold",r)	;
+ CHECK(!r.Cached)	; CHECK_INT(r.Ctl,full.Ctl)	;
+ CHECK_INT(DescCacheStat.CntErase,1)	; CHECK_INT(DescCacheStat.CntFlash,1)	;
+
+ //  
+ r = Attach(1)	; Print("RAM hit",r)	;
+ CHECK(r.Cached)	; CHECK_INT(r.Str,0)	;
+ CHECK(r.Ctl < full.Ctl)	; CHECK(r.Us < full.Us)	;
+ CHECK(Same(&Ref,&Host.device_prop))	;
+ Reboot()		;
+ r = Attach(1)	; Print("flash hit",r)	;
+ CHECK(r.Cached)	; CHECK_INT(DescCacheStat.CntHit,1)	;
+ CHECK(Same(&Ref,&Host.device_prop))	;
+ printf("enumeration: %.1f -> %.1f ms, control requests %u -> %u\n",full.Us/1000.0,r.Us/1000.0,full.Ctl,r.Ctl)	;
+
+ //   : bcdDevice  ,  
+ DevD[16] = 0	;
+ r = Attach(1)	; Print("changed desc",r)	; CHECK(!r.Cached)	;
+ r = Attach(1)	; CHECK(r.Cached)	; CheckSame()	;
+ DevD[16] = 3	;
+ r = Attach(1)	; CHECK(r.Cached)	;
+
+ //   (Sign , Crc ) - ,  -  
+ ix = FlashUsed	;
+ FLASH_ProgramWord(DESCC_FLASH_ADDR + ix*sizeof(TDescRec),DESCC_SIGN)	;
+ FLASH_ProgramWord(DESCC_FLASH_ADDR + ix*sizeof(TDescRec) + 4,0x150612D1)	;
+ Reboot()	; CHECK_INT(FlashUsed,ix + 1)	;
+ r = Attach(1)	; Print("after torn record",r)	; CHECK(r.Cached)	;
+ CHECK(Same(&Ref,&Host.device_prop))	;
+
+ //  : , RAM ;  -  flash
+ for(ix=0;ix<DESCC_SLOTS;ix++){ DevD[12] = ix	; DevD[13] = ix >> 8	; r = Attach(1)	;}
+ Print("journal wrap",r)	;
+ CHECK_INT(DescCacheStat.CntErase,1)	;
+ CHECK(DescCacheStat.CntFlash < DESCC_SLOTS)	;
+ Reboot()	; r = Attach(1)	; CHECK(r.Cached)	;
+ DevD[12] = 0x00	; DevD[13] = 0x01	;
+
+ //       (STALL  SET_CONFIGURATION);
+ //      -   
+ Attach(1)	; r = Attach(1)	; CHECK(r.Cached)	;
+ CfgD[5] = 2	; ix = Dead()	;
+ r = Attach(2)	; Print("SET_CONFIGURATION stall",r)	;
+ CHECK_INT(CntRej,1)	; CHECK(!r.Cached)	; CHECK_INT(DescCacheStat.CntDrop,1)	;
+ CHECK_INT(Host.device_prop.Cfg_Desc.bConfigurationValue,2)	;
+ CHECK_INT(Dead(),ix)	;//  RAM ,  flash -  main
+ r = Attach(1)	; CHECK(!r.Cached)	; CHECK_INT(CntRej,1)	;// Load  
+ CHECK_INT(Dead(),ix + 1)	;
+ r = Attach(1)	; CHECK(r.Cached)	; CheckSame()	;
+
+ // Init    ,    
+ CfgD[20] = 0x85	; ix = CntInit	;
+ r = Attach(1)	; Print("class init failed",r)	;
+ CHECK_INT(CntInit - ix,2)	; CHECK(!r.Cached)	; CHECK_INT(DescCacheStat.CntDrop,2)	; CHECK_INT(Kill,0)	;
+ CHECK_INT(Host.device_prop.Ep_Desc[0][0].bEndpointAddress,0x85)	;
+ Reboot()	; r = Attach(1)	; CHECK(r.Cached)	; CheckSame()	;
+
+ CHECK_INT(FlashBad,0)	;
+ return CheckDone("enum_cache")	;}
+//-------------------------------------------------
@@ -0,0 +1,134 @@
+//-------------------------------------------------
+// TEventQueue MPSC:  - ( ) 
+// , main .   -     :
+//       ,     .
+// PostOnce:     ,   , 
+// , -        (  
+//   ,  ..    ).  -  /.
+//	evq_mpsc [] [  ]
+//-------------------------------------------------
+#include	<stdlib.h>
+#include	<pthread.h>
+#include	<sched.h>
+#include	"EventQueue.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		MPSC_THR_MAX		8
+//-------------------------------------------------
+TEventQueue			EvQueue						;
+//-------------------------------------------------
+static	int					ThrCnt = 4			;
+static	uint32_t			PerThr = 250000		;
+static	uint32_t			Last[MPSC_THR_MAX]	;//    
+static	uint32_t			Got,Bad				;
+static	volatile uint32_t	Work				;// PostOnce:  
+static	uint32_t			Done,Signals		;
+static	volatile int		Stop				;
+//-------------------------------------------------
+static	void	OnStat(TEvent* ev)
+{int		thr = ev->Value	;
+ uint32_t	seq = (uint32_t)(uintptr_t)ev->strData[0]	;
+
+ if(thr < 0 || thr >= ThrCnt || seq != Last[thr] + 1) Bad++	;
+ else Last[thr] = seq	;
+ Got++	;}
+//-------------------------------------------------
+static	void*	Writer(void* arg)
+{int		thr = (int)(intptr_t)arg	;
+ uint32_t	seq	;
+
+ for(seq=1;seq<=PerThr;)
+   if(EvQueue.Post(evStat1,(const char*)(uintptr_t)seq,(short)thr)) seq++	;
+   else sched_yield()	;//  -  ,     
+ return 0	;}
+//-------------------------------------------------
+static	void	TestOrder(void)
+{pthread_t	thr[MPSC_THR_MAX]	;
+ uint32_t	total = ThrCnt*PerThr	;
+ double		sec	;
+ int		ix	;
+
+ EvQueue.Reset()	;
+ sec = HostSec()	;
+ for(ix=0;ix<ThrCnt;ix++) pthread_create(thr + ix,0,Writer,(void*)(intptr_t)ix)	;
+ while(Got < total && Bad < 100) if(!EvQueue.Dispatch()) sched_yield()	;
+ sec = HostSec() - sec	;
+ for(ix=0;ix<ThrCnt;ix++) pthread_join(thr[ix],0)	;
+ EvQueue.Dispatch()	;
+
+ printf("%d writers x %u: %u events in %.3f s, %.2f M/s, full %u, depth max %u, bad %u\n",
+		ThrCnt,PerThr,Got,sec,Got/sec/1e6,EvQueue.CntDrop,EvQueue.CntMax,Bad)	;
+ CHECK_INT(Got,total)	;
+ CHECK_INT(Bad,0)		;
+ for(ix=0;ix<ThrCnt;ix++) CHECK_INT(Last[ix],PerThr)	;
+ CHECK(EvQueue.CntMax <= EVQ_LEN)	;
+ CHECK(EvQueue.Empty())	;}
+//-------------------------------------------------
+static	void	OnWork(TEvent* ev)
+{
+ Signals++	;
+ Done += __atomic_exchange_n(&Work,0,__ATOMIC_SEQ_CST)	;}
+//-------------------------------------------------
+//   ,   ""    :
+//    ,      
+static	int		IrqInHandler	;
+static	void	OnIrq(TEvent* ev)
+{
+ OnWork(ev)	;
+ if(IrqInHandler){ IrqInHandler--	; Work++	; CHECK_INT(EvQueue.PostOnce(evUsbIrq),1)	;}}
+//-------------------------------------------------
+static	void*	Signaller(void* arg)
+{uint32_t	ix	;
+
+ for(ix=0;ix<PerThr;ix++){
+   __atomic_add_fetch(&Work,1,__ATOMIC_SEQ_CST)	;
+   EvQueue.PostOnce(evGsmRx)	;
+   if(!(ix & 63)) sched_yield()	;}
+ Stop = 1	;
+ return 0	;}
+//-------------------------------------------------
+static	void	TestPostOnce(void)
+{pthread_t	thr	;
+ int		ix	;
+
+ EvQueue.Reset()	; Work = 1	; Done = 0	; IrqInHandler = 1	;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),1)	;
+ CHECK_INT(EvQueue.Dispatch(),2)			;//  -   
+ CHECK_INT(Done,2)	;
+ CHECK_INT(Work,0)	;
+
+ EvQueue.Reset()	;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),1)	;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),0)	;//  
+ CHECK_INT(EvQueue.Dispatch(),1)			;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),1)	;//  -  
+ EvQueue.Dispatch()	;
+ for(ix=0;ix<EVQ_LEN;ix++) CHECK_INT(EvQueue.Post(evStat2),1)	;
+ CHECK_INT(EvQueue.Post(evStat2),0)			;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),0)	;// :  ,  
+ CHECK_INT(EvQueue.CntDrop,2)				;
+ CHECK_INT(EvQueue.Dispatch(),EVQ_LEN)		;
+ CHECK_INT(EvQueue.PostOnce(evUsbIrq),1)	;
+ EvQueue.Dispatch()	;
+
+ EvQueue.Reset()	; Work = Done = Signals = 0	; Stop = 0	;
+ pthread_create(&thr,0,Signaller,0)	;
+ while(!Stop) if(!EvQueue.Dispatch()) sched_yield()	;
+ pthread_join(thr,0)	;
+ while(EvQueue.Dispatch())	;//    -  ,   
+ printf("PostOnce: %u signals for %u posts, done %u, left %u\n",Signals,PerThr,Done,Work)	;
+ CHECK_INT(Done,PerThr)	;
+ CHECK_INT(Work,0)		;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{
+ if(argc > 1) ThrCnt = atoi(argv[1])	;
+ if(argc > 2) PerThr = atoi(argv[2])	;
+ if(ThrCnt < 1 || ThrCnt > MPSC_THR_MAX){ printf("1..%d writers\n",MPSC_THR_MAX)	; return 2	;}
+ EvQueue.Subscribe(evStat1,OnStat)	;
+ EvQueue.Subscribe(evGsmRx,OnWork)	;
+ EvQueue.Subscribe(evUsbIrq,OnIrq)	;
+ TestOrder()		;
+ TestPostOnce()		;
+ return CheckDone("evq_mpsc")	;}
+//-------------------------------------------------
@@ -0,0 +1,270 @@
+//-------------------------------------------------
+// TFiFo   :   ,    ,
+//  '>',    ( ).   GetS
+//       115200  921600  (  
+// 1 ,   64 B)   TFiFo,     
+//      .
+//	fifo_lines []
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	"FiFo.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		LN_FIFO				1024	//  FifoRx 
+#define		LN_STR				400		//   (PDU -  350)
+//-------------------------------------------------
+static	char		Buf[LN_FIFO]		;
+static	char		Str[LN_STR]			;
+static	const char	strEndS[] = "\n>"	;
+//-------------------------------------------------
+//  TFiFo (  ): In()   , GetS() 
+//    Out()   .
+class	TOldFiFo{
+ char*				Buf							;
+ short				Size,Tail,Head,Cnt			;
+ char				valPrevIn,valPrevOut		;
+public:
+ int				CntStr						;
+ void	Set(char* buf,int size){ Buf = buf	; Size = size	; Tail=Head=Cnt=CntStr=0	; valPrevIn=valPrevOut=0	;}
+ void	In(char val)
+ {if(Cnt<Size){ Cnt++	; Buf[Head] = val	; Head++	; if(Head>=Size) Head = 0	;}
+  else{ Cnt=CntStr=Tail=Head=valPrevIn=0	;}
+  if(CntStr <= Cnt && (val=='\n' || (val == '>' && !valPrevIn))) CntStr++	;
+  valPrevIn = (val == '\n' || val == '\r') ? 0:val	;}
+ char	Out(void)
+ {char val=0	;
+  if(Cnt>0){ Cnt--	; val = Buf[Tail]	; Tail++	; if(Tail>=Size) Tail = 0	;}
+  if(!Cnt) Tail=Head=CntStr=0	;
+  return val	;}
+ char*	GetS(char* buf,int lenBuf)
+ {int	ix=0	;
+  char	val=0	;
+  for(;ix<lenBuf && CntStr>0 && Cnt>0;){
+    valPrevOut = (val == '\n' || val == '\r') ? 0:val	;
+    val = Out()	;
+    if(ix<lenBuf-1 && val != '\n' && val != '\r') buf[ix++] = val	;
+    if(val == '\n' || (val == '>' && !valPrevOut)){ buf[ix] = 0	; if(CntStr>0) CntStr--	; break	;}}
+  return ix ? buf : 0	;}
+};
+//-------------------------------------------------
+static	int		Put(TFiFo* f,const char* s){ return f->Write(s,(int)strlen(s))	;}
+//-------------------------------------------------
+// ,     : 1 -   , 0 -   Str
+static	const char*	Get(TFiFo* f,int* len,int* inRing)
+{const char*	s = f->GetS(Str,sizeof(Str),len)	;
+
+ if(inRing) *inRing = (s && s != Str) ? 1:0	;
+ return s	;}
+//-------------------------------------------------
+static	void	TestLines(void)
+{TFiFo			f	;
+ const char*	s	;
+ int			len, ring	;
+
+ f.Set(Buf,LN_FIFO,0,strEndS)	;
+ Put(&f,"\r\nOK\r\n\r\n+CMTI: \"SM\",3\r\n")	;
+ CHECK_INT(f.GetCntStr(),2)				;//     
+ s = Get(&f,&len,&ring)					;
+ CHECK(s && !strcmp(s,"OK"))			; CHECK_INT(len,2)	; CHECK_INT(ring,1)	;
+ s = Get(&f,&len,&ring)					;
+ CHECK(s && !strcmp(s,"+CMTI: \"SM\",3"))	; CHECK_INT(ring,1)	;
+ CHECK(Get(&f,&len,0) == 0)				; CHECK_INT(len,0)	;
+ CHECK(f.Empty())						;//     GetS
+
+ Put(&f,"+CMGR: 0,,2")					;//    
+ CHECK_INT(f.GetCntStr(),0)				;
+ Put(&f,"5\r\n")						;
+ s = Get(&f,&len,0)						;
+ CHECK(s && !strcmp(s,"+CMGR: 0,,25"))	;
+
+ Put(&f,"\r\n> ")						;//  AT+CMGS   
+ s = Get(&f,&len,&ring)					;
+ CHECK(s && !strcmp(s,">"))				; CHECK_INT(ring,0)	;//  '>'  0 - 
+ CHECK(Get(&f,&len,0) == 0)				;
+ CHECK_INT(f.GetLen(),1)				;//   '>'   
+ Put(&f,"\r\n+CMGS: 7\r\n")				;
+ s = Get(&f,&len,0)						;
+ CHECK(s && !strcmp(s," "))				;//  -  ,   
+ s = Get(&f,&len,0)						;
+ CHECK(s && !strcmp(s,"+CMGS: 7"))		;}
+//-------------------------------------------------
+//      ;    GetS
+static	void	TestWrap(void)
+{TFiFo			f	;
+ char			pad[LN_FIFO], line[200]	;
+ const char*	s	;
+ int			len, ring, ix, free	;
+
+ f.Set(Buf,LN_FIFO,0,strEndS)	;
+ memset(pad,'x',sizeof(pad))	; pad[LN_FIFO-100] = '\n'	;
+ CHECK_INT(f.Write(pad,LN_FIFO-99),LN_FIFO-99)	;// Head  100   
+ s = Get(&f,&len,&ring)				;
+ CHECK_INT(len,LN_FIFO-100)			; CHECK_INT(ring,1)	;
+ free = f.GetFree()					;
+ CHECK_INT(free,99)					;//    
+ CHECK(Get(&f,&len,0) == 0)			;
+ CHECK_INT(f.GetFree(),LN_FIFO)		;
+
+ for(ix=0;ix<150;ix++) line[ix] = (char)('A' + ix % 26)	;
+ line[150] = '\r'	; line[151] = '\n'	;
+ CHECK_INT(f.Write(line,152),152)	;// 99  , 53  
+ s = Get(&f,&len,&ring)				;
+ CHECK_INT(len,150)					; CHECK_INT(ring,0)	;
+ CHECK(s && !memcmp(s,line,150) && !s[150])	;
+
+ CHECK_INT(f.Write(line,152),152)	;//  :    
+ s = f.GetS(Str,21,&len)			;
+ CHECK_INT(len,150)					; CHECK(s != Str)	;
+
+ CHECK(Get(&f,&len,0) == 0)			;// Head  205 (152*2 - 99)
+ CHECK_INT(f.Write(pad,LN_FIFO-305),LN_FIFO-305)	;
+ CHECK_INT(f.Write(line,152),152)	;//   ,   -  
+ s = f.GetS(Str,21,&len)			;
+ CHECK_INT(len,20)					;
+ CHECK(s == Str && !memcmp(s,pad,20))	;
+ CHECK(Get(&f,&len,0) == 0)			;
+ CHECK(f.Empty())					;}
+//-------------------------------------------------
+// GetWrBuf/Commit ( USB   )    
+static	void	TestCommit(void)
+{TFiFo			f	;
+ const char*	s	;
+ char*			dst	;
+ int			len, part, ix	;
+ const char		src[] = "\r\n+CSQ: 21,99\r\n\r\nOK\r\n"	;
+
+ f.Set(Buf,64,0,strEndS)		;
+ for(ix=0;ix<3;ix++){							 //  :   
+   for(part=0;part < (int)sizeof(src)-1;part += len){
+     dst = f.GetWrBuf(&len)		;
+     CHECK(dst != 0)			;
+     if(!dst) return			;
+     if(len > (int)sizeof(src)-1 - part) len = (int)sizeof(src)-1 - part	;
+     memcpy(dst,src + part,len)	; f.Commit(len)	;}
+   s = Get(&f,&len,0)			; CHECK(s && !strcmp(s,"+CSQ: 21,99"))	;
+   s = Get(&f,&len,0)			; CHECK(s && !strcmp(s,"OK"))	;
+   CHECK(Get(&f,&len,0) == 0)	;}
+}
+//-------------------------------------------------
+//    :      
+// (Write  , CntLineDrop -   ),  GetS 
+//  -      
+static	void	TestLineQueue(void)
+{TFiFo			f	;
+ char			line[16]	;
+ const char*	s	;
+ int			ix, len, cnt	;
+
+ f.Set(Buf,LN_FIFO,0,strEndS)	;
+ for(ix=0;ix<FIFO_CNT_LINE;ix++){ sprintf(line,"L%d\r\n",ix)	; CHECK_INT(Put(&f,line),strlen(line))	;}
+ CHECK_INT(f.GetCntStr(),FIFO_CNT_LINE)	;
+ CHECK_INT(Put(&f,"L32\r\nL33\r\n"),4)	;// "L32\r" , '\n' -  
+ CHECK_INT(Put(&f,"\nL33\r\n"),0)		;// ,  , -   
+ CHECK_INT(f.GetLineDrop(),1)			;
+ CHECK_INT(f.GetDrop(),0)				;
+ s = Get(&f,&len,0)						; CHECK(s && !strcmp(s,"L0"))	;
+ CHECK_INT(Put(&f,"\nL33\r\n"),5)		;//   -  L32,   L33
+ CHECK_INT(f.GetLineDrop(),2)			;
+ for(cnt=1;(s = Get(&f,&len,0)) != 0;cnt++){ sprintf(line,"L%d",cnt)	; CHECK(!strcmp(s,line))	;}
+ CHECK_INT(cnt,FIFO_CNT_LINE + 1)		;
+ CHECK_INT(Put(&f,"\n"),1)				;
+ s = Get(&f,&len,0)						;
+ CHECK(s && !strcmp(s,"L33"))			; CHECK_INT(len,3)	;
+ CHECK(Get(&f,&len,0) == 0)				;
+ CHECK(f.Empty())						;
+ CHECK_INT(f.GetLineDrop(),2)			;}
+//-------------------------------------------------
+//  : , URC, PDU (    )
+static	const char*	Corpus[] = {
+ "\r\nOK\r\n",
+ "\r\n+CMTI: \"SM\",3\r\n",
+ "\r\nRING\r\n\r\n+CLIP: \"+79231234567\",145,\"\",,\"\",0\r\n",
+ "\r\n+CSQ: 21,99\r\n\r\nOK\r\n",
+ "\r\n+CMGL: 1,0,,159\r\n07919761989901F0440B919761214365F7000062107151000021A00500030103016430D09C1E96D34154741914AFA7C76B9058FEBEBB41E6371EA4AEB7E173D0DB5E9683E8E832881DD6E741E4F7D905\r\n",
+ "\r\n+CMGR: 0,,40\r\n07919761989901F0440B919761214365F700006210715100002118050003010303EC6539888E2E83D8617D1E447E9F5D\r\n\r\nOK\r\n",
+ "\r\n> ",
+ "\r\n+CMGS: 12\r\n\r\nOK\r\n",
+ "\r\n^BOOT:12345678,0,0,0,75\r\n",
+};
+#define		CORPUS_CNT			(int)(sizeof(Corpus)/sizeof(Corpus[0]))
+//-------------------------------------------------
+struct	TStream{
+ char*				Data						;
+ int				Len							;
+};
+//-------------------------------------------------
+static	void	MakeStream(TStream* st,int size)
+{int	ix, len	;
+
+ st->Data = (char*)malloc(size)	; st->Len = 0	;
+ for(ix=0;;ix++){
+   len = (int)strlen(Corpus[ix % CORPUS_CNT])	;
+   if(st->Len + len > size) break	;
+   memcpy(st->Data + st->Len,Corpus[ix % CORPUS_CNT],len)	; st->Len += len	;}
+}
+//-------------------------------------------------
+//      : perMs   ,   64 B,
+//    main   .     .
+static	int		RunNew(const TStream* st,int perMs,long* sum)
+{TFiFo		f	;
+ const char* s	;
+ int		pos, tick, pkt, len, lines = 0	;
+
+ f.Set(Buf,LN_FIFO,0,strEndS)	; *sum = 0	;
+ for(pos=0;pos < st->Len;){
+   for(tick = perMs;tick > 0 && pos < st->Len;tick -= pkt,pos += pkt){
+     pkt = tick < 64 ? tick : 64	; if(pkt > st->Len - pos) pkt = st->Len - pos	;
+     f.Write(st->Data + pos,pkt)	;}
+   while((s = f.GetS(Str,sizeof(Str),&len)) != 0){ lines++	; *sum += len	;}
+ }
+ return lines	;}
+//-------------------------------------------------
+static	int		RunOld(const TStream* st,int perMs,long* sum)
+{static TOldFiFo	f	;
+ const char*	s	;
+ int			pos, tick, pkt, ix, lines = 0	;
+
+ f.Set(Buf,LN_FIFO)	; *sum = 0	;
+ for(pos=0;pos < st->Len;){
+   for(tick = perMs;tick > 0 && pos < st->Len;tick -= pkt,pos += pkt){
+     pkt = tick < 64 ? tick : 64	; if(pkt > st->Len - pos) pkt = st->Len - pos	;
+     for(ix=0;ix<pkt;ix++) f.In(st->Data[pos + ix])	;}
+   while(f.CntStr > 0)							 //   - 0,   
+     if((s = f.GetS(Str,sizeof(Str))) != 0){ lines++	; *sum += (long)strlen(s)	;}
+ }
+ return lines	;}
+//-------------------------------------------------
+static	void	Bench(const TStream* st,int baud,int rep)
+{int		perMs = baud/10/1000 + 1	;// 8N1: 10   
+ int		ix, lnNew = 0, lnOld = 0	;
+ long		sumNew = 0, sumOld = 0		;
+ double		tNew, tOld					;
+
+ tNew = HostSec()	;
+ for(ix=0;ix<rep;ix++) lnNew = RunNew(st,perMs,&sumNew)	;
+ tNew = HostSec() - tNew	;
+ tOld = HostSec()	;
+ for(ix=0;ix<rep;ix++) lnOld = RunOld(st,perMs,&sumOld)	;
+ tOld = HostSec() - tOld	;
+ printf("%6d baud (%3d B/ms): %d lines, index %.1f ns/line, rescan %.1f ns/line, x%.1f\n",
+		baud,perMs,lnNew,tNew*1e9/rep/lnNew,tOld*1e9/rep/lnOld,tOld/tNew)	;
+ CHECK_INT(lnNew,lnOld)		;//   
+ CHECK_INT(sumNew,sumOld)	;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{TStream	st	;
+ int		rep = argc > 1 ? atoi(argv[1]) : 20	;
+
+ TestLines()		;
+ TestWrap()			;
+ TestCommit()		;
+ TestLineQueue()	;
+
+ MakeStream(&st,1 << 20)	;
+ Bench(&st,115200,rep)	;
+ Bench(&st,921600,rep)	;
+ free(st.Data)	;
+ return CheckDone("fifo_lines")	;}
+//-------------------------------------------------
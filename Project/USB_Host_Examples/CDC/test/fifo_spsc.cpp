@@ -0,0 +1,114 @@
+//-------------------------------------------------
+// TFiFo SPSC:       ( ISR USB  main).
+//        bulk IN (Write 
+// GetWrBuf/Commit),   (Read  GetRdBuf/Skip)  
+//  .  - /    / .
+//	fifo_spsc []
+//-------------------------------------------------
+#include	<stdlib.h>
+#include	<string.h>
+#include	<pthread.h>
+#include	<sched.h>
+#include	"FiFo.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		SPSC_PKT			64		//  bulk FS
+//-------------------------------------------------
+struct	TSpsc{
+ TFiFo				Fifo						;
+ uint32_t			Total						;//   
+ uint32_t			Bad,BadAt					;//   ,  
+ uint32_t			SpinWr,SpinRd				;//  :   /   ( )
+};
+//-------------------------------------------------
+static	uint8_t		Val(uint32_t n){ return (uint8_t)(n ^ (n >> 8) ^ (n >> 16))	;}
+//-------------------------------------------------
+static	void*	Writer(void* arg)
+{TSpsc*		t = (TSpsc*)arg		;
+ char		pkt[SPSC_PKT]		;
+ char*		dst					;
+ uint32_t	n = 0, seed = 1		;
+ int		len, ix, free		;
+
+ while(n < t->Total){
+   seed = seed*1103515245 + 12345	;
+   len  = 1 + (seed >> 16) % SPSC_PKT	;//   -  
+   if(len > (int)(t->Total - n)) len = (int)(t->Total - n)	;
+   if(seed & 0x80000000){								 //    
+     if((dst = t->Fifo.GetWrBuf(&free)) == 0){ t->SpinWr++	; sched_yield()	; continue	;}
+     if(len > free) len = free	;
+     for(ix=0;ix<len;ix++) dst[ix] = (char)Val(n + ix)	;
+     n += t->Fifo.Commit(len)	;}
+   else{
+     for(ix=0;ix<len;ix++) pkt[ix] = (char)Val(n + ix)	;
+     if(t->Fifo.GetFree() < len){ t->SpinWr++	; sched_yield()	; continue	;}//  NAK:    
+     n += t->Fifo.Write(pkt,len)	;}
+ }
+ return 0	;}
+//-------------------------------------------------
+static	void*	Reader(void* arg)
+{TSpsc*		t = (TSpsc*)arg		;
+ char		buf[256]			;
+ const char* src				;
+ uint32_t	n = 0				;
+ int		len, ix, alt = 0	;
+
+ while(n < t->Total){
+   if(alt++ & 1){
+     if((len = t->Fifo.Read(buf,sizeof(buf))) == 0){ t->SpinRd++	; sched_yield()	; continue	;}
+     src = buf	;}
+   else{
+     if((src = t->Fifo.GetRdBuf(&len)) == 0){ t->SpinRd++	; sched_yield()	; continue	;}}
+   for(ix=0;ix<len;ix++,n++)
+     if((uint8_t)src[ix] != Val(n) && !t->Bad++) t->BadAt = n	;
+   if(src != buf) t->Fifo.Skip(len)	;
+ }
+ return 0	;}
+//-------------------------------------------------
+static	void	Run(int size,uint32_t total)
+{static char	buf[16384]			;
+ TSpsc			t					;
+ pthread_t		wr, rd				;
+ double			sec					;
+
+ t.Fifo.Set(buf,size,0)	; t.Total = total	;
+ t.Bad = t.BadAt = t.SpinWr = t.SpinRd = 0	;
+ sec = HostSec()		;
+ pthread_create(&rd,0,Reader,&t)	; pthread_create(&wr,0,Writer,&t)	;
+ pthread_join(wr,0)		; pthread_join(rd,0)	;
+ sec = HostSec() - sec	;
+ printf("ring %5d: %u MB in %.3f s, %.1f MB/s, spin wr %u rd %u, bad %u",
+		size,total >> 20,sec,total/sec/1048576,t.SpinWr,t.SpinRd,t.Bad)	;
+ if(t.Bad) printf(" (first at %u)",t.BadAt)	;
+ printf("\n")	;
+ CHECK_INT(t.Bad,0)				;
+ CHECK_INT(t.Fifo.GetDrop(),0)	;
+ CHECK_INT(t.Fifo.GetLen(),0)	;}
+//-------------------------------------------------
+//    :    ,  
+static	void	Overflow(void)
+{char	buf[64], src[100], dst[100]	;
+ TFiFo	f(buf,sizeof(buf))			;
+ int	ix							;
+
+ for(ix=0;ix<100;ix++) src[ix] = (char)ix	;
+ CHECK_INT(f.Write(src,40),40)		;
+ CHECK_INT(f.Read(dst,30),30)		;// Tail  30:    
+ CHECK_INT(f.Write(src+40,60),54)	;
+ CHECK_INT(f.GetDrop(),6)			;
+ CHECK(f.Full())					;
+ CHECK_INT(f.Read(dst+30,100),64)	;
+ CHECK(!memcmp(dst,src,94))			;
+ CHECK(f.Empty())					;
+ f.Set(buf,50,0)					;// 50 -> 32
+ CHECK_INT(f.GetFree(),32)			;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{uint32_t	mb = argc > 1 ? atoi(argv[1]) : 64	;
+
+ Overflow()	;
+ Run(1024,mb << 20)	;//  FifoRx  (GSM_LEN_FIFO)
+ Run(4096,mb << 20)	;
+ Run(16384,mb << 20)	;
+ return CheckDone("fifo_spsc")	;}
+//-------------------------------------------------
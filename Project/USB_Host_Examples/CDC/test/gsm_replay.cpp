@@ -0,0 +1,173 @@
+//-------------------------------------------------
+//   GSM    : usart_GSM, FiFo  main.cpp  ,
+//  - TMdmEmu   HostCdc,  -   1 
+// (Clock.OnIRQ).  -  "<> <> []":
+//	boot <>				   
+//	delay <at|cmgr|cmgl|cmgd|cmgs|ath> <>	 
+//	trace					   -  
+//	listen					  (ListenData),    
+//	attach / lost			  /   USB
+//	call <>			RING + CLIP,   ATH
+//	sms <> <>		  (CNMI : +CMTI  +CMT)
+//	cmti <>				 +CMTI  OK  AT+CMGD    
+//	end []			;  -    
+//       (call/sms)   
+//   ;   -    "+CMGS:"  .
+//	gsm_replay [-q] [-t] 
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	"usart_GSM.h"
+#include	"EventQueue.h"
+#include	"Clock.h"
+#include	"TimerWheel.h"
+#include	"Log.h"
+#include	"MdmEmu.h"
+//-------------------------------------------------
+#define		RPL_LINE_MAX		256		//  
+#define		RPL_REQ_MAX			64
+//-------------------------------------------------
+void					InitEvents(void)	;// main.cpp
+void					InitAll(void)		;
+extern	TUsartGSM		UsartGSM[]			;
+extern	USB_OTG_CORE_HANDLE	USB_OTG_Core	;
+//-------------------------------------------------
+struct	TRplLine{
+ uint32_t			Tick						;
+ char				Cmd[12]						;
+ char				Arg[PDU_LEN_TEXT*4]			;
+};
+struct	TRplReq{
+ uint32_t			Tick,Reply					;// Reply 0 -  
+ const char*		Kind						;
+ char				Nmbr[PDU_LEN_NMBR]			;
+};
+//-------------------------------------------------
+static	TRplLine		Line[RPL_LINE_MAX]		;
+static	int				LineCnt					;
+static	TRplReq			Req[RPL_REQ_MAX]		;
+static	int				ReqCnt,RplCnt			;
+static	int				Expect = -1				;
+static	uint32_t		CmtiMax					;// 0 -  
+static	uint32_t		CntOdd					;//   
+static	TMdmEmu			Mdm						;
+//-------------------------------------------------
+static	void	OnSent(void* Ctx,const char* Nmbr,const char* Text,uint32_t Tick)
+{
+ for(int ix=0;ix<ReqCnt;ix++){
+   if(Req[ix].Reply || strcmp(Req[ix].Nmbr,Nmbr)) continue	;
+   Req[ix].Reply = Tick	; RplCnt++	;
+   LogPrintf("%7u reply %s \"%s\": %u ms\n",Tick,Nmbr,Text,Tick - Req[ix].Tick)	;
+   return	;}
+ CntOdd++	;
+ LogPrintf("%7u reply %s \"%s\": no request\n",Tick,Nmbr,Text)	;}
+//-------------------------------------------------
+static	void	AddReq(const char* kind,const char* nmbr)
+{
+ if(ReqCnt >= RPL_REQ_MAX) return	;
+ Req[ReqCnt].Tick = Clock.Now()	; Req[ReqCnt].Reply = 0	; Req[ReqCnt].Kind = kind	;
+ strncpy(Req[ReqCnt].Nmbr,nmbr,PDU_LEN_NMBR-1)	; Req[ReqCnt].Nmbr[PDU_LEN_NMBR-1] = 0	;
+ ReqCnt++	;}
+//-------------------------------------------------
+static	int		Load(const char* name)
+{FILE*	f = fopen(name,"r")	;
+ char	str[sizeof(Line[0].Arg)+40], *p	;
+ int	n	;
+
+ if(!f){ fprintf(stderr,"%s: can't open\n",name)	; return 0	;}
+ for(LineCnt=0;fgets(str,sizeof(str),f) && LineCnt < RPL_LINE_MAX;){
+   if((p = strchr(str,'#')) != 0) *p = 0	;
+   for(p=str;*p;p++) if(*p == '\t') *p = ' '	;
+   for(p=str+strlen(str);p > str && (p[-1] == '\n' || p[-1] == '\r' || p[-1] == ' ' || p[-1] == '\t');) *--p = 0	;
+   if(!*str) continue	;
+   TRplLine*	l = Line + LineCnt	;
+   *l->Arg = 0	; n = 0	;
+   if(sscanf(str,"%u %11s %n",&l->Tick,l->Cmd,&n) < 2){ fprintf(stderr,"%s: bad line \"%s\"\n",name,str)	; fclose(f)	; return 0	;}
+   strncpy(l->Arg,str+n,sizeof(l->Arg)-1)	; l->Arg[sizeof(l->Arg)-1] = 0	;
+   if(LineCnt && l->Tick < Line[LineCnt-1].Tick){ fprintf(stderr,"%s: time goes back \"%s\"\n",name,str)	; fclose(f)	; return 0	;}
+   LineCnt++	;}
+ fclose(f)	;
+ return 1	;}
+//-------------------------------------------------
+//     . 0 - , -1 - 
+static	int		Exec(TRplLine* l,USBH_CDC_Dev* dev)
+{static const char*	Dly[emuDlyCnt] = {"at","cmgr","cmgl","cmgd","cmgs","ath"}	;
+ char	name[PDU_LEN_NMBR]	;
+ int	ix, ms, n = 0		;
+
+ LogPrintf("%7u %s %s\n",Clock.Now(),l->Cmd,l->Arg)	;
+ if(!strcmp(l->Cmd,"boot")) Mdm.Boot = atoi(l->Arg)	;
+ else if(!strcmp(l->Cmd,"delay")){
+   if(sscanf(l->Arg,"%23s %d",name,&ms) != 2) return -1	;
+   for(ix=0;ix<emuDlyCnt && strcmp(name,Dly[ix]);ix++)	;
+   if(ix >= emuDlyCnt) return -1	;
+   Mdm.Delay[ix] = ms	;}
+ else if(!strcmp(l->Cmd,"cmti"  )){ if((CmtiMax = atoi(l->Arg)) == 0) return -1	;}
+ else if(!strcmp(l->Cmd,"trace" )) Mdm.Trace = 1	;
+ else if(!strcmp(l->Cmd,"listen")) dev->Listen = 1	;
+ else if(!strcmp(l->Cmd,"attach")) Mdm.Attach(dev)	;
+ else if(!strcmp(l->Cmd,"lost"  )) Mdm.Lost()		;
+ else if(!strcmp(l->Cmd,"call"  )){ Mdm.Call(l->Arg)	; AddReq("call",l->Arg)	;}
+ else if(!strcmp(l->Cmd,"sms"   )){
+   if(sscanf(l->Arg,"%23s %n",name,&n) < 1 || !l->Arg[n]) return -1	;
+   Mdm.Sms(name,l->Arg + n)	; AddReq("sms",name)	;}
+ else if(!strcmp(l->Cmd,"end")){ if(*l->Arg) Expect = atoi(l->Arg)	; return 0	;}
+ else return -1	;
+ return 1	;}
+//-------------------------------------------------
+static	void	LogWait(void)
+{
+ while(!LogEmpty()) usleep(20)	;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{USBH_CDC_Dev*	dev	;
+ uint32_t		due, lat, sum = 0, min = 0, max = 0	;
+ int			ix, run = 1, quiet = 0, err = 0	;
+
+ for(ix=1;ix < argc && argv[ix][0] == '-';ix++){
+   if(!strcmp(argv[ix],"-q")) quiet = 1	;
+   else if(!strcmp(argv[ix],"-t")) Mdm.Trace = 1	;
+   else break	;}
+ if(ix != argc-1){ fprintf(stderr,"gsm_replay [-q] [-t] script\n")	; return 2	;}
+ if(!Load(argv[ix])) return 2	;
+
+ InitEvents()	;
+ InitAll()		;
+ if(quiet) for(ix=0;ix<LOG_MOD_CNT;ix++) LogLevel[ix] = LOG_LVL_WRN	;
+ if((dev = HostCdcFind(&USB_OTG_Core)) == 0){ fprintf(stderr,"no CDC device bound\n")	; return 2	;}
+ Mdm.OnSent = OnSent	;
+
+ for(ix=0;run > 0;){									 //  main(),   -  
+   Clock.OnIRQ()	;
+   while(ix < LineCnt && Line[ix].Tick <= Clock.Now() && run > 0){
+     if((run = Exec(Line + ix,dev)) < 0) fprintf(stderr,"bad command \"%s %s\"\n",Line[ix].Cmd,Line[ix].Arg)	;
+     ix++	;}
+   if(ix >= LineCnt && run > 0) run = 0	;
+   Mdm.Frame()		;
+   HostCdcFrame()	;
+   EvQueue.Dispatch()	;
+   if(Timers.NextDue(&due)) Clock.Wake(due)	;
+   LogWait()		;
+ }
+ if(run < 0) return 2	;
+
+ LogPrintf("---- %u ms\n",Clock.Now())	;
+ for(ix=0;ix<ReqCnt;ix++){
+   if(!Req[ix].Reply){ LogPrintf("%-4s %-14s at %7u: no reply\n",Req[ix].Kind,Req[ix].Nmbr,Req[ix].Tick)	; continue	;}
+   lat = Req[ix].Reply - Req[ix].Tick	; sum += lat	;
+   if(!min || lat < min) min = lat	;
+   if(lat > max) max = lat		;
+   LogPrintf("%-4s %-14s at %7u: %6u ms\n",Req[ix].Kind,Req[ix].Nmbr,Req[ix].Tick,lat)	;}
+ LogPrintf("replies %d/%d, round trip min %u avg %u max %u ms\n",RplCnt,ReqCnt,min,RplCnt ? sum/RplCnt : 0,max)	;
+ LogPrintf("driver: LatSMS %d ms, max %d ms\n",UsartGSM[0].LatSMS,UsartGSM[0].LatSMSMax)	;
+ LogPrintf("modem: cmd %u, err %u, sms in %u (drop %u), sent %u, odd %u\n",Mdm.CntCmd,Mdm.CntErr,Mdm.CntIn,Mdm.CntInDrop,Mdm.CntSent,CntOdd)	;
+ LogPrintf("sms in: +CMTI -> CMGD OK %u, avg %.0f max %u ms\n",Mdm.CntDel,Mdm.CntDel ? Mdm.DelSum/Mdm.CntDel : 0,Mdm.DelMax)	;
+ LogPrintf("cdc: tx %u, rx %u, rx nak %u, tx drop %u\n",dev->CntTx,dev->CntRx,dev->CntRxNak,dev->CntTxDrop)	;
+ if(Mdm.CntErr || CntOdd) err = 1	;
+ if(CmtiMax && (!Mdm.CntDel || Mdm.DelMax > CmtiMax)){ LogPrintf("FAIL: +CMTI -> CMGD OK %u ms, limit %u ms\n",Mdm.DelMax,CmtiMax)	; err = 1	;}
+ if(Expect >= 0 && RplCnt != Expect){ LogPrintf("FAIL: %d replies, expected %d\n",RplCnt,Expect)	; err = 1	;}
+ LogWait()	;
+ return err	;}
+//-------------------------------------------------
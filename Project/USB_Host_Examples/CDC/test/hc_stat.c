@@ -0,0 +1,106 @@
+//-------------------------------------------------
+//   HC_STAT (usb_hcd.c):     
+// NAK/XACTERR    usb_hcd_int.c,   NOTREADY
+//  ,  .  Submit/Retry/Bytes,  Urb[],
+//  Ev[]    Lat[];   -  UsbhStatLog,
+//    "usb".
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	"HostOtg.h"
+#include	"usb_hcd.h"
+#include	"usbh_hcs.h"
+#include	"usbh_ioreq.h"
+#include	"UsbhStat.h"
+#include	"Log.h"
+#include	"Check.h"
+//-------------------------------------------------
+static	USB_OTG_CORE_HANDLE		Core		;
+static	uint8_t					In, Out		;
+static	uint8_t					Buf[64]		;
+static	URB_STATE				Last		;
+static	uint32_t				CntCb		;
+//-------------------------------------------------
+static	void	OnUrb(void* ctx,uint8_t hc,URB_STATE state){ Last = state	; CntCb++	;}
+//-------------------------------------------------
+static	uint8_t	Open(uint8_t ep)
+{uint8_t	hc = USBH_Alloc_Channel(&Core,ep)	;
+
+ USBH_Open_Channel(&Core,hc,1,HPRT0_PRTSPD_FULL_SPEED,EP_TYPE_BULK,sizeof(Buf))	;
+ HCD_SetURBCallback(&Core,hc,OnUrb,0)	;
+ return hc	;}
+//-------------------------------------------------
+// IN: ,  us  -  cnt 
+static	void	InPkt(uint32_t us,uint32_t cnt)
+{
+ USBH_BulkReceiveData(&Core,Buf,sizeof(Buf),In)	; HostTime(us)	;
+ memset(Buf,0x55,cnt)			; HostHcIrq(In,HC_XFRC,cnt)	;}
+//-------------------------------------------------
+// OUT: nak  NAK, err  XACTERR,  ACK;   - us 
+static	void	OutPkt(uint32_t us,int nak,int err)
+{
+ USBH_BulkSendData(&Core,Buf,sizeof(Buf),Out)	;
+ for(;nak + err > 0;nak ? nak-- : err--){
+   HostTime(us)	; HostHcIrq(Out,nak ? HC_NAK : HC_XACTERR,0)	;
+   CHECK(Last == URB_NOTREADY)	;// XACTERR  3  -  
+   USBH_BulkSendData(&Core,Buf,sizeof(Buf),Out)	;}
+ HostTime(us)	; HostHcIrq(Out,HC_XFRC,0)	;
+ CHECK(Last == URB_DONE)	;}
+//-------------------------------------------------
+int		main(void)
+{static const uint32_t	LatUs[] = {1,3,5,100,1000,40000,100000}	;
+ static const uint8_t	LatBin[] = {0,1,2,6,9,15,15}	;// log2,   -  
+ const HC_STAT*	st	;
+ uint32_t		lat[HC_STAT_LAT_CNT]	;
+ int			ix	;
+
+ LogInit()	;
+ HostOtgReset(&Core)	;
+ USBH_Alloc_Channel(&Core,0x00)	; USBH_Alloc_Channel(&Core,0x80)	;// 0, 1 - 
+ In = Open(0x81)	; Out = Open(0x01)	;
+
+ // IN:    ,   10 
+ st = HCD_GetStat(&Core,In)	; memset(lat,0,sizeof(lat))	;
+ for(ix=0;ix<(int)(sizeof(LatUs)/sizeof(LatUs[0]));ix++){ InPkt(LatUs[ix],10)	; lat[LatBin[ix]]++	;}
+ CHECK_INT(st->Submit,7)	; CHECK_INT(st->Urb[URB_DONE],7)	; CHECK_INT(st->Bytes,70)	;
+ CHECK_INT(st->Ev[HC_XFRC],7)	; CHECK(!memcmp(st->Lat,lat,sizeof(lat)))	;
+ // IN: 5 NAK -    ,  URB   
+ USBH_BulkReceiveData(&Core,Buf,sizeof(Buf),In)	; CntCb = 0	;
+ for(ix=0;ix<5;ix++){ HostTime(50)	; HostHcIrq(In,HC_NAK,0)	; CHECK(HostHc[In].Armed)	;}
+ CHECK_INT(CntCb,0)	;
+ HostTime(50)	; HostHcIrq(In,HC_XFRC,64)	; lat[8]++	;// 300 
+ CHECK_INT(st->Ev[HC_NAK],5)	; CHECK_INT(st->Retry,0)	; CHECK(!memcmp(st->Lat,lat,sizeof(lat)))	;
+ // IN:         
+ InPkt(10,0)	; CHECK_INT(HCD_GetXferCnt(&Core,In),0)	;
+ CHECK_INT(st->Bytes,70 + 64)	; CHECK_INT(st->Urb[URB_DONE],9)	;
+ // IN: XACTERR -  URB_ERROR,    
+ USBH_BulkReceiveData(&Core,Buf,sizeof(Buf),In)	; HostTime(10)	; HostHcIrq(In,HC_XACTERR,0)	;
+ CHECK(Last == URB_ERROR)	; CHECK_INT(st->Urb[URB_ERROR],1)	; CHECK_INT(st->Ev[HC_XACTERR],1)	;
+ CHECK_INT(st->Submit,10)	; lat[3]++	; CHECK(!memcmp(st->Lat,lat,sizeof(lat)))	;// ZLP: 10 
+
+ // OUT:   3  - NAK, NAK, ACK;  -   
+ st = HCD_GetStat(&Core,Out)	; memset(lat,0,sizeof(lat))	;
+ for(ix=0;ix<3;ix++) OutPkt(20,2,0)	;
+ lat[4] += 3	;
+ CHECK_INT(st->Submit,9)	; CHECK_INT(st->Retry,6)	; CHECK_INT(st->Bytes,3*64)	;
+ CHECK_INT(st->Urb[URB_NOTREADY],6)	; CHECK_INT(st->Urb[URB_DONE],3)	; CHECK_INT(st->Ev[HC_NAK],6)	;
+ CHECK(!memcmp(st->Lat,lat,sizeof(lat)))	;
+ // OUT: XACTERR, ACK - ; XACTERR 3   - URB_ERROR
+ OutPkt(3,0,1)	; lat[1]++	;
+ CHECK_INT(st->Submit,11)	; CHECK_INT(st->Retry,7)	; CHECK_INT(st->Bytes,4*64)	;
+ USBH_BulkSendData(&Core,Buf,sizeof(Buf),Out)	;
+ for(ix=0;ix<3;ix++){
+   HostTime(3)	; HostHcIrq(Out,HC_XACTERR,0)	;
+   if(ix < 2){ CHECK(Last == URB_NOTREADY)	; USBH_BulkSendData(&Core,Buf,sizeof(Buf),Out)	;}}
+ CHECK(Last == URB_ERROR)	;
+ CHECK_INT(st->Submit,14)	; CHECK_INT(st->Retry,9)	; CHECK_INT(st->Ev[HC_XACTERR],4)	;
+ CHECK_INT(st->Urb[URB_ERROR],1)	; CHECK_INT(st->Urb[URB_NOTREADY],6)	;// XACTERR   -  
+ CHECK(!memcmp(st->Lat,lat,sizeof(lat)))	;
+
+ UsbhStatLog(&Core)	;
+ while(!LogEmpty()) usleep(1000)	;
+ // ClearStat -  
+ HCD_ClearStat(&Core,Out)	; CHECK_INT(st->Submit,0)	; CHECK_INT(st->Lat[4],0)	;
+ return CheckDone("hc_stat")	;}
+//-------------------------------------------------
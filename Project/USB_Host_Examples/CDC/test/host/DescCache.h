@@ -0,0 +1,16 @@
+//-------------------------------------------------
+//   :   -   
+//-------------------------------------------------
+#ifndef	HOST_DESC_CACHE_H
+#define	HOST_DESC_CACHE_H
+//-------------------------------------------------
+#ifdef __cplusplus
+ extern "C" {
+#endif
+void			DescCacheInit(void)				;
+#ifdef __cplusplus
+ }
+#endif
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,42 @@
+//-------------------------------------------------
+#include	"Clock.h"
+#include	"EventQueue.h"
+#include	"UsbhCore.h"
+#include	"stm32fxxx_it.h"
+#include	"Mark.h"
+#include	"MdmDb.h"
+#include	"DescCache.h"
+//-------------------------------------------------
+//   :  , OTG   .
+//-------------------------------------------------
+GPIO_TypeDef			HostGPIO[2]			;
+USB_OTG_CORE_HANDLE		USB_OTG_Core		;
+void					(*cbOTG_IRQ)(void)	;
+//-------------------------------------------------
+// Clock:  -   OnIRQ() ( 1 , CLK_TICK_MS=1,   ).
+// Hi -  ,  CC1 -     .
+void	TClock::Init(void){ Hi = Due = 0	; Armed = 0	; Busy = 0	;}
+uint32_t	TClock::Now(void){ return Hi	;}
+void	TClock::Wake(uint32_t due)
+{
+ if(!Armed || (int32_t)(due - Due) < 0){ Armed = 1	; Due = due	;}}
+void	TClock::Idle(void){}
+void	TClock::OnIRQ(void)
+{
+ Hi++	;
+ if(Armed && (int32_t)(Hi - Due) >= 0){
+   if(EvQueue.PostOnce(evTick)) Armed = 0	;
+   else Due = Hi + 1	;}
+}
+//-------------------------------------------------
+//   :    (HostCdcAttach)
+EVENT_TYPE	TUsbhCore::OnEvent(TEvent* Event){ return Event->Type	;}
+void		TUsbhCore::OnIRQ(void){}
+void		TUsbhCore::FOnTimer(void){}
+void		TUsbhCore::OnTimer(void){}
+void		TUsbhCore::Init(void){}
+//-------------------------------------------------
+void	MARK_Init(void){}
+void	MdmDbInit(void){}
+void	DescCacheInit(void){}
+//-------------------------------------------------
@@ -0,0 +1,135 @@
+//-------------------------------------------------
+#include	<string.h>
+#include	"usbh_msc_core.h"
+//-------------------------------------------------
+//  CDC  .      ,  USBH_CDC_TxNext:
+//  GetTxBuff  OutEpSize,  CommitTx.  - 
+// USBH_CDC_RxFlush:    (GetRxBuff/CommitRx,   - 
+// )    ListenData.    CommitRx    -
+//      IN    (  
+//   NAK).
+//-------------------------------------------------
+#define		HOST_EP_SIZE		64		// FS bulk
+#define		HOST_PKT_PER_FR		8		//      
+//-------------------------------------------------
+static USBH_CDC_Dev*	HostDev[USBH_CDC_MAX_DEV]	;
+static int				HostDevCnt					;
+//-------------------------------------------------
+int		USBH_CDC_Bind(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE* pdev,const USBH_CDC_Cb_TypeDef* cb,void* ctx)
+{
+ if(!dev || HostDevCnt >= USBH_CDC_MAX_DEV) return 0	;
+ memset(dev,0,sizeof(*dev))	;
+ dev->pdev = pdev	; dev->Cb = cb	; dev->Ctx = ctx	;
+ dev->InEpSize = dev->OutEpSize = HOST_EP_SIZE	; dev->PktPerFr = HOST_PKT_PER_FR	;
+ HostDev[HostDevCnt++] = dev	;
+ return 1	;}
+//-------------------------------------------------
+USBH_CDC_Dev*	HostCdcFind(USB_OTG_CORE_HANDLE* pdev)
+{
+ for(int ix=0;ix<HostDevCnt;ix++) if(HostDev[ix]->pdev == pdev) return HostDev[ix]	;
+ return 0	;}
+//-------------------------------------------------
+//  OUT:  cnt     ,   
+static	void	HostCdcTx(USBH_CDC_Dev* dev,int cnt)
+{const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+ char*	Buf	;
+ int	Len	;
+
+ while(dev->TxDrop && (Buf = cb->GetTxBuff(dev->Ctx,&Len)) != 0 && Len > 0){
+   if((uint32_t)Len > dev->TxDrop) Len = dev->TxDrop	;
+   cb->CommitTx(dev->Ctx,Len)	; dev->TxDrop -= Len	;}
+ dev->TxDrop = 0	;
+
+ for(;cnt > 0 && (Buf = cb->GetTxBuff(dev->Ctx,&Len)) != 0 && Len > 0;cnt--){
+   if(Len > dev->OutEpSize) Len = dev->OutEpSize	;
+   if(dev->OnOut) dev->OnOut(dev->Mdm,Buf,Len)		;
+   cb->CommitTx(dev->Ctx,Len)	; dev->CntTx += Len	;}
+}
+//-------------------------------------------------
+//  IN:  cnt       
+static	void	HostCdcRx(USBH_CDC_Dev* dev,int cnt)
+{const USBH_CDC_Cb_TypeDef*	cb = dev->Cb	;
+ char	Pkt[HOST_EP_SIZE]	;
+ char*	Buf	;
+ int	Len, n, off, got	;
+
+ for(;cnt > 0 && dev->InLen > 0;cnt--){
+   n = dev->InLen < dev->InEpSize ? dev->InLen : dev->InEpSize	;
+   for(off=0;off<n;off++) Pkt[off] = dev->In[(dev->InHead + off) % USBH_CDC_HOST_IN]	;
+   if(dev->Listen || !cb->GetRxBuff){
+     if(cb->ListenData) cb->ListenData(dev->Ctx,Pkt,n)	;
+     off = n	;}
+   else for(off=0;off < n;off += Len){
+     Buf = cb->GetRxBuff(dev->Ctx,&Len)	;
+     if(!Buf || Len <= 0) break			;
+     if(Len > n - off) Len = n - off	;
+     memcpy(Buf,Pkt + off,Len)			;
+     got = cb->CommitRx(dev->Ctx,Len)	;
+     if(got < Len){ off += got	; break	;}//    -   GetS
+   }
+   dev->InHead = (dev->InHead + off) % USBH_CDC_HOST_IN	; dev->InLen -= off	; dev->CntRx += off	;
+   if(off < n){ dev->CntRxNak++	; dev->RxPark = 1	; break	;}//   -   
+ }
+}
+//-------------------------------------------------
+//   -   ,  -  
+USBH_Status		USBH_CDC_StartTx(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+
+ if(!dev) return USBH_FAIL		;
+ if(dev->Active) HostCdcTx(dev,1)	;
+ return USBH_OK	;}
+//-------------------------------------------------
+//       :   
+USBH_Status		USBH_CDC_DropTx(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+ uint32_t		len	;
+
+ if(!dev) return USBH_FAIL		;
+ len = dev->Cb && dev->Cb->GetTxLen ? dev->Cb->GetTxLen(dev->Ctx) : USBH_CDC_DROP_ALL	;
+ if(len > dev->TxDrop) dev->TxDrop = len	;
+ HostCdcTx(dev,0)	;
+ return USBH_OK	;}
+//-------------------------------------------------
+int		USBH_CDC_Pending(USB_OTG_CORE_HANDLE* pdev)
+{(void)pdev	;
+ return 0	;}
+//-------------------------------------------------
+//  IN      ;  -    
+int		USBH_CDC_RxParked(void* Dev)
+{USBH_CDC_Dev*	dev = (USBH_CDC_Dev*)Dev	;
+
+ if(!dev || !dev->RxPark) return 0	;
+ dev->RxPark = 0	;
+ return 1	;}
+//-------------------------------------------------
+void	HostCdcAttach(USBH_CDC_Dev* dev,void* mdm,THostCdcOut out)
+{
+ if(!dev || dev->Active) return	;
+ dev->Mdm = mdm	; dev->OnOut = out	; dev->InHead = dev->InLen = 0	; dev->TxDrop = 0	;
+ dev->Active = 1	;
+ if(dev->Cb->MdmInit) dev->Cb->MdmInit(dev->Ctx)	;}
+//-------------------------------------------------
+void	HostCdcDetach(USBH_CDC_Dev* dev)
+{
+ if(!dev || !dev->Active) return	;
+ dev->Active = 0	; dev->InLen = 0	;
+ if(dev->Cb->MdmLost) dev->Cb->MdmLost(dev->Ctx)	;}
+//-------------------------------------------------
+int		HostCdcIn(USBH_CDC_Dev* dev,const char* data,int len)
+{int	ix	;
+
+ if(!dev || !dev->Active) return 0	;
+ if(len > USBH_CDC_HOST_IN - dev->InLen) len = USBH_CDC_HOST_IN - dev->InLen	;
+ for(ix=0;ix<len;ix++) dev->In[(dev->InHead + dev->InLen + ix) % USBH_CDC_HOST_IN] = data[ix]	;
+ dev->InLen += len	;
+ return len	;}
+//-------------------------------------------------
+void	HostCdcFrame(void)
+{
+ for(int ix=0;ix<HostDevCnt;ix++){
+   if(!HostDev[ix]->Active) continue	;
+   HostCdcTx(HostDev[ix],HostDev[ix]->PktPerFr)	;
+   HostCdcRx(HostDev[ix],HostDev[ix]->PktPerFr)	;}
+}
+//-------------------------------------------------
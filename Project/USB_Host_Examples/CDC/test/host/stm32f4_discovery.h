@@ -0,0 +1,21 @@
+//-------------------------------------------------
+//   : ,   COM  - 
+//-------------------------------------------------
+#ifndef	HOST_STM32F4_DISCOVERY_H
+#define	HOST_STM32F4_DISCOVERY_H
+//-------------------------------------------------
+#include	"stm32f4xx.h"
+//-------------------------------------------------
+typedef	enum{ LED4 = 0, LED3 = 1, LED5 = 2, LED6 = 3	} Led_TypeDef	;
+typedef	enum{ COM1 = 0, COM2 = 1						} COM_TypeDef	;
+typedef	enum{ BUTTON_USER = 0							} Button_TypeDef	;
+//-------------------------------------------------
+static inline void	STM_EVAL_LEDInit  (Led_TypeDef Led){ (void)Led	;}
+static inline void	STM_EVAL_LEDOn    (Led_TypeDef Led){ (void)Led	;}
+static inline void	STM_EVAL_LEDOff   (Led_TypeDef Led){ (void)Led	;}
+static inline void	STM_EVAL_LEDToggle(Led_TypeDef Led){ (void)Led	;}
+static inline uint32_t	STM_EVAL_PBGetState(Button_TypeDef Button){ (void)Button	; return 0	;}// RESET -  
+static inline void	STM_EVAL_COMInit(COM_TypeDef COM,USART_InitTypeDef* Init){ (void)COM	; (void)Init	;}
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
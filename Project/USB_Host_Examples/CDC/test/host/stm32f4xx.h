@@ -0,0 +1,92 @@
+//-------------------------------------------------
+//    (test/):  CMSIS  StdPeriph -  ,  
+// ,  .  -  GCC,  .
+//-------------------------------------------------
+#ifndef	HOST_STM32F4XX_H
+#define	HOST_STM32F4XX_H
+//-------------------------------------------------
+#include	<stdint.h>
+//-------------------------------------------------
+#define		__inline			inline
+#define		__IO				volatile
+//-------------------------------------------------
+#ifdef __cplusplus
+ extern "C" {
+#endif
+//-------------------------------------------------
+typedef	uint32_t	u32	;
+typedef	uint16_t	u16	;
+typedef	uint8_t		u8	;
+typedef	enum{ RESET = 0, SET = !RESET	} FlagStatus, ITStatus	;
+extern	uint32_t			SystemCoreClock	;//  USB (usbh_core.c  .):  HostOtg.c
+extern	volatile uint32_t	HostCyc			;// DWT CYCCNT   (HC_STAT_CYCCNT):  
+//-------------------------------------------------
+// LDREX/STREX:  -    LDREX, STREX -   
+static __thread uint32_t	HostExVal	;
+static inline uint32_t	__LDREXW(volatile uint32_t* p){ return HostExVal = __atomic_load_n(p,__ATOMIC_SEQ_CST)	;}
+static inline uint32_t	__STREXW(uint32_t v,volatile uint32_t* p)
+{uint32_t	e = HostExVal	;
+ return __atomic_compare_exchange_n(p,&e,v,0,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST) ? 0 : 1	;}
+static inline void		__CLREX(void){}
+static inline void		__DMB(void){ __sync_synchronize()	;}
+static inline void		__DSB(void){ __sync_synchronize()	;}
+static inline void		__WFI(void){}
+static inline uint32_t	__get_PRIMASK(void){ return 0	;}
+static inline void		__disable_irq(void){}
+static inline void		__enable_irq(void){}
+//-------------------------------------------------
+typedef	struct{ __IO uint32_t ODR	;} GPIO_TypeDef	;
+extern	GPIO_TypeDef	HostGPIO[2]	;
+#define		GPIOB				(&HostGPIO[0])
+#define		GPIOE				(&HostGPIO[1])
+#define		GPIO_Pin_0			((uint16_t)0x0001)
+#define		GPIO_Pin_1			((uint16_t)0x0002)
+#define		GPIO_Pin_2			((uint16_t)0x0004)
+#define		GPIO_Pin_3			((uint16_t)0x0008)
+#define		GPIO_Pin_4			((uint16_t)0x0010)
+#define		GPIO_Pin_5			((uint16_t)0x0020)
+typedef	enum{ GPIO_Mode_IN = 0, GPIO_Mode_OUT = 1, GPIO_Mode_AF = 2, GPIO_Mode_AN = 3	} GPIOMode_TypeDef	;
+typedef	enum{ GPIO_Speed_2MHz = 0, GPIO_Speed_25MHz, GPIO_Speed_50MHz, GPIO_Speed_100MHz	} GPIOSpeed_TypeDef	;
+static inline void		GPIO_SetBits  (GPIO_TypeDef* g,uint16_t pin){ g->ODR |=  pin	;}
+static inline void		GPIO_ResetBits(GPIO_TypeDef* g,uint16_t pin){ g->ODR &= ~pin	;}
+static inline uint8_t	GPIO_ReadInputDataBit(GPIO_TypeDef* g,uint16_t pin){ return (g->ODR & pin) != 0	;}
+//-------------------------------------------------
+typedef	struct{
+ uint32_t	USART_BaudRate				;
+ uint16_t	USART_WordLength			;
+ uint16_t	USART_StopBits				;
+ uint16_t	USART_Parity				;
+ uint16_t	USART_Mode					;
+ uint16_t	USART_HardwareFlowControl	;
+} USART_InitTypeDef	;
+#define		USART_WordLength_8b				((uint16_t)0x0000)
+#define		USART_StopBits_1				((uint16_t)0x0000)
+#define		USART_Parity_No					((uint16_t)0x0000)
+#define		USART_Mode_Rx					((uint16_t)0x0004)
+#define		USART_Mode_Tx					((uint16_t)0x0008)
+#define		USART_HardwareFlowControl_None	((uint16_t)0x0000)
+//-------------------------------------------------
+// Flash (DescCache.c, MdmDb.c):  -  ,    
+typedef	enum{ FLASH_BUSY = 1, FLASH_ERROR_PGS, FLASH_ERROR_PGP, FLASH_ERROR_PGA,
+			  FLASH_ERROR_WRP, FLASH_ERROR_PROGRAM, FLASH_ERROR_OPERATION, FLASH_COMPLETE	} FLASH_Status	;
+#define		VoltageRange_3			((uint8_t)0x02)
+#define		FLASH_Sector_10			((uint16_t)0x0050)
+#define		FLASH_Sector_11			((uint16_t)0x0058)
+#define		FLASH_FLAG_EOP			((uint32_t)0x00000001)
+#define		FLASH_FLAG_OPERR		((uint32_t)0x00000002)
+#define		FLASH_FLAG_WRPERR		((uint32_t)0x00000010)
+#define		FLASH_FLAG_PGAERR		((uint32_t)0x00000020)
+#define		FLASH_FLAG_PGPERR		((uint32_t)0x00000040)
+#define		FLASH_FLAG_PGSERR		((uint32_t)0x00000080)
+void			FLASH_Unlock(void)	;
+void			FLASH_Lock(void)	;
+void			FLASH_ClearFlag(uint32_t flag)	;
+FLASH_Status	FLASH_EraseSector(uint32_t sector,uint8_t range)	;
+FLASH_Status	FLASH_ProgramWord(uint32_t addr,uint32_t data)		;
+//-------------------------------------------------
+#ifdef __cplusplus
+ }
+#endif
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
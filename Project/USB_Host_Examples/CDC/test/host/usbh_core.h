@@ -0,0 +1,24 @@
+//-------------------------------------------------
+//   :    -  ,   
+//-------------------------------------------------
+#ifndef	HOST_USBH_CORE_H
+#define	HOST_USBH_CORE_H
+//-------------------------------------------------
+#include	"stm32f4xx.h"
+//-------------------------------------------------
+typedef enum {
+  USBH_OK   = 0,
+  USBH_BUSY,
+  USBH_FAIL,
+  USBH_NOT_SUPPORTED,
+  USBH_UNRECOVERED_ERROR,
+  USBH_ERROR_SPEED_UNKNOWN,
+  USBH_APPLY_DEINIT
+}USBH_Status;
+//-------------------------------------------------
+typedef	struct	USB_OTG_handle{
+ uint8_t		Id					;//  OTG: 0 - FS, 1 - HS
+} USB_OTG_CORE_HANDLE	;
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
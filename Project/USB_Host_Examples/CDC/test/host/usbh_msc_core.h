@@ -0,0 +1,77 @@
+//-------------------------------------------------
+//   :  CDC  OTG.      
+//  ,   Class/CDC/inc/usbh_msc_core.h;   HostCdc.cpp -
+//    (1   )  OUT  
+// ,     IN   .
+//-------------------------------------------------
+#ifndef	HOST_USBH_MSC_CORE_H
+#define	HOST_USBH_MSC_CORE_H
+//-------------------------------------------------
+#include	"usbh_core.h"
+//-------------------------------------------------
+#define		USBH_CDC_MAX_DEV	2		//     OTG (FS, HS),   
+#define		USBH_CDC_IN_BUFF	512		//  HS;  - 
+#define		USBH_CDC_DROP_ALL	0xFFFFFFFF	// TxDrop:  
+#define		USBH_CDC_HOST_IN	4096	//  ,      IN
+//-------------------------------------------------
+#ifdef __cplusplus
+ extern "C" {
+#endif
+//-------------------------------------------------
+/*   : Ctx -   (TUsartGSM) */
+typedef struct _USBH_CDC_Cb
+{
+  int			(*ListenData)(void* Ctx,void* Data,int Len)	;//   ()
+  char*			(*GetRxBuff) (void* Ctx,int* Len)			;//  ,  
+  int			(*CommitRx)  (void* Ctx,int Len)			;//     Len ,   
+  void			(*MdmInit)   (void* Ctx)					;//   
+  char*			(*GetTxBuff) (void* Ctx,int* Len)			;//   :  
+  void			(*CommitTx)  (void* Ctx,int Len)			;//    Len 
+  void			(*MdmLost)   (void* Ctx)					;//     (  )
+  int			(*GetTxLen)  (void* Ctx)					;//     ;  - DropTx  
+}
+USBH_CDC_Cb_TypeDef;
+//-------------------------------------------------
+typedef	void	(*THostCdcOut)(void* Mdm,const char* Data,int Len)	;//  OUT   
+//-------------------------------------------------
+typedef struct _USBH_CDC_Dev
+{
+  USB_OTG_CORE_HANDLE*	pdev				;
+  uint8_t				Active				;//   
+  uint8_t				Listen				;//   (ListenData),    
+  uint16_t				InEpSize			;
+  uint16_t				OutEpSize			;
+  uint16_t				PktPerFr			;//      
+  uint32_t				TxDrop				;//      
+  uint32_t				CntTxDrop			;//  
+  uint32_t				CntTx,CntRx			;//    OUT / IN
+  uint32_t				CntRxNak			;// ,     
+  uint8_t				RxPark				;//     ,  USBH_CDC_RxParked
+  char					In[USBH_CDC_HOST_IN]	;//   IN   
+  int					InHead,InLen		;
+  void*					Mdm					;//  
+  THostCdcOut			OnOut				;
+  const USBH_CDC_Cb_TypeDef*	Cb			;
+  void*					Ctx					;
+}
+USBH_CDC_Dev;
+//-------------------------------------------------
+extern		int				USBH_CDC_Bind			(USBH_CDC_Dev* dev,USB_OTG_CORE_HANDLE* pdev,const USBH_CDC_Cb_TypeDef* cb,void* ctx)	;
+extern		USBH_Status		USBH_CDC_StartTx		(void* dev)	;
+extern		USBH_Status		USBH_CDC_DropTx			(void* dev)	;
+extern		int				USBH_CDC_Pending		(USB_OTG_CORE_HANDLE* pdev)	;
+extern		int				USBH_CDC_RxParked		(void* dev)	;
+//-------------------------------------------------
+//   ()    -   
+USBH_CDC_Dev*	HostCdcFind  (USB_OTG_CORE_HANDLE* pdev)	;//   , 0 - 
+void			HostCdcAttach(USBH_CDC_Dev* dev,void* mdm,THostCdcOut out)	;//   : MdmInit
+void			HostCdcDetach(USBH_CDC_Dev* dev)			;// : MdmLost
+int				HostCdcIn    (USBH_CDC_Dev* dev,const char* data,int len)	;//  ,  
+void			HostCdcFrame (void)							;//  1    
+//-------------------------------------------------
+#ifdef __cplusplus
+ }
+#endif
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,12 @@
+//-------------------------------------------------
+//   :       ;
+// stdio -    usbh_usr.h (main.cpp  FILE )
+//-------------------------------------------------
+#ifndef	HOST_USBH_USR_H
+#define	HOST_USBH_USR_H
+//-------------------------------------------------
+#include	<stdio.h>
+#include	"usbh_core.h"
+//-------------------------------------------------
+#endif
+//-------------------------------------------------
@@ -0,0 +1,80 @@
+//-------------------------------------------------
+//   LOG_D  :  (vsnprintf   Log.c), 
+//   (LogLevel[]   )   
+// (  LOG_LEVEL). LOG_CT    , 
+//   -   LOG_D   LOG_LEVEL .
+//   - ,    ;  
+//  ()  .  -    TSC  ,  
+//  - make logsize.
+//	log_cost []
+//-------------------------------------------------
+#include	<stdlib.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	"Log.h"
+#include	"Check.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include	<x86intrin.h>
+#define		COST_TSC()			__rdtsc()
+#else
+#define		COST_TSC()			0ULL
+#endif
+//-------------------------------------------------
+#define		COST_BATCH			64				//   : 64 x ~20  < LOG_SIZE
+//-------------------------------------------------
+static	volatile uint32_t	Lines				;//    
+static	uint32_t			Calls = 200000		;
+//-------------------------------------------------
+static	void	Out(const char* buf,uint32_t len)
+{uint32_t	ix	;
+
+ for(ix=0;ix<len;ix++) if(buf[ix] == '\n') Lines++	;}
+//-------------------------------------------------
+static	void	Drain(void)
+{
+ while(!LogEmpty()) usleep(50)	;}
+//-------------------------------------------------
+static	void	__attribute__((noinline))	CallOn(uint32_t ix)
+{
+ LOG_D(LOG_GSM,"cost %u\n",ix)	;}
+//-------------------------------------------------
+#undef		LOG_LEVEL
+#define		LOG_LEVEL			LOG_LVL_INF
+static	void	__attribute__((noinline))	CallOut(uint32_t ix)
+{
+ LOG_D(LOG_GSM,"cost %u\n",ix)	;}
+//-------------------------------------------------
+//  cnt  fn   batch,     
+static	void	Cost(const char* name,void (*fn)(uint32_t),uint32_t cnt,uint32_t batch)
+{double		t, sec = 0	;
+ uint64_t	c, cyc = 0	;
+ uint32_t	ix, n	;
+
+ for(ix=0;ix<cnt;ix+=batch){
+   t = HostSec()	; c = COST_TSC()	;
+   for(n=ix;n<ix+batch;n++) fn(n)	;
+   cyc += COST_TSC() - c	; sec += HostSec() - t	;
+   if(batch < cnt) Drain()	;}
+ printf("%-12s %8.1f ns %8.1f tsc\n",name,sec*1e9/cnt,(double)cyc/cnt)	;}
+//-------------------------------------------------
+int		main(int argc,char* argv[])
+{
+ if(argc > 1) Calls = atoi(argv[1])	;
+ if(Calls < COST_BATCH) Calls = COST_BATCH	;
+ Calls -= Calls % COST_BATCH	;
+ LogHostOut = Out	;
+ LogInit()	;
+
+ Cost("enabled",CallOn,Calls,COST_BATCH)	;
+ Drain()	;
+ CHECK_INT(Lines,Calls)	;
+ CHECK_INT(LogStat.CntLost,0)	;
+
+ LogLevel[LOG_GSM] = LOG_LVL_INF	;
+ Cost("runtime off",CallOn,Calls,Calls)	;
+ Cost("compiled out",CallOut,Calls,Calls)	;
+ LogLevel[LOG_GSM] = LOG_LVL_DBG	;
+ Drain()	;
+ CHECK_INT(Lines,Calls)	;//   
+ return CheckDone("log_cost")	;}
+//-------------------------------------------------
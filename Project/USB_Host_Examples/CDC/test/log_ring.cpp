@@ -0,0 +1,146 @@
+//-------------------------------------------------
+//   (Log.c)  :  "DMA" ,  ,
+//  .   -  LOG_DROP_NEWEST  LOG_DROP_OLDEST.
+//        , 
+//   CntDrop/CntLost   .     
+//  (  ,    ),  
+// -   .
+//	log_ring [] [  ]
+//-------------------------------------------------
+#include	<stdlib.h>
+#include	<string.h>
+#include	<pthread.h>
+#include	<sched.h>
+#include	<unistd.h>
+#include	"Log.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		RING_THR_MAX		8
+#define		RING_CAP			(4 << 20)
+#define		RING_REC			100				//   , 
+//-------------------------------------------------
+static	char				Cap[RING_CAP]		;//  "  UART"
+static	uint32_t			CapLen				;
+static	volatile int		Hold				;//  
+static	volatile int		Entered				;//    ,   
+static	volatile int		Slow				;//   
+static	int					ThrCnt = 4			;
+static	uint32_t			PerThr = 5000		;
+//-------------------------------------------------
+static	void	Out(const char* buf,uint32_t len)
+{
+ Entered = 1	;
+ while(Hold) usleep(50)	;
+ if(Slow) usleep(Slow)	;
+ if(CapLen + len <= RING_CAP){ memcpy(Cap + CapLen,buf,len)	; CapLen += len	;}
+ else CheckFail++	;}
+//-------------------------------------------------
+static	void	Drain(void)
+{
+ while(!LogEmpty()) usleep(100)	;}
+//-------------------------------------------------
+//   seq  len: "tag seq"    '\n'
+static	int		Rec(char* buf,int len,char tag,uint32_t seq)
+{int	n = snprintf(buf,len,"%c%u ",tag,seq)	;
+
+ memset(buf + n,'a' + seq % 26,len - n - 1)	;
+ buf[len - 1] = '\n'	;
+ return len	;}
+//-------------------------------------------------
+static	void	Expect(char* exp,uint32_t* len,char tag,uint32_t seq,int size)
+{
+ *len += Rec(exp + *len,size,tag,seq)	;}
+//-------------------------------------------------
+//  A0   ,   cnt   size . NEWEST 
+// ,  ; OLDEST -  (A0    )
+static	void	TestHeld(int cnt,int size,int fit)
+{char		rec[LOG_LINE]	;
+ static char	exp[LOG_SIZE*2]	;
+ uint32_t	expLen = 0	;
+ int		ix, first	;
+
+ Drain()	; CapLen = 0	; memset(&LogStat,0,sizeof(LogStat))	;
+ Hold = 1	; Entered = 0	;
+ CHECK_INT(LogWrite(rec,Rec(rec,size,'A',0)),size)	;
+ while(!Entered) usleep(50)	;
+ for(ix=1;ix<=cnt;ix++) LogWrite(rec,Rec(rec,size,'B',ix))	;
+ Hold = 0	; Drain()	;
+
+ Expect(exp,&expLen,'A',0,size)	;
+ first = LOG_DROP == LOG_DROP_OLDEST ? cnt - fit + 1 : 1	;
+ for(ix=first;ix<first+fit;ix++) Expect(exp,&expLen,'B',ix,size)	;
+ printf("held %d x %d: got %u bytes, drop %u, lost %u\n",cnt,size,CapLen,LogStat.CntDrop,LogStat.CntLost)	;
+ CHECK_INT(CapLen,expLen)	;
+ CHECK(!memcmp(Cap,exp,expLen))	;
+ CHECK_INT(LogStat.CntLost,cnt - fit)	;
+ CHECK_INT(LogStat.CntDrop,(cnt - fit)*size)	;}
+//-------------------------------------------------
+static	void*	Writer(void* arg)
+{int		thr = (int)(intptr_t)arg	;
+ char		rec[LOG_LINE]	;
+ uint32_t	seq	;
+
+ for(seq=1;seq<=PerThr;seq++){
+   LogWrite(rec,Rec(rec,16 + (seq*7 + thr*13) % 120,'0' + thr,seq))	;
+   if(!(seq & 15)) sched_yield()	;}
+ return 0	;}
+//-------------------------------------------------
+static	uint32_t	Bytes(int thr)
+{uint32_t	seq, sum = 0	;
+
+ for(seq=1;seq<=PerThr;seq++) sum += 16 + (seq*7 + thr*13) % 120	;
+ return sum	;}
+//-------------------------------------------------
+//   -    ,  
+static	void	TestWriters(void)
+{pthread_t	thr[RING_THR_MAX]	;
+ uint32_t	last[RING_THR_MAX] = {0}, got[RING_THR_MAX] = {0}	;
+ uint32_t	total = 0, recs = 0, bad = 0, pos, end, seq	;
+ char*		p	;
+ int		ix, w, len	;
+
+ Drain()	; CapLen = 0	; memset(&LogStat,0,sizeof(LogStat))	;
+ Slow = 300	;
+ for(ix=0;ix<ThrCnt;ix++) pthread_create(thr + ix,0,Writer,(void*)(intptr_t)ix)	;
+ for(ix=0;ix<ThrCnt;ix++) pthread_join(thr[ix],0)	;
+ Drain()	; Slow = 0	;
+
+ for(pos=0;pos<CapLen;pos=end+1){
+   p = (char*)memchr(Cap + pos,'\n',CapLen - pos)	;
+   if(!p){ bad++	; break	;}
+   end = p - Cap	; len = end - pos + 1	; recs++	;
+   w = Cap[pos] - '0'	; seq = strtoul(Cap + pos + 1,&p,10)	;
+   if(w < 0 || w >= ThrCnt || seq <= last[w] || seq > PerThr || *p != ' '
+	  || len != 16 + (int)((seq*7 + w*13) % 120)){ bad++	; continue	;}
+   for(p++;p<Cap+end && *p == 'a' + (char)(seq % 26);p++)	;
+   if(p != Cap + end){ bad++	; continue	;}
+   last[w] = seq	; got[w]++	;}
+
+ for(ix=0;ix<ThrCnt;ix++) total += Bytes(ix)	;
+ printf("%d writers x %u: got %u records %u bytes, lost %u, drop %u, max used %u, bad %u\n",
+		ThrCnt,PerThr,recs,CapLen,LogStat.CntLost,LogStat.CntDrop,LogStat.MaxUsed,bad)	;
+ CHECK_INT(bad,0)	;
+ CHECK_INT(recs + LogStat.CntLost,ThrCnt*PerThr)	;
+ CHECK_INT(CapLen + LogStat.CntDrop,total)	;
+ CHECK(LogStat.CntLost > 0)	;//  
+ CHECK(LogStat.MaxUsed <= LOG_SIZE)	;
+ for(ix=0;ix<ThrCnt;ix++) CHECK(got[ix] > 0)	;}
+//-------------------------------------------------
+int		main(int argc,char* argv[])
+{char	rec[RING_REC]	;
+ int	ix	;
+
+ if(argc > 1) ThrCnt = atoi(argv[1])	;
+ if(argc > 2) PerThr = atoi(argv[2])	;
+ if(ThrCnt < 1 || ThrCnt > RING_THR_MAX) ThrCnt = 4	;
+ LogHostOut = Out	;
+ LogInit()	;
+
+ //    -      
+ for(ix=0;ix<13;ix++) LogWrite(rec,Rec(rec,RING_REC,'F',ix))	;
+ TestHeld(40,RING_REC,LOG_SIZE/RING_REC - 1)	;
+ //  :  OLDEST  LogRec  
+ TestHeld(100,10,LOG_DROP == LOG_DROP_OLDEST ? LOG_RECS - 1 : 100)	;
+ TestWriters()	;
+ return CheckDone(LOG_DROP == LOG_DROP_OLDEST ? "log_ring oldest" : "log_ring newest")	;}
+//-------------------------------------------------
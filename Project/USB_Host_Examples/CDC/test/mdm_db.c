@@ -0,0 +1,198 @@
+//-------------------------------------------------
+//   (MdmDb.c): MdmDbCheck    (CRC, ,
+//   , ,  ), MdmDbFind    N
+//     , MdmDbUpdate  MODEMS.BIN  flash
+//  MdmDbInit    "".    (MdmDbRom.c,
+// CRC  zlib  tools/mdmdb.py)    .
+//  11 -     MDMDB_FLASH_ADDR,  -   .
+//	mdm_db
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<string.h>
+#include	<sys/mman.h>
+#include	"Check.h"
+// Db, DbRec - ; MdmDbInit/MdmDbUpdate -  flash  FatFS 
+#define		MDMDB_HOST_FLASH
+#include	"MdmDb.c"
+//-------------------------------------------------
+#define		MDB_N			300
+#define		MDB_SIZE(n)		(sizeof(TMdmDbHdr) + (n)*sizeof(TMdmRec))
+//-------------------------------------------------
+static	uint8_t*			Flash					;
+static	uint32_t			FlashBad				;//  0->1   
+static	uint32_t			CntErase, CntWord		;
+static	int					FailAt = -1				;//     
+static	uint32_t			Img[MDB_SIZE(MDB_N)/4 + 1]	;
+static	const uint8_t*		File					;// "0:MODEMS.BIN", 0 - 
+static	uint32_t			FileLen					;
+//-------------------------------------------------
+FLASH_Status	FLASH_ProgramWord(uint32_t addr,uint32_t data)
+{uint32_t*	w = (uint32_t*)(uintptr_t)addr	;
+
+ if((addr & 3) || addr < MDMDB_FLASH_ADDR || addr + 4 > MDMDB_FLASH_ADDR + MDMDB_FLASH_SIZE){ FlashBad++	; return FLASH_ERROR_PGA	;}
+ if(FailAt >= 0 && CntWord == (uint32_t)FailAt) return FLASH_ERROR_PROGRAM	;
+ CntWord++	;
+ if((*w & data) != data) FlashBad++	;
+ *w &= data	;
+ return FLASH_COMPLETE	;}
+//-------------------------------------------------
+FLASH_Status	FLASH_EraseSector(uint32_t sector,uint8_t range)
+{
+ CHECK_INT(sector,FLASH_Sector_11)	;
+ memset(Flash,0xFF,MDMDB_FLASH_SIZE)	; CntErase++	;
+ return FLASH_COMPLETE	;}
+//-------------------------------------------------
+void	FLASH_Unlock(void){}
+void	FLASH_Lock(void){}
+void	FLASH_ClearFlag(uint32_t flag){}
+//-------------------------------------------------
+FRESULT	f_open(FIL* fp,const XCHAR* path,BYTE mode)
+{
+ CHECK(!strcmp(path,MDMDB_FILE))	;
+ if(!File) return FR_NO_FILE	;
+ memset(fp,0,sizeof(*fp))	; fp->fsize = FileLen	;
+ return FR_OK	;}
+//-------------------------------------------------
+FRESULT	f_read(FIL* fp,void* buf,UINT len,UINT* rd)
+{
+ if(len > fp->fsize - fp->fptr) len = fp->fsize - fp->fptr	;
+ memcpy(buf,File + fp->fptr,len)	; fp->fptr += len	; *rd = len	;
+ return FR_OK	;}
+//-------------------------------------------------
+FRESULT	f_lseek(FIL* fp,DWORD pos)
+{
+ fp->fptr = pos < fp->fsize ? pos : fp->fsize	;
+ return FR_OK	;}
+//-------------------------------------------------
+FRESULT	f_close(FIL* fp){ return FR_OK	;}
+//-------------------------------------------------
+//    (Vid,Pid) = (0x1000 + 3*ix, 7*ix) -   
+static	uint16_t	Vid(int ix){ return 0x1000 + 3*ix	;}
+static	uint16_t	Pid(int ix){ return 7*ix	;}
+//-------------------------------------------------
+static	void	Seal(uint32_t* img)
+{TMdmDbHdr*	hdr = (TMdmDbHdr*)img	;
+
+ hdr->Crc = MdmDbCrc(0,hdr + 1,hdr->Cnt*sizeof(TMdmRec))	;}
+//-------------------------------------------------
+static	uint32_t	Build(uint32_t* img,int cnt)
+{TMdmDbHdr*	hdr = (TMdmDbHdr*)img	;
+ TMdmRec*	rec = (TMdmRec*)(hdr + 1)	;
+ int		ix	;
+
+ memset(img,0,MDB_SIZE(cnt))	;
+ hdr->Sign = MDMDB_SIGN	; hdr->Ver = MDMDB_VER	; hdr->Cnt = cnt	;
+ for(ix=0;ix<cnt;ix++,rec++){
+   rec->Vid = Vid(ix)	; rec->Pid = Pid(ix)	; rec->Class = 0xFF	; rec->Proto = ix	;
+   rec->Intf = -1	; rec->MsgLen = ix % (MDMDB_MSG_MAX + 1)	; rec->Delay = 3000	;
+   memset(rec->Msg,ix,rec->MsgLen)	;}
+ Seal(img)	;
+ return MDB_SIZE(cnt)	;}
+//-------------------------------------------------
+static	void	TestCheck(void)
+{TMdmDbHdr*	hdr = (TMdmDbHdr*)Img	;
+ TMdmRec*	rec = (TMdmRec*)(hdr + 1), tmp	;
+ uint32_t	size	;
+
+ CHECK_INT(MdmDbCheck(MdmDbRom,MdmDbRomSize),2)	;
+ size = Build(Img,MDB_N)	;
+ CHECK_INT(MdmDbCheck(Img,size),MDB_N)		;
+ CHECK_INT(MdmDbCheck(Img,size + 100),MDB_N)	;//    
+ CHECK_INT(MdmDbCheck(0,size),-1)			;
+ // CRC:     Crc
+ rec[MDB_N/2].Msg[0] ^= 1	; CHECK_INT(MdmDbCheck(Img,size),-1)	; rec[MDB_N/2].Msg[0] ^= 1	;
+ hdr->Crc ^= 0x80000000		; CHECK_INT(MdmDbCheck(Img,size),-1)	; hdr->Crc ^= 0x80000000	;
+ CHECK_INT(MdmDbCheck(Img,size),MDB_N)		;
+ // :  ,  ,  
+ CHECK_INT(MdmDbCheck(Img,size - sizeof(TMdmRec)),-1)	;
+ CHECK_INT(MdmDbCheck(Img,size - 1),-1)					;
+ CHECK_INT(MdmDbCheck(Img,sizeof(TMdmDbHdr) - 1),-1)		;
+ //      - CRC   
+ tmp = rec[10]	; rec[10] = rec[11]	; rec[11] = tmp	; Seal(Img)	;
+ CHECK_INT(MdmDbCheck(Img,size),-1)	;
+ rec[11] = rec[10]	; Seal(Img)	;
+ CHECK_INT(MdmDbCheck(Img,size),-1)	;
+ size = Build(Img,MDB_N)	;
+ rec[0].MsgLen = MDMDB_MSG_MAX + 1	; Seal(Img)	;
+ CHECK_INT(MdmDbCheck(Img,size),-1)	;
+ size = Build(Img,MDB_N)	;
+ // 
+ hdr->Sign ^= 1	; CHECK_INT(MdmDbCheck(Img,size),-1)	; hdr->Sign ^= 1	;
+ hdr->Ver++		; CHECK_INT(MdmDbCheck(Img,size),-1)	; hdr->Ver--	;
+ hdr->Cnt = MDMDB_CNT_MAX + 1	; CHECK_INT(MdmDbCheck(Img,MDB_SIZE(MDMDB_CNT_MAX + 1)),-1)	;
+ hdr->Cnt = MDB_N	;
+ CHECK_INT(MdmDbCheck(Img,size),MDB_N)	;
+ //   
+ size = Build(Img,0)	;
+ CHECK_INT(MdmDbCheck(Img,size),0)	;}
+//-------------------------------------------------
+//   ,     - 
+static	void	TestFind(int cnt)
+{const TMdmRec*	rec	;
+ uint32_t		size = Build(Img,cnt), bad = 0	;
+ int			ix	;
+
+ CHECK(MdmDbSet(Img,size))	;
+ for(ix=0;ix<cnt;ix++){
+   rec = MdmDbFind(Vid(ix),Pid(ix))	;
+   if(rec != (const TMdmRec*)((TMdmDbHdr*)Img + 1) + ix || rec->Proto != (uint8_t)ix) bad++	;
+   if(MdmDbFind(Vid(ix),Pid(ix) + 1) || MdmDbFind(Vid(ix) + 1,Pid(ix)) || MdmDbFind(Vid(ix),Pid(ix) - 1)) bad++	;}
+ if(MdmDbFind(0,0) || MdmDbFind(0xFFFF,0xFFFF) || MdmDbFind(Vid(cnt),Pid(cnt))) bad++	;
+ printf("find %d records: bad %u\n",cnt,bad)	;
+ CHECK_INT(bad,0)	;
+ //     
+ ((TMdmDbHdr*)Img)->Crc ^= 1	;
+ CHECK(!MdmDbSet(Img,size))	; CHECK(Db == (const TMdmDbHdr*)Img)	;}
+//-------------------------------------------------
+// MODEMS.BIN -> flash -> "" ->   flash
+static	void	TestUpdate(void)
+{static uint8_t	file[MDB_SIZE(MDB_N)]	;
+ uint32_t		size	;
+
+ memset(Flash,0xA5,MDMDB_FLASH_SIZE)	;//   11 - 
+ Db = 0	; MdmDbInit()	;
+ CHECK(Db == (const TMdmDbHdr*)MdmDbRom)	; CHECK(MdmDbFind(0x12D1,0x155B) != 0)	;
+ File = 0	; CHECK_INT(MdmDbUpdate(),0)	; CHECK_INT(CntErase,0)	;
+
+ size = Build(Img,MDB_N)	; memcpy(file,Img,size)	; File = file	; FileLen = size	;
+ CHECK_INT(MdmDbUpdate(),1)	; CHECK_INT(CntErase,1)	;
+ CHECK(!memcmp(Flash,file,size))	;
+ CHECK(Db == (const TMdmDbHdr*)MDMDB_FLASH_ADDR)	;
+ CHECK(MdmDbFind(Vid(7),Pid(7)) == (const TMdmRec*)(Flash + sizeof(TMdmDbHdr)) + 7)	;
+ CHECK(!MdmDbFind(0x12D1,0x155B))	;//   
+ Db = 0	; MdmDbInit()	;
+ CHECK(Db == (const TMdmDbHdr*)MDMDB_FLASH_ADDR)	;
+ //    - flash  
+ CHECK_INT(MdmDbUpdate(),0)	; CHECK_INT(CntErase,1)	;
+
+ //        
+ size = Build(Img,MDB_N - 1)	; memcpy(file,Img,size)	; FileLen = size	;
+ file[size - 1] ^= 1	;
+ CHECK_INT(MdmDbUpdate(),0)	;
+ file[size - 1] ^= 1	; FileLen = size - 1	;
+ CHECK_INT(MdmDbUpdate(),0)	;
+ CHECK_INT(CntErase,1)	; CHECK(Db == (const TMdmDbHdr*)MDMDB_FLASH_ADDR)	;
+ CHECK_INT(MdmDbCheck(Flash,MDMDB_FLASH_SIZE),MDB_N)	;
+
+ //   :    -   ,  
+ //  
+ FileLen = size	; CntWord = 0	; FailAt = 100	;
+ CHECK_INT(MdmDbUpdate(),0)	; CHECK_INT(CntErase,2)	;
+ CHECK(Db == (const TMdmDbHdr*)MdmDbRom)	;
+ CHECK_INT(((TMdmDbHdr*)Flash)->Sign,0xFFFFFFFF)	;
+ Db = 0	; MdmDbInit()	; CHECK(Db == (const TMdmDbHdr*)MdmDbRom)	;
+ FailAt = -1	;
+ CHECK_INT(MdmDbUpdate(),1)	; CHECK_INT(CntErase,3)	;
+ CHECK_INT(MdmDbCheck(Flash,MDMDB_FLASH_SIZE),MDB_N - 1)	;
+ printf("update: erase %u, words %u\n",CntErase,CntWord)	;}
+//-------------------------------------------------
+int		main(void)
+{
+ Flash = mmap((void*)MDMDB_FLASH_ADDR,MDMDB_FLASH_SIZE,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,-1,0)	;
+ if(Flash != (uint8_t*)MDMDB_FLASH_ADDR){ printf("no memory at 0x%08X\n",MDMDB_FLASH_ADDR)	; return 2	;}
+ TestCheck()	;
+ TestFind(0)	; TestFind(1)	; TestFind(2)	; TestFind(3)	; TestFind(MDB_N)	;
+ TestUpdate()	;
+ CHECK_INT(FlashBad,0)	;
+ return CheckDone("mdm_db")	;}
+//-------------------------------------------------
@@ -0,0 +1,190 @@
+//-------------------------------------------------
+//       (TSmsSched):  TUsartGSM,
+//     OTG   TMdmEmu;   ,   
+// (FS  HS).    -        ,
+//    . :
+//	 		-    
+//			-    -:      
+//					  ,   ,      
+//	 NoNet	-   SCHED_FAIL_MAX ,     
+//	   USB -    ,      
+//     -  ,  -    "+CMGS:".
+//	mdm_multi []
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	"usart_GSM.h"
+#include	"EventQueue.h"
+#include	"Clock.h"
+#include	"TimerWheel.h"
+#include	"Log.h"
+#include	"MdmEmu.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		MULTI_MDM_MAX		(USBH_CDC_MAX_DEV < SCHED_MDM_MAX ? USBH_CDC_MAX_DEV : SCHED_MDM_MAX)
+#define		MULTI_BURSTS		4		//    
+#define		MULTI_REQ_MAX		(4*MULTI_BURSTS*MULTI_MDM_MAX)
+//-------------------------------------------------
+int			InfoForSMS(char* Buf,int SizeBuf,int Pos)	;// main.cpp
+//-------------------------------------------------
+struct	TMultiReq{
+ char				Nmbr[PDU_LEN_NMBR]			;
+ uint32_t			Tick						;
+ int				Reply						;// 
+};
+//-------------------------------------------------
+static	int					Cnt = 2							;
+static	uint32_t			Gap								;//   :     
+static	USB_OTG_CORE_HANDLE	Core[MULTI_MDM_MAX]				;
+static	TUsartGSM			Gsm[MULTI_MDM_MAX]				;
+static	TMdmEmu				Emu[MULTI_MDM_MAX]				;
+static	TSmsSched			Sched							;
+static	uint32_t			Sent[MULTI_MDM_MAX]				;//   
+static	TMultiReq			Req[MULTI_REQ_MAX]				;
+static	int					ReqCnt							;
+static	uint32_t			CntOdd, LatMax, LatSum			;
+//-------------------------------------------------
+static	uint32_t	GetPsw(void){ return 20	;}
+//-------------------------------------------------
+static	void	OnGsm(TEvent* ev)
+{
+ for(int ix=0;ix<Cnt;ix++) Gsm[ix].OnEvent(ev)	;}
+//-------------------------------------------------
+static	void	OnTick(TEvent* ev){ Timers.Run(Clock.Now())	;}
+//-------------------------------------------------
+static	void	OnSent(void* Ctx,const char* Nmbr,const char* Text,uint32_t Tick)
+{int	id = (int)(intptr_t)Ctx	;
+
+ Sent[id]++	;
+ for(int ix=0;ix<ReqCnt;ix++){
+   if(strcmp(Req[ix].Nmbr,Nmbr)) continue	;
+   if(!Req[ix].Reply++){ LatSum += Tick - Req[ix].Tick	; if(Tick - Req[ix].Tick > LatMax) LatMax = Tick - Req[ix].Tick	;}
+   return	;}
+ CntOdd++	;}
+//-------------------------------------------------
+static	void	LogWait(void)
+{
+ while(!LogEmpty()) usleep(20)	;}
+//-------------------------------------------------
+//     main():  -   
+static	void	Run(uint32_t ms)
+{uint32_t	end = Clock.Now() + ms, due	;
+ int		ix	;
+
+ while(Clock.Now() != end){
+   Clock.OnIRQ()	;
+   for(ix=0;ix<Cnt;ix++) Emu[ix].Frame()	;
+   HostCdcFrame()		;
+   EvQueue.Dispatch()	;
+   if(Timers.NextDue(&due)) Clock.Wake(due)	;
+   LogWait()			;}
+}
+//-------------------------------------------------
+//  ,       ;  -  (
+//      ). mix -      ,
+//  -    ,  ;  "20,start,..."  
+// ,     .
+static	void	Bursts(int phase,int mix=0)
+{char	text[PDU_LEN_TEXT + 40]	;
+ int	b, ix	;
+
+ for(b=0;b<MULTI_BURSTS;b++){
+   for(ix=0;ix<Cnt && ReqCnt < MULTI_REQ_MAX;ix++){
+     if(!HostCdcFind(Core + ix)->Active) continue	;
+     TMultiReq*	r = Req + ReqCnt++	;
+     snprintf(r->Nmbr,sizeof(r->Nmbr),"+7923%d%d%d0000",phase,b,ix)	;
+     r->Tick = Clock.Now()	; r->Reply = 0	;
+     if(!mix || !((b & 1) || (((b >> 1) + ix) & 1))){ Emu[ix].Call(r->Nmbr)	; continue	;}
+     memset(text,'a' + ix,sizeof(text) - 1)	; text[sizeof(text) - 1] = 0	;
+     memcpy(text,"20,start,",9)	;
+     Emu[ix].Sms(r->Nmbr,text)	;}
+   Run(Gap)	;}
+}
+//-------------------------------------------------
+static	int		Replied(void)
+{int	n = 0	;
+
+ for(int ix=0;ix<ReqCnt;ix++) if(Req[ix].Reply) n++	;
+ return n	;}
+//-------------------------------------------------
+static	void	Report(const char* name)
+{
+ printf("%-9s replies %d/%d, sent",name,Replied(),ReqCnt)	;
+ for(int ix=0;ix<Cnt;ix++) printf(" %u",Sent[ix])	;
+ printf(", rejected %u, queue fail %u drop %u\n",Emu[Cnt-1].CntRej,Sched.Queue.CntFail,Sched.Queue.CntDrop)	;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{static const EVENT_TYPE	Ev[] = {evGsmRx,evGsmTimeOut,evEventSMS,evUsbStat}	;
+ uint32_t	was[MULTI_MDM_MAX]	;
+ int		ix, lo, hi	;
+
+ if(argc > 1) Cnt = atoi(argv[1])	;
+ if(Cnt < 2 || Cnt > MULTI_MDM_MAX){ printf("2..%d modems\n",MULTI_MDM_MAX)	; return 2	;}
+ Gap = (Cnt+1)*SMSQ_TB_PERIOD	;
+ EvQueue.Subscribe(evTick,OnTick)	;
+ for(ix=0;ix<(int)SIZE_ARRAY(Ev);ix++) EvQueue.Subscribe(Ev[ix],OnGsm)	;
+ Clock.Init()	; Timers.Reset(Clock.Now())	;
+ LogInit()		;
+ for(ix=0;ix<LOG_MOD_CNT;ix++) LogLevel[ix] = LOG_LVL_WRN	;
+ for(ix=0;ix<Cnt;ix++){
+   Gsm[ix].Init(&Sched,Core + ix)	;
+   Gsm[ix].FnGetInfSMS = InfoForSMS	; Gsm[ix].FnGetPswGSM = GetPsw	;
+   CHECK_INT(Gsm[ix].GetId(),ix)	;
+   Emu[ix].Boot = 1000 + 300*ix		; Emu[ix].OnSent = OnSent	; Emu[ix].Ctx = (void*)(intptr_t)ix	;
+   Emu[ix].Attach(HostCdcFind(Core + ix))	;}
+ Run(10000)	;
+ for(ix=0;ix<Cnt;ix++) CHECK(Sched.IsUp(ix))	;
+
+ //  :        
+ Bursts(1)	; Report("healthy")	;
+ for(ix=0;ix<Cnt;ix++) CHECK_INT(Sent[ix],MULTI_BURSTS)	;
+
+ // :             
+ for(ix=0;ix<Cnt;ix++){ was[ix] = Sent[ix]	; CHECK_INT(Emu[ix].CntIn,0)	;}
+ Bursts(5,1)	; Run(2*Gap)	; Report("mixed")	;
+ for(ix=0;ix<Cnt;ix++){
+   CHECK_INT(Sent[ix] - was[ix],MULTI_BURSTS)	;
+   CHECK_INT(Emu[ix].CntIn,2*(MULTI_BURSTS/2 + MULTI_BURSTS/4))	;//  2 
+   CHECK_INT(Emu[ix].CntInDrop,0)	;}
+
+ //  :   - ,    
+ Emu[Cnt-1].NoNet = 1	;
+ for(ix=0;ix<Cnt;ix++) was[ix] = Sent[ix]	;
+ Bursts(2)	; Run(4*Gap)	; Report("no net")	;
+ CHECK(Emu[Cnt-1].CntRej >= SCHED_FAIL_MAX)	;
+ CHECK_INT(Sent[Cnt-1],was[Cnt-1])			;
+ for(lo=hi=Sent[0]-was[0],ix=1;ix<Cnt-1;ix++){
+   if((int)(Sent[ix]-was[ix]) < lo) lo = Sent[ix]-was[ix]	;
+   if((int)(Sent[ix]-was[ix]) > hi) hi = Sent[ix]-was[ix]	;}
+ CHECK(hi - lo <= 1)	;//   
+ Emu[Cnt-1].NoNet = 0	;
+ Run(2*Gap)	;
+
+ //     USB  
+ Emu[0].Lost()		;
+ for(ix=0;ix<Cnt;ix++) was[ix] = Sent[ix]	;
+ Bursts(3)			;
+ CHECK_INT(Sent[0],was[0])	;
+ CHECK(!Sched.IsUp(0))		;
+ Emu[0].Attach(HostCdcFind(Core))	;
+ Run(2*Gap)	;
+ CHECK(Sched.IsUp(0))	;
+ was[0] = Sent[0]	;
+ Bursts(4)	; Report("lost")	;
+ CHECK(Sent[0] > was[0])	;
+
+ for(ix=0;ix<ReqCnt;ix++)
+   if(Req[ix].Reply != 1){ printf("%s: %d replies\n",Req[ix].Nmbr,Req[ix].Reply)	; CHECK(0)	;}
+ printf("%d modems, %d requests: round trip avg %u max %u ms\n",Cnt,ReqCnt,Replied() ? LatSum/Replied() : 0,LatMax)	;
+ for(ix=0;ix<Cnt;ix++){
+   const TSchedMdm*	m = Sched.GetMdm(ix)	;
+   printf("  mdm%d: sent %u fail %u, modem cmd %u err %u\n",ix,m->CntSent,m->CntFail,Emu[ix].CntCmd,Emu[ix].CntErr)	;
+   CHECK_INT(Emu[ix].CntErr,0)	;}
+ CHECK_INT(CntOdd,0)	;
+ CHECK_INT(Sched.Queue.CntFail,0)	;
+ CHECK_INT(Sched.Queue.CntDrop,0)	;
+ LogWait()	;
+ return CheckDone("mdm_multi")	;}
+//-------------------------------------------------
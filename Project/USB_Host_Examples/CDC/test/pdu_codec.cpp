@@ -0,0 +1,225 @@
+//-------------------------------------------------
+// TPdu/TPduAssm:   SMS-DELIVER (7 ,  ,
+// UCS2, 8 ,   8-  16- ,  ),
+//  SMS-SUBMIT   PDU ("hellohello", "How are you?"),
+//   Encode -> DELIVER -> Decode -> TPduAssm   ,
+//   Fit()   .  -  CP1251.
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	"Pdu.h"
+#include	"Check.h"
+//-------------------------------------------------
+struct	TDeliverVec{
+ const char*		Hex							;
+ const char*		Nmbr						;
+ const char*		Text						;
+ uint8_t			Alph						;
+ uint16_t			Ref							;
+ uint8_t			Cnt,Seq						;
+};
+//-------------------------------------------------
+static	const TDeliverVec	Deliver[] = {
+// 3GPP-  SMSC,  
+  {"07917283010010F5040BC87238880900F10000993092516195800AE8329BFD4697D9EC37"
+	,"27838890001"		,"hellohello"			,pduGSM7	,0		,0,0}
+ ,{"00040DD0CDF2396C7CBB0100006210715100002110C2303BEC1E9775A0180C0692D7C5"
+	,"MegaFon"			,"Balance: 100 rub"		,pduGSM7	,0		,0,0}
+ ,{"00040B919721436587F90008621071510000211C041F04400438043204350442002C0020043C04380440002100200401"
+	,"+79123456789"		,", ! "		,pduUCS2	,0		,0,0}
+//  2/3, UDH 6  - 1  , ESC-
+ ,{"00440B919761214365F700006210715100002125050003420302363CFCC607DAA0F29B1468D3D36F7AA0CD0BB401823614D0A65C03"
+	,"+79161234567"		,"[x] {y} ~z~ \\ | ^ \x88" "5"	,pduGSM7	,0x42	,3,2}
+ ,{"00440B919761214365F700086210715100002111060804123402010427043004410442044C"
+	,"+79161234567"		,""				,pduUCS2	,0x1234	,2,1}
+ ,{"00040B919761214365F700046210715100002103414243"
+	,"+79161234567"		,"ABC"					,pdu8BIT	,0		,0,0}
+};
+//-------------------------------------------------
+struct	TSubmitVec{
+ const char*		Nmbr						;
+ const char*		Text						;
+ uint16_t			Ref							;
+ uint8_t			Cnt,Seq						;
+ const char*		Hex							;
+};
+//-------------------------------------------------
+static	const TSubmitVec	Submit[] = {
+  {"+27838890001"	,"hellohello"		,0		,0,0	,"0001000B917238880900F100000AE8329BFD4697D9EC37"}
+ ,{"\"+27838890001\"","How are you?"	,0		,0,0	,"0001000B917238880900F100000CC8F71D14969741F977FD07"}
+ ,{"+79231234567"	,""			,0		,0,0	,"0001000B919732214365F700080C041F04400438043204350442"}
+ ,{"+79231234567"	,"Hello part one"	,0xCC	,2,1	,"0041000B919732214365F7000015050003CC0201906536FB0D8287E574D0DB5D06"}
+ ,{"01234"			,"OK"				,0		,0,0	,"00010005811032F4000002CF25"}
+};
+#define		SIZE_ARR(A)			(int)(sizeof(A)/sizeof(A[0]))
+//-------------------------------------------------
+static	void	TestDeliver(void)
+{char		hex[PDU_LEN_HEX]	;
+ TPduSMS	sms					;
+ int		ix					;
+
+ for(ix=0;ix<SIZE_ARR(Deliver);ix++){
+   const TDeliverVec*	v = Deliver + ix	;
+   strcpy(hex,v->Hex)						;
+   CHECK(TPdu::Decode(hex,&sms))			;
+   if(strcmp(sms.Nmbr,v->Nmbr) || strcmp(sms.Text,v->Text)){
+     printf("deliver %d: \"%s\" \"%s\"\n",ix,sms.Nmbr,sms.Text)	; CHECK(0)	;}
+   CHECK_INT(sms.Len,strlen(v->Text))		;
+   CHECK_INT(sms.Alph,v->Alph)				;
+   CHECK_INT(sms.Ref,v->Ref)				;
+   CHECK_INT(sms.Cnt,v->Cnt)				; CHECK_INT(sms.Seq,v->Seq)	;}
+}
+//-------------------------------------------------
+static	void	TestSubmit(void)
+{char		hex[PDU_LEN_HEX]	;
+ int		ix, len				;
+
+ for(ix=0;ix<SIZE_ARR(Submit);ix++){
+   const TSubmitVec*	v = Submit + ix	;
+   len = TPdu::Encode(hex,sizeof(hex),v->Nmbr,v->Text,(int)strlen(v->Text),v->Ref,v->Cnt,v->Seq)	;
+   CHECK_INT(len,strlen(v->Hex)/2 - 1)		;// AT+CMGS=<  SCA>
+   if(strcmp(hex,v->Hex)){ printf("submit %d: %s\n        expected %s\n",ix,hex,v->Hex)	; CHECK(0)	;}}
+
+ CHECK_INT(TPdu::Encode(hex,sizeof(hex),"+7","x",1),9)			;// FO MR DA(3) PID DCS UDL UD
+ CHECK_INT(TPdu::Encode(hex,sizeof(hex),"\"\"","x",1),0)		;//  
+ CHECK_INT(TPdu::Encode(hex,10,"+79231234567","x",1),0)			;// hex  
+ memset(hex,'a',161)	;
+ CHECK_INT(TPdu::Encode(hex,sizeof(hex),"+7",hex,161),0)		;//  160 
+ CHECK_INT(TPdu::Septets("[]",2),4)								;
+ CHECK_INT(TPdu::Septets("",3),-1)							;}
+//-------------------------------------------------
+static	void	TestErrors(void)
+{static const char*	Bad[] = {
+   ""
+  ,"ZZ"
+  ,"0791"													//   SMSC
+  ,"00040B919761214365"										//   
+  ,"0001000B919732214365F700000AE8329BFD4697D9EC37"			// SMS-SUBMIT
+  ,"00440B919761214365F70000621071510000210A0A0003420302"	// UDH  UD
+ };
+ char		hex[PDU_LEN_HEX]	;
+ TPduSMS	sms					;
+ int		ix					;
+
+ for(ix=0;ix<SIZE_ARR(Bad);ix++){
+   strcpy(hex,Bad[ix])	;
+   if(TPdu::Decode(hex,&sms)){ printf("bad %d decoded\n",ix)	; CHECK(0)	;}}
+}
+//-------------------------------------------------
+// SMS-SUBMIT (    ) -> SMS-DELIVER (   )
+static	int		ToDeliver(const char* submit,char* deliver)
+{uint8_t	in[PDU_LEN_HEX/2], out[PDU_LEN_HEX/2]	;
+ unsigned	val		;
+ int		cnt = (int)strlen(submit)/2, ix, k = 0, da	;
+
+ for(ix=0;ix<cnt;ix++){ sscanf(submit + 2*ix,"%2x",&val)	; in[ix] = (uint8_t)val	;}
+ da = 2 + (in[3] + 1)/2	;// , , 
+ out[k++] = 0x00						;// SMSC
+ out[k++] = (uint8_t)((in[1] & 0x40) | 0x04)	;// SMS-DELIVER, UDHI  
+ memcpy(out + k,in + 3,da)	; k += da	;// OA = DA
+ out[k++] = in[3 + da]	; out[k++] = in[4 + da]	;// PID, DCS
+ memcpy(out + k,"\x62\x10\x71\x51\x00\x00\x21",7)	; k += 7	;// SCTS
+ memcpy(out + k,in + 5 + da,cnt - 5 - da)	; k += cnt - 5 - da	;// UDL, UD
+ for(ix=0;ix<k;ix++) sprintf(deliver + 2*ix,"%02X",out[ix])	;
+ return k	;}
+//-------------------------------------------------
+static	char	RandChar(uint32_t* seed,int cyr)
+{static const char	Ext[] = "\n\r@$_{}[]~|\\^\x88\xA4\xA7"	;
+ uint32_t	r	;
+
+ *seed = *seed*1103515245 + 12345	; r = (*seed >> 16) & 0x7FFF	;
+ if(cyr && r % 8 == 0) return (char)(0xC0 + r/8 % 64)			;// ..
+ if(r % 16 == 1) return Ext[r/16 % (sizeof(Ext)-1)]				;
+ return (char)(' ' + r/16 % 95)	;}
+//-------------------------------------------------
+//    Fit()   GetPartSMS(),  , 
+//  DELIVER,    TPduAssm   .
+// 1 -  , 0 - , -1 -    PDU_PART_MAX 
+static	int		RoundTrip(const char* text,int len,uint8_t ref,uint32_t time)
+{static TPduAssm	Assm	;
+ char		sub[PDU_LEN_HEX], del[PDU_LEN_HEX]	;
+ TPduSMS	sms[PDU_PART_MAX]	;
+ int		part[PDU_PART_MAX+1], cnt, ix, n, pos, got = -1	;
+ char*		res = 0	;
+
+ if(TPdu::Fit(text,len,0) >= len){ part[0] = 0	; part[1] = len	; cnt = 1	;}
+ else for(cnt=0,pos=0;pos < len;cnt++){
+   if(cnt >= PDU_PART_MAX) return -1	;//  PDU_PART_MAX  -   
+   part[cnt] = pos	; pos += TPdu::Fit(text + pos,len - pos,1)	;
+   part[cnt+1] = pos	;}
+
+ for(ix=0;ix<cnt;ix++){
+   n = TPdu::Encode(sub,sizeof(sub),"+79161234567",text + part[ix],part[ix+1] - part[ix],
+					ref,cnt > 1 ? cnt:0,cnt > 1 ? ix+1:0)	;
+   if(!n){ printf("encode failed: part %d/%d, %d chars\n",ix+1,cnt,part[ix+1] - part[ix])	; return 0	;}
+   ToDeliver(sub,del)	;
+   if(!TPdu::Decode(del,sms + ix)){ printf("decode failed: %s\n",del)	; return 0	;}}
+
+ for(ix=cnt-1;ix>=0;ix--){								 //   - 
+   res = Assm.Add(sms + ix,time,&n)	;
+   if(ix && res) return 0	;}
+ if(res) got = n		;
+ if(got != len || memcmp(res,text,len) || strcmp(sms[0].Nmbr,"+79161234567")){
+   printf("round trip %d chars in %d parts: got %d\n",len,cnt,got)	; return 0	;}
+ return 1	;}
+//-------------------------------------------------
+static	void	TestRoundTrip(void)
+{char		text[PDU_PART_MAX*PDU_LEN_TEXT]	;
+ uint32_t	seed = 7	;
+ int		ix, n, len, cyr, ok = 0, cnt = 0, skip = 0	;
+
+ for(ix=1;ix<4000;ix++){
+   cyr = ix & 1	; len = ix % (cyr ? 260 : 450)	;// UCS2 -  4*67, 7  -  4*153 ( `, ESC - )
+   if(!len) continue	;
+   for(n=0;n<len;n++) text[n] = RandChar(&seed,cyr)	;
+   if((n = RoundTrip(text,len,(uint8_t)ix,ix)) < 0){ skip++	; continue	;}
+   cnt++	; ok += n	;}
+ printf("round trip: %d/%d texts (%d longer than %d parts)\n",ok,cnt,skip,PDU_PART_MAX)	;
+ CHECK_INT(ok,cnt)	;
+ CHECK(cnt > 3000)	;}
+//-------------------------------------------------
+// : ,  ,   ,  > PDU_PART_MAX
+static	void	TestAssm(void)
+{TPduAssm	a	;
+ TPduSMS	s	;
+ char*		res	;
+ int		len, ix	;
+
+ memset(&s,0,sizeof(s))	; strcpy(s.Nmbr,"+79161234567")	;
+ s.Len = 1	; s.Text[1] = 0	;
+ s.Cnt = 0	; s.Text[0] = 'x'	;
+ res = a.Add(&s,1,&len)		; CHECK(res && len == 1 && *res == 'x')	;//  -  
+
+ s.Ref = 1	; s.Cnt = 3	;
+ s.Seq = 2	; s.Text[0] = 'B'	; CHECK(a.Add(&s,2) == 0)	;
+ s.Seq = 2	;					  CHECK(a.Add(&s,3) == 0)	;// 
+ s.Seq = 3	; s.Text[0] = 'C'	; CHECK(a.Add(&s,4) == 0)	;
+ s.Seq = 1	; s.Text[0] = 'A'	;
+ res = a.Add(&s,5,&len)		; CHECK(res && len == 3 && !strcmp(res,"ABC"))	;
+ CHECK_INT(a.GetDrop(),0)	;
+
+ for(ix=0;ix<PDU_SLOT_CNT+1;ix++){ s.Ref = (uint16_t)(10 + ix)	; s.Seq = 1	; CHECK(a.Add(&s,10 + ix) == 0)	;}
+ CHECK_INT(a.GetDrop(),1)	;// ref 10 
+ s.Ref = 10	; s.Seq = 2	; CHECK(a.Add(&s,20) == 0)	;//  
+ CHECK_INT(a.GetDrop(),2)	;//  ref 11
+ s.Ref = 12	; s.Cnt = 3	;
+ s.Seq = 2	; CHECK(a.Add(&s,21) == 0)	;
+ s.Seq = 3	; CHECK(a.Add(&s,22) != 0)	;
+
+ a.Reset()	; s.Ref = 99	; s.Cnt = PDU_PART_MAX + 1	;
+ s.Seq = PDU_PART_MAX + 1	; CHECK(a.Add(&s,30) == 0)	;
+ CHECK_INT(a.GetDrop(),1)	;//   
+ for(ix=1;ix<=PDU_PART_MAX;ix++){ s.Seq = (uint8_t)ix	; res = a.Add(&s,30 + ix,&len)	;}
+ CHECK(res != 0)			; CHECK_INT(len,PDU_PART_MAX)	;
+ CHECK_INT(a.GetDrop(),2)	;}// 
+//-------------------------------------------------
+int		main(void)
+{
+ TestDeliver()		;
+ TestSubmit()		;
+ TestErrors()		;
+ TestAssm()			;
+ TestRoundTrip()	;
+ return CheckDone("pdu_codec")	;}
+//-------------------------------------------------
@@ -0,0 +1,128 @@
+//-------------------------------------------------
+// TblAns/FindAns:        (
+//   ),      , 
+//  - .  -    (data/e1550.txt: , ,
+// URC Huawei, PDU)  FindAns     strncasecmp.
+//	tblans [] []
+//-------------------------------------------------
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<ctype.h>
+#include	"Check.h"
+//    -   TUsartGSM, TAnsGSM    .cpp
+#define		class		struct
+#define		private		public
+#include	"usart_GSM.h"
+#undef		private
+#undef		class
+#include	"usart_GSM.cpp"
+//-------------------------------------------------
+#define		ANS_LINE_MAX		512
+#define		ANS_LINE_LEN		400
+//-------------------------------------------------
+static	char		Line[ANS_LINE_MAX][ANS_LINE_LEN]	;
+static	int			LineCnt								;
+//-------------------------------------------------
+static	TUsartGSM		Gsm								;
+//-------------------------------------------------
+static	const TAnsGSM*	Find(const char* str){ return Gsm.FindAns(str)	;}
+//-------------------------------------------------
+//   Parse()  :    
+static	const TAnsGSM*	FindLinear(const char* str)
+{int	ix	;
+
+ for(ix=0;ix<TUsartGSM::CntAns;ix++)
+   if(!strncasecmp(str,TUsartGSM::TblAns[ix].Str,TUsartGSM::TblAns[ix].Len)) return TUsartGSM::TblAns + ix	;
+ return 0	;}
+//-------------------------------------------------
+static	void	TestTable(void)
+{const TAnsGSM*	a	;
+ char			str[64]	;
+ int			ix, jx	;
+
+ for(ix=0;ix<TUsartGSM::CntAns;ix++){
+   a = TUsartGSM::TblAns + ix	;
+   CHECK_INT(a->Len,strlen(a->Str))	;
+   if(ix) CHECK(strcasecmp(a[-1].Str,a->Str) < 0)	;//  
+   for(jx=0;jx<TUsartGSM::CntAns;jx++)
+     if(jx != ix && !strncasecmp(TUsartGSM::TblAns[jx].Str,a->Str,a->Len)){
+       printf("\"%s\" is a prefix of \"%s\"\n",a->Str,TUsartGSM::TblAns[jx].Str)	; CHECK(0)	;}
+   CHECK(!a->Urc || a->Msg == msgEmpty)	;// URC   
+   snprintf(str,sizeof(str),"%s 1,2,\"x\"",a->Str)	;
+   CHECK(Find(str) == a)	;
+   for(jx=0;str[jx];jx++) str[jx] = (char)tolower((uint8_t)str[jx])	;
+   CHECK(Find(str) == a)	;
+   CHECK(Find(a->Str) == a)	;//  
+   if(a->Len > 1){ memcpy(str,a->Str,a->Len-1)	; str[a->Len-1] = 0	; CHECK(Find(str) == 0)	;}
+ }
+}
+//-------------------------------------------------
+static	void	TestCases(void)
+{static const struct{ const char* Str	; const char* Ans	;} Case[] = {
+   {"OK"								,strOK			}
+  ,{"ok"								,strOK			}
+  ,{"ERROR"								,strERROR		}
+  ,{"+CME ERROR: 10"					,strCME_ERROR	}
+  ,{"+CMS ERROR: 304"					,strCMS_ERROR	}
+  ,{"+CMTI: \"SM\",3"					,strAnsCMTI		}
+  ,{"+CMT: ,25"							,strAnsCMT		}
+  ,{"+CMGS: 17"							,strAnsCMGS		}
+  ,{"+CPMS: \"SM\",2,15,\"SM\",2,15"	,strAnsCPMS		}
+  ,{"+CPMS: 2,15,2,15,2,15"				,0				}//   AT+CPMS=,   
+  ,{"+CLIP: \"+79231234567\",145"		,strAnsCLIP		}
+  ,{"RING"								,strRING		}
+  ,{"NO CARRIER"						,strNO_CRR		}
+  ,{"NO DIALTONE"						,0				}
+  ,{"^RSSI:21"							,0				}
+  ,{"+CREG: 1"							,0				}
+  ,{"+CM"								,0				}
+  ,{"07919761989901F0"					,0				}
+  ,{""									,0				}
+ };
+ const TAnsGSM*	a	;
+ int			ix	;
+
+ for(ix=0;ix<(int)(sizeof(Case)/sizeof(Case[0]));ix++){
+   a = Find(Case[ix].Str)	;
+   if((a ? a->Str : 0) != Case[ix].Ans){
+     printf("\"%s\": %s, expected %s\n",Case[ix].Str,a ? a->Str : "none",Case[ix].Ans ? Case[ix].Ans : "none")	; CHECK(0)	;}
+   CHECK(a == FindLinear(Case[ix].Str))	;}
+}
+//-------------------------------------------------
+static	int		Load(const char* name)
+{FILE*	f = fopen(name,"r")	;
+ char*	p	;
+
+ if(!f){ printf("%s: can't open\n",name)	; return 0	;}
+ for(LineCnt=0;LineCnt < ANS_LINE_MAX && fgets(Line[LineCnt],ANS_LINE_LEN,f);){
+   for(p=Line[LineCnt]+strlen(Line[LineCnt]);p > Line[LineCnt] && (p[-1] == '\n' || p[-1] == '\r');) *--p = 0	;
+   if(*Line[LineCnt]) LineCnt++	;}
+ fclose(f)	;
+ return LineCnt	;}
+//-------------------------------------------------
+static	void	Bench(int rep)
+{const TAnsGSM*	a	;
+ double			tBin, tLin	;
+ int			ix, jx, hit = 0, hitLin = 0	;
+
+ for(ix=0;ix<LineCnt;ix++) CHECK(Find(Line[ix]) == FindLinear(Line[ix]))	;
+ tBin = HostSec()	;
+ for(jx=0;jx<rep;jx++) for(ix=0;ix<LineCnt;ix++) if((a = Find(Line[ix])) != 0) hit++	;
+ tBin = HostSec() - tBin	;
+ tLin = HostSec()	;
+ for(jx=0;jx<rep;jx++) for(ix=0;ix<LineCnt;ix++) if((a = FindLinear(Line[ix])) != 0) hitLin++	;
+ tLin = HostSec() - tLin	;
+ printf("%d lines (%d known) x %d: FindAns %.1f ns/line, linear %.1f ns/line, x%.1f\n",
+		LineCnt,hit/rep,rep,tBin*1e9/rep/LineCnt,tLin*1e9/rep/LineCnt,tLin/tBin)	;
+ CHECK_INT(hit,hitLin)	;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{
+ TestTable()	;
+ TestCases()	;
+ if(Load(argc > 1 ? argv[1] : "data/e1550.txt")) Bench(argc > 2 ? atoi(argv[2]) : 20000)	;
+ else CHECK(0)	;
+ return CheckDone("tblans")	;}
+//-------------------------------------------------
@@ -0,0 +1,144 @@
+//-------------------------------------------------
+// TTimerWheel: 10k   (  ),
+//     evTick  main.    ,
+//  -   ,  -  ; 
+// EvQueue     (CntLate),   .  
+//  . : Start/Stop  Run    10k 
+//    10k   .
+//	timer_wheel []
+//-------------------------------------------------
+#include	<stdlib.h>
+#include	"TimerWheel.h"
+#include	"EventQueue.h"
+#include	"Check.h"
+//-------------------------------------------------
+#define		TW_CNT_MAX			20000
+#define		TW_SPAN				5000	//   , 
+//-------------------------------------------------
+TEventQueue			EvQueue						;
+TTimerWheel			Timers						;
+//-------------------------------------------------
+static	int			Cnt = 10000					;
+static	TTimer		Tmr[TW_CNT_MAX]				;
+static	uint32_t	Want[TW_CNT_MAX]			;//  , 0 -  
+static	uint32_t	Fired[TW_CNT_MAX]			;
+static	uint32_t	Now, Early, Extra, LateMax	;
+//-------------------------------------------------
+static	void	OnFire(TEvent* ev)
+{int		ix = (unsigned short)ev->Value	;
+
+ if(ix >= Cnt || !Want[ix]){ Extra++	; return	;}
+ if((int32_t)(Now - Want[ix]) < 0) Early++	;
+ else if(Now - Want[ix] > LateMax) LateMax = Now - Want[ix]	;
+ Fired[ix]++	;
+ if(Tmr[ix].Period) Want[ix] += Tmr[ix].Period	;
+ else{ Want[ix] = 0	; CHECK(!Tmr[ix].Active())	;}}
+//-------------------------------------------------
+static	void	Tick(uint32_t now)
+{
+ Now = now	; Timers.Run(now)	;
+ while(EvQueue.Dispatch())	;}
+//-------------------------------------------------
+static	void	Arm(uint32_t now,uint32_t span)
+{int		ix	;
+
+ EvQueue.Reset()	; Timers.Reset(now)	; Now = now	;
+ Early = Extra = LateMax = 0	;
+ for(ix=0;ix<Cnt;ix++){
+   Tmr[ix] = TTimer(evStat1,(short)ix)	; Fired[ix] = 0	;
+   Want[ix] = now + 1 + rand() % span	;
+   Timers.Start(Tmr + ix,Want[ix],ix % 10 ? 0 : 50 + rand() % 450)	;}
+ CHECK_INT(Timers.GetCnt(),Cnt)	;}
+//-------------------------------------------------
+static	void	TestTicks(void)
+{uint32_t	t0 = 1000, end = t0 + TW_SPAN + 1000, t, due	;
+ int		ix, per = 0	;
+
+ Arm(t0,TW_SPAN)	;
+ for(t=t0+1;t<=end;t++){
+   if(Timers.NextDue(&due)) CHECK((int32_t)(due - Now) > 0)	;
+   Tick(t)	;}
+ for(ix=0;ix<Cnt;ix++)
+   if(!Tmr[ix].Period) CHECK_INT(Fired[ix],1)	;
+   else{ per++	; CHECK((int32_t)(Want[ix] - end) > 0)	;}//    end 
+ printf("%d timers (%d periodic), %u ticks: fired %u, late %u (max %u ticks)\n",
+		Cnt,per,end - t0,Timers.CntFire,Timers.CntLate,LateMax)	;
+ CHECK_INT(Early,0)	;
+ CHECK_INT(Extra,0)	;
+ CHECK_INT(Timers.GetCnt(),per)	;}
+//-------------------------------------------------
+// main   :    ,   - 
+static	void	TestJump(void)
+{int		cnt = Cnt, ix	;
+ uint32_t	to	;
+
+ Cnt = 20	; Arm(0,3*TMW_SIZE)	;
+ to = TMW_SIZE + TMW_SIZE/2	;
+ Tick(to)	;
+ for(ix=0;ix<Cnt;ix++) if(!Tmr[ix].Period) CHECK_INT(Fired[ix],Tmr[ix].Due <= to)	;
+ Tick(4*TMW_SIZE)	;
+ for(ix=0;ix<Cnt;ix++) if(!Tmr[ix].Period) CHECK_INT(Fired[ix],1)	;
+ CHECK_INT(Early,0)	;
+ Cnt = cnt	;}
+//-------------------------------------------------
+// EvQueue :     ,  
+static	void	TestLate(void)
+{int		ix	;
+ TTimer		t(evStat2,0)	;
+
+ EvQueue.Reset()	; Timers.Reset(0)	;
+ for(ix=0;ix<EVQ_LEN;ix++) EvQueue.Post(evStat3)	;
+ Timers.Start(&t,3)	;
+ Timers.Run(3)		;
+ CHECK_INT(Timers.CntLate,1)	;
+ CHECK(t.Active())	; CHECK_INT(t.Due,4)	;
+ EvQueue.Reset()	;
+ Timers.Run(4)		;
+ CHECK_INT(Timers.CntFire,1)	;
+ CHECK(!t.Active())	;}
+//-------------------------------------------------
+static	void	Bench(void)
+{static uint32_t	cnt[TW_CNT_MAX]	;
+ uint32_t			t0 = 1000, t, rep = 100, r, sum = 0	;
+ double				sec, secRun, secOld	;
+ int				ix	;
+
+ Arm(t0,100000)	;
+ sec = HostSec()	;
+ for(r=0;r<rep;r++) for(ix=0;ix<Cnt;ix++) Timers.Start(Tmr + ix,Want[ix] = t0 + 1 + (ix*7919u + r) % 100000)	;
+ sec = HostSec() - sec	;
+ printf("Start (re-arm), %d armed: %.1f ns\n",Cnt,sec*1e9/rep/Cnt)	;
+
+ secRun = HostSec()	;
+ for(t=t0+1;t<=t0+10000;t++) Tick(t)	;
+ secRun = HostSec() - secRun	;
+
+ //  :       
+ for(ix=0;ix<Cnt;ix++) cnt[ix] = 1 + (ix*7919u) % 100000	;
+ secOld = HostSec()	;
+ for(t=0;t<10000;t++){
+   for(ix=0;ix<Cnt;ix++) if(cnt[ix] && !--cnt[ix]) sum++	;
+   __asm__ volatile("" ::: "memory")	;}
+ secOld = HostSec() - secOld	;
+ printf("tick, %d armed: wheel %.0f ns, %d countdowns %.0f ns (fired %u/%u)\n",
+		Cnt,secRun*1e9/10000,Cnt,secOld*1e9/10000,Timers.CntFire,sum)	;
+
+ sec = HostSec()	;
+ for(ix=0;ix<Cnt;ix++) Timers.Stop(Tmr + ix)	;
+ sec = HostSec() - sec	;
+ printf("Stop: %.1f ns\n",sec*1e9/Cnt)	;
+ CHECK_INT(Timers.GetCnt(),0)	;
+ CHECK_INT(Early,0)	;}
+//-------------------------------------------------
+int		main(int argc,char** argv)
+{
+ if(argc > 1) Cnt = atoi(argv[1])	;
+ if(Cnt < 1 || Cnt > TW_CNT_MAX){ printf("1..%d timers\n",TW_CNT_MAX)	; return 2	;}
+ srand(1)	;
+ EvQueue.Subscribe(evStat1,OnFire)	;
+ TestTicks()	;
+ TestJump()		;
+ TestLate()		;
+ Bench()		;
+ return CheckDone("timer_wheel")	;}
+//-------------------------------------------------
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# Декодер кадров TRACEn() (tools/trace_dec.py) на синтетике: ELF32 с одной
+# секцией строк формата и поток, как его пишет Trace.c через Log.c.
+# Текст Log.d между кадрами, мусор до первого TRACE_SYNC (подключились
+# посреди кадра), 0..4 аргумента, %s из образа и мимо него, неизвестный
+# формат; поток режется на куски в каждом месте - вывод тот же, недошедший
+# хвост не печатается. В конце - trace_dec.py целиком, файлом.
+#   trace_dec_test.py
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TOOL = os.path.join(HERE, '..', 'tools', 'trace_dec.py')
+sys.dont_write_bytecode = True                          # без __pycache__ в tools/
+sys.path.insert(0, os.path.dirname(TOOL))
+import trace_dec  # noqa: E402
+
+BASE = 0x08001000
+HZ = 1000000                                            # метка 1000 = 1000.0 мкс
+fail = 0
+
+
+def check(cond, what):
+    global fail
+    if not cond:
+        fail += 1
+        print('trace_dec_test: %s' % what)
+
+
+def elf(strings):
+    """ELF32 LE: заголовок, нулевая секция и .rodata по BASE со строками."""
+    body, addr = b'', {}
+    for name, s in strings:
+        addr[name] = BASE + len(body)
+        body += s.encode('cp1251') + b'\0'
+    shoff = 0x34 + len(body)
+    hdr = b'\x7fELF' + bytes([1, 1, 1]) + bytes(9)
+    hdr += struct.pack('<HHIIIIIHHHHHH', 2, 40, 1, 0, 0, shoff, 0, 0x34, 0, 0, 40, 2, 0)
+    sec = bytes(40) + struct.pack('<IIIIIIIIII', 0, 1, 2, BASE, 0x34, len(body), 0, 0, 4, 0)
+    return hdr + body + sec, addr
+
+
+def frame(fmt, tim, *args):
+    return struct.pack('<BBII%dI' % len(args), trace_dec.SYNC, len(args), fmt, tim, *args)
+
+
+def run(elf_img, data, cuts):
+    """Как main(): куски потока, непринятый хвост - к следующему."""
+    out, tail, pos = [], b'', 0
+    for cut in list(cuts) + [len(data)]:
+        tail += data[pos:cut]
+        pos = cut
+        tail = tail[trace_dec.decode(elf_img, tail, HZ, out.append):]
+    return ''.join(out), tail
+
+
+def main():
+    img, at = elf([('boot', 'boot\n'), ('urb', 'urb %d\n'), ('hc', 'hc%u ep%02X\n'),
+                   ('mdm', '%s: %c %x\n'), ('four', '%d/%d/%d/%d\n'), ('pct', '%% %s|\n'),
+                   ('name', 'модем')])
+    with tempfile.TemporaryDirectory() as tmp:
+        axf = os.path.join(tmp, 'Project.axf')
+        with open(axf, 'wb') as f:
+            f.write(img)
+        e = trace_dec.Elf(axf)
+        check(e.cstr(at['name']) == 'модем', 'cstr')
+        check(e.cstr(BASE - 1) is None, 'cstr outside')
+
+        data = b'\xc0\xc1\x00\x07'                      # хвост чужого кадра: 0 с n > ARG_MAX - не кадр
+        data += 'текст Log.d\n'.encode('cp1251')
+        data += frame(at['boot'], 1000)
+        data += frame(at['urb'], 2000, 0xFFFFFFFB)
+        data += b'ok\n'
+        data += frame(at['hc'], 3000, 3, 0x81)
+        data += frame(at['mdm'], 4000, at['name'], ord('A'), 0xBEEF)
+        data += frame(at['four'], 5000, 1, 2, 3, 4)
+        data += frame(at['pct'], 6000, 0x12345678)
+        data += frame(0x20000000, 7000, 9)              # формата нет в образе
+        full = len(data)
+        data += frame(at['boot'], 8000)[:7]             # не дошел
+        want = ('АБ\x07текст Log.d\n'
+                '[    1000.0] boot\n'
+                '[    2000.0] urb -5\n'
+                'ok\n'
+                '[    3000.0] hc3 ep81\n'
+                '[    4000.0] модем: A beef\n'
+                '[    5000.0] 1/2/3/4\n'
+                '[    6000.0] % <0x12345678>|\n'
+                '[    7000.0] <fmt 0x20000000> 0x9\n')
+
+        got, tail = run(e, data, [])
+        check(got == want, 'one piece:\n%r\n%r' % (got, want))
+        check(tail == data[full:], 'tail %r' % tail)
+        bad = [cut for cut in range(1, len(data)) if run(e, data, [cut]) != (want, data[full:])]
+        check(not bad, 'split at %s' % bad[:8])
+        got, tail = run(e, data, range(1, len(data)))  # по байту
+        check(got == want and tail == data[full:], 'byte by byte:\n%r' % got)
+
+        log = os.path.join(tmp, 'log.bin')
+        with open(log, 'wb') as f:
+            f.write(data)
+        env = dict(os.environ, PYTHONIOENCODING='utf-8')
+        res = subprocess.run([sys.executable, TOOL, axf, log, '--hz', str(HZ)], stdout=subprocess.PIPE, env=env, check=True)
+        check(res.stdout.decode() == want, 'cli:\n%r' % res.stdout)
+
+    print('trace_dec: %s' % ('FAIL, %d checks' % fail if fail else 'ok'))
+    return 1 if fail else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
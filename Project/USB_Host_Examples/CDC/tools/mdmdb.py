@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Сборка базы модемов (inc/MdmDb.h) из текста в духе usb_modeswitch.
+#   mdmdb.py modems.txt --c ../src/MdmDbRom.c    - база в прошивку
+#   mdmdb.py modems.txt --bin MODEMS.BIN         - файл для флешки (без перепрошивки)
+# test/Makefile: make mdmdb (и make check) сверяет src/MdmDbRom.c с modems.txt
+import re
+import struct
+import sys
+import zlib
+
+SIGN = 0x3142444D
+VER = 1
+MSG_MAX = 32
+CNT_MAX = 1024
+DELAY_MAX = 15000
+DELAY_DEF = 3000
+
+
+def parse(path):
+    recs, cur = [], {}
+    for num, line in enumerate(open(path, encoding='cp1251'), 1):
+        line = line.split('#', 1)[0].strip()
+        if not line:
+            if cur:
+                recs.append(cur)
+                cur = {}
+            continue
+        m = re.match(r'(\w+)\s*=\s*"?([^"]*)"?$', line)
+        if not m:
+            raise SystemExit('%s:%d: не Ключ=Значение' % (path, num))
+        cur[m.group(1)] = (m.group(2).strip(), num)
+    if cur:
+        recs.append(cur)
+    return [rec(path, r) for r in recs]
+
+
+def rec(path, r):
+    line = min(n for _, n in r.values())
+
+    def num(key, dflt=None):
+        if key not in r:
+            if dflt is None:
+                raise SystemExit('%s:%d: нет %s' % (path, line, key))
+            return dflt
+        return int(r[key][0], 0)
+
+    msg = bytes.fromhex(r['MessageContent'][0]) if 'MessageContent' in r else b''
+    if len(msg) > MSG_MAX:
+        raise SystemExit('%s:%d: MessageContent длиннее %d байт' % (path, line, MSG_MAX))
+    delay = num('SwitchDelay', DELAY_DEF)
+    if delay > DELAY_MAX:
+        raise SystemExit('%s:%d: SwitchDelay больше %d' % (path, line, DELAY_MAX))
+    return (num('DefaultVendor'), num('DefaultProduct'), num('TargetClass'), num('TargetProtocol'),
+            num('TargetInterface', -1), msg, delay)
+
+
+def image(recs):
+    recs = sorted(recs)
+    for a, b in zip(recs, recs[1:]):
+        if a[:2] == b[:2]:
+            raise SystemExit('повтор %04X:%04X' % a[:2])
+    if len(recs) > CNT_MAX:
+        raise SystemExit('записей больше %d' % CNT_MAX)
+    body = b''.join(struct.pack('<HHBBbBHH%ds' % MSG_MAX, vid, pid, cls, proto, intf, len(msg), delay, 0, msg)
+                    for vid, pid, cls, proto, intf, msg, delay in recs)
+    return struct.pack('<IHHI', SIGN, VER, len(recs), zlib.crc32(body) & 0xFFFFFFFF) + body, recs
+
+
+def c_file(img, recs, src):
+    words = struct.unpack('<%dI' % (len(img) // 4), img)
+    out = ['// Сгенерировано tools/mdmdb.py из %s - не править руками!' % src]
+    out += ['//   %04X:%04X' % r[:2] for r in recs]
+    out.append('#include\t"MdmDb.h"')
+    out.append('//===============================================')
+    out.append('const uint32_t\tMdmDbRom[]={')
+    for ix in range(0, len(words), 6):
+        out.append('  ' + ','.join('0x%08X' % w for w in words[ix:ix + 6]) + ',')
+    out.append('};')
+    out.append('const uint32_t\tMdmDbRomSize = sizeof(MdmDbRom)\t;')
+    out.append('//===============================================')
+    return '\r\n'.join(out) + '\r\n'
+
+
+def main(argv):
+    if len(argv) != 4 or argv[2] not in ('--c', '--bin'):
+        raise SystemExit('mdmdb.py modems.txt --c MdmDbRom.c | --bin MODEMS.BIN')
+    img, recs = image(parse(argv[1]))
+    if argv[2] == '--c':
+        open(argv[3], 'wb').write(c_file(img, recs, argv[1].replace('\\', '/').split('/')[-1]).encode('cp1251'))
+    else:
+        open(argv[3], 'wb').write(img)
+    print('%d записей, %d байт' % (len(recs), len(img)))
+
+
+if __name__ == '__main__':
+    main(sys.argv)
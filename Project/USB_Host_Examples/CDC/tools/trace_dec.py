@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# Декодер лога с кадрами TRACEn() (inc/Trace.h).
+# Обычный текст Log.d идет как есть, кадр TRACE_SYNC форматируется по строке
+# из .axf (тот же образ, что прошит!) с меткой времени в мкс.
+#   trace_dec.py Project.axf log.bin [--hz 168000000]
+#   cat /dev/ttyUSB0 | trace_dec.py Project.axf -
+import re
+import struct
+import sys
+
+SYNC = 0x00
+ARG_MAX = 4
+
+
+class Elf:
+    """Только то, что нужно: чтение по адресу из загружаемых секций ELF32 LE."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.img = f.read()
+        if self.img[:4] != b'\x7fELF' or self.img[4] != 1 or self.img[5] != 1:
+            raise SystemExit('%s: не ELF32 little endian' % path)
+        shoff, = struct.unpack_from('<I', self.img, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', self.img, 0x2E)
+        self.sec = []
+        for ix in range(shnum):
+            (_, typ, flags, addr, off, size) = struct.unpack_from('<IIIIII', self.img, shoff + ix * shentsize)
+            if typ == 1 and flags & 2 and addr:        # PROGBITS, ALLOC
+                self.sec.append((addr, off, size))
+
+    def cstr(self, addr):
+        for (base, off, size) in self.sec:
+            if base <= addr < base + size:
+                pos = off + addr - base
+                end = self.img.index(b'\0', pos, off + size)
+                return self.img[pos:end].decode('cp1251', 'replace')
+        return None
+
+
+FMT = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\d+))?(hh|h|ll|l)?([diuxXcsp%])')
+
+
+def format_rec(elf, fmt, args):
+    """printf-формат по сырым 32-битным аргументам; %s - адрес строки в образе."""
+    out = []
+    pos = 0
+    it = iter(args)
+    for m in FMT.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        val = next(it, 0)
+        spec = '%' + flags + (width or '') + ('.' + prec if prec else '')
+        if conv in 'di':
+            out.append((spec + 'd') % struct.unpack('<i', struct.pack('<I', val))[0])
+        elif conv == 's':
+            s = elf.cstr(val)
+            out.append((spec + 's') % (s if s is not None else '<0x%08X>' % val))
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(val & 0xFF))
+        elif conv == 'p':
+            out.append('0x%08X' % val)
+        else:
+            out.append((spec + conv) % val)
+    out.append(fmt[pos:])
+    return ''.join(out)
+
+
+def decode(elf, data, hz, put):
+    """Разбирает, что есть; возвращает, сколько байт съедено. Недошедший кадр
+    остается - его начало вернется со следующим куском потока."""
+    ix = 0
+    text = bytearray()
+    while ix < len(data):
+        b = data[ix]
+        if b != SYNC:
+            text.append(b)
+            ix += 1
+            continue
+        if text:
+            put(text.decode('cp1251', 'replace'))
+            text = bytearray()
+        if ix + 2 > len(data):
+            return ix
+        n = data[ix + 1]
+        end = ix + 10 + 4 * n
+        if n > ARG_MAX:                                 # не кадр - пропустить ноль
+            ix += 1
+            continue
+        if end > len(data):
+            return ix
+        fmt_addr, tim = struct.unpack_from('<II', data, ix + 2)
+        args = struct.unpack_from('<%dI' % n, data, ix + 10)
+        fmt = elf.cstr(fmt_addr)
+        if fmt is None:
+            put('[%10.1f] <fmt 0x%08X>%s\n' % (tim * 1e6 / hz, fmt_addr, ''.join(' 0x%X' % a for a in args)))
+        else:
+            put('[%10.1f] %s' % (tim * 1e6 / hz, format_rec(elf, fmt, args)))
+        ix = end
+    if text:
+        put(text.decode('cp1251', 'replace'))
+    return ix
+
+
+def main(argv):
+    hz = 168000000
+    if '--hz' in argv:
+        k = argv.index('--hz')
+        hz = float(argv[k + 1])
+        del argv[k:k + 2]
+    if len(argv) != 3:
+        raise SystemExit('trace_dec.py Project.axf log.bin|- [--hz N]')
+    elf = Elf(argv[1])
+    src = sys.stdin.buffer if argv[2] == '-' else open(argv[2], 'rb')
+    tail = b''
+    while True:                                         # поток (tty) не кончается - по кускам
+        chunk = src.read1(4096)
+        if not chunk:
+            break
+        tail += chunk
+        tail = tail[decode(elf, tail, hz, sys.stdout.write):]
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main(sys.argv)